@@ -172,6 +172,7 @@ extern "C" {
   XX(WORK, work)                                                              \
   XX(GETADDRINFO, getaddrinfo)                                                \
   XX(GETNAMEINFO, getnameinfo)                                                \
+  XX(STREAM_PIPE, stream_pipe)                                                \
 
 typedef enum {
 #define XX(code, _) UV_ ## code = UV__ ## code,
@@ -224,9 +225,12 @@ typedef struct uv_getaddrinfo_s uv_getaddrinfo_t;
 typedef struct uv_getnameinfo_s uv_getnameinfo_t;
 typedef struct uv_shutdown_s uv_shutdown_t;
 typedef struct uv_write_s uv_write_t;
+typedef struct uv_stream_pipe_s uv_stream_pipe_t;
 typedef struct uv_connect_s uv_connect_t;
 typedef struct uv_udp_send_s uv_udp_send_t;
 typedef struct uv_fs_s uv_fs_t;
+typedef struct uv_fs_buf_pool_s uv_fs_buf_pool_t;
+typedef struct uv_fs_read_range_s uv_fs_read_range_t;
 typedef struct uv_work_s uv_work_t;
 
 /* None of the above. */
@@ -237,7 +241,10 @@ typedef struct uv_passwd_s uv_passwd_t;
 typedef struct uv_utsname_s uv_utsname_t;
 
 typedef enum {
-  UV_LOOP_BLOCK_SIGNAL
+  UV_LOOP_BLOCK_SIGNAL,
+  UV_LOOP_FS_GROUP_COMMIT,
+  UV_LOOP_FS_COALESCE_WRITES,
+  UV_LOOP_FS_POLL_BATCH
 } uv_loop_option;
 
 typedef enum {
@@ -302,7 +309,13 @@ typedef void (*uv_read_cb)(uv_stream_t* stream,
 typedef void (*uv_write_cb)(uv_write_t* req, int status);
 typedef void (*uv_connect_cb)(uv_connect_t* req, int status);
 typedef void (*uv_shutdown_cb)(uv_shutdown_t* req, int status);
+typedef void (*uv_stream_pipe_cb)(uv_stream_pipe_t* req, int status);
+typedef void (*uv_write_queue_cb)(uv_stream_t* stream, int full);
 typedef void (*uv_connection_cb)(uv_stream_t* server, int status);
+typedef void (*uv_connection_batch_cb)(uv_stream_t* server,
+                                       const uv_os_fd_t fds[],
+                                       unsigned int nfds,
+                                       int status);
 typedef void (*uv_close_cb)(uv_handle_t* handle);
 typedef void (*uv_poll_cb)(uv_poll_t* handle, int status, int events);
 typedef void (*uv_timer_cb)(uv_timer_t* handle);
@@ -480,13 +493,23 @@ struct uv_stream_s {
 };
 
 UV_EXTERN size_t uv_stream_get_write_queue_size(const uv_stream_t* stream);
+UV_EXTERN int uv_stream_set_write_queue_limits(uv_stream_t* stream,
+                                               size_t high,
+                                               size_t low,
+                                               uv_write_queue_cb cb);
 
 UV_EXTERN int uv_listen(uv_stream_t* stream, int backlog, uv_connection_cb cb);
+UV_EXTERN int uv_listen_batch(uv_stream_t* stream,
+                              int backlog,
+                              uv_connection_batch_cb cb);
+UV_EXTERN int uv_stream_set_accept_budget(uv_stream_t* stream,
+                                          unsigned int budget);
 UV_EXTERN int uv_accept(uv_stream_t* server, uv_stream_t* client);
 
 UV_EXTERN int uv_read_start(uv_stream_t*,
                             uv_alloc_cb alloc_cb,
                             uv_read_cb read_cb);
+UV_EXTERN int uv_read_start_pooled(uv_stream_t*, uv_read_cb read_cb);
 UV_EXTERN int uv_read_stop(uv_stream_t*);
 
 UV_EXTERN int uv_write(uv_write_t* req,
@@ -500,6 +523,17 @@ UV_EXTERN int uv_write2(uv_write_t* req,
                         unsigned int nbufs,
                         uv_stream_t* send_handle,
                         uv_write_cb cb);
+UV_EXTERN int uv_write_zerocopy(uv_write_t* req,
+                                uv_stream_t* handle,
+                                const uv_buf_t bufs[],
+                                unsigned int nbufs,
+                                uv_write_cb cb);
+UV_EXTERN int uv_stream_sendfile(uv_write_t* req,
+                                 uv_stream_t* handle,
+                                 uv_file file,
+                                 int64_t offset,
+                                 size_t length,
+                                 uv_write_cb cb);
 UV_EXTERN int uv_try_write(uv_stream_t* handle,
                            const uv_buf_t bufs[],
                            unsigned int nbufs);
@@ -514,6 +548,22 @@ struct uv_write_s {
 };
 
 
+UV_EXTERN int uv_stream_pipe_to(uv_stream_pipe_t* req,
+                                uv_stream_t* src,
+                                uv_stream_t* dst,
+                                uv_stream_pipe_cb cb);
+
+/* uv_stream_pipe_t is a subclass of uv_req_t. */
+struct uv_stream_pipe_s {
+  UV_REQ_FIELDS
+  uv_stream_t* src;
+  uv_stream_t* dst;
+  uint64_t nbytes;
+  uv_stream_pipe_cb cb;
+  UV_STREAM_PIPE_PRIVATE_FIELDS
+};
+
+
 UV_EXTERN int uv_is_readable(const uv_stream_t* handle);
 UV_EXTERN int uv_is_writable(const uv_stream_t* handle);
 
@@ -541,10 +591,18 @@ UV_EXTERN int uv_tcp_keepalive(uv_tcp_t* handle,
                                int enable,
                                unsigned int delay);
 UV_EXTERN int uv_tcp_simultaneous_accepts(uv_tcp_t* handle, int enable);
+UV_EXTERN int uv_tcp_batch_writes(uv_tcp_t* handle, int enable);
+UV_EXTERN int uv_tcp_fastopen(uv_tcp_t* handle, int queue_len);
 
 enum uv_tcp_flags {
   /* Used with uv_tcp_bind, when an IPv6 address is used. */
-  UV_TCP_IPV6ONLY = 1
+  UV_TCP_IPV6ONLY = 1,
+  /*
+   * Used with uv_tcp_bind. Lets several handles, usually one per event loop,
+   * bind to the same address; the kernel distributes incoming connections
+   * among them. Only supported where the kernel load-balances.
+   */
+  UV_TCP_REUSEPORT = 2
 };
 
 UV_EXTERN int uv_tcp_bind(uv_tcp_t* handle,
@@ -556,10 +614,34 @@ UV_EXTERN int uv_tcp_getsockname(const uv_tcp_t* handle,
 UV_EXTERN int uv_tcp_getpeername(const uv_tcp_t* handle,
                                  struct sockaddr* name,
                                  int* namelen);
+
+typedef struct {
+  uint64_t rtt;             /* smoothed round-trip time, in microseconds */
+  uint64_t rtt_var;         /* round-trip time variance, in microseconds */
+  uint64_t cwnd;            /* congestion window, in bytes */
+  uint64_t mss;             /* maximum segment size for sending, in bytes */
+  uint64_t bytes_in_flight; /* sent but not yet acknowledged, in bytes */
+  uint64_t retransmits;     /* segments retransmitted so far */
+  uint64_t bytes_read;      /* bytes read by libuv */
+  uint64_t bytes_written;   /* bytes written by libuv */
+  uint64_t read_calls;      /* read system calls made by libuv */
+  uint64_t write_calls;     /* write system calls made by libuv */
+} uv_tcp_info_t;
+
+UV_EXTERN int uv_tcp_enable_stats(uv_tcp_t* handle);
+UV_EXTERN int uv_tcp_get_info(const uv_tcp_t* handle, uv_tcp_info_t* info);
 UV_EXTERN int uv_tcp_connect(uv_connect_t* req,
                              uv_tcp_t* handle,
                              const struct sockaddr* addr,
                              uv_connect_cb cb);
+UV_EXTERN int uv_tcp_connect_fastopen(uv_connect_t* req,
+                                      uv_tcp_t* handle,
+                                      const struct sockaddr* addr,
+                                      uv_write_t* write_req,
+                                      const uv_buf_t bufs[],
+                                      unsigned int nbufs,
+                                      uv_connect_cb cb,
+                                      uv_write_cb write_cb);
 
 /* uv_connect_t is a subclass of uv_req_t. */
 struct uv_connect_s {
@@ -590,15 +672,65 @@ enum uv_udp_flags {
    * (provided they all set the flag) but only the last one to bind will receive
    * any traffic, in effect "stealing" the port from the previous listener.
    */
-  UV_UDP_REUSEADDR = 4
+  UV_UDP_REUSEADDR = 4,
+  /*
+   * Indicates that the message was received by recvmmsg, so the buffer provided
+   * must not be freed by the recv_cb callback.
+   */
+  UV_UDP_MMSG_CHUNK = 8,
+  /*
+   * Indicates that the kernel coalesced several datagrams of the same size
+   * into the buffer, see uv_udp_set_gro(). The segment size is stored in the
+   * upper 16 bits of the flags. Used in uv_udp_recv_cb.
+   */
+  UV_UDP_GRO = 16,
+  /*
+   * Used with uv_udp_bind. Like UV_TCP_REUSEPORT: every bound handle gets a
+   * kernel-balanced share of the incoming datagrams.
+   */
+  UV_UDP_REUSEPORT = 32,
+  /*
+   * Request kernel receive timestamps. Passed to uv_udp_recv_start_ex().
+   */
+  UV_UDP_RECV_TIMESTAMP = 64,
+  /*
+   * Request the destination address and interface of received datagrams.
+   * Passed to uv_udp_recv_start_ex().
+   */
+  UV_UDP_RECV_PKTINFO = 128,
+  /*
+   * Indicates that recvmmsg should be used, if available. Passed to
+   * uv_udp_init_ex().
+   */
+  UV_UDP_RECVMMSG = 256
 };
 
+typedef struct {
+  /* Address of the sender, NULL when there is none. */
+  const struct sockaddr* addr;
+  /* Address the datagram was sent to, with UV_UDP_RECV_PKTINFO. The port is
+   * not filled in. NULL when not available.
+   */
+  const struct sockaddr* local_addr;
+  /* Index of the receiving interface, 0 when not available. */
+  unsigned int ifindex;
+  /* Kernel receive time in nanoseconds since the epoch, with
+   * UV_UDP_RECV_TIMESTAMP. 0 when not available.
+   */
+  uint64_t timestamp;
+} uv_udp_recv_info_t;
+
 typedef void (*uv_udp_send_cb)(uv_udp_send_t* req, int status);
 typedef void (*uv_udp_recv_cb)(uv_udp_t* handle,
                                ssize_t nread,
                                const uv_buf_t* buf,
                                const struct sockaddr* addr,
                                unsigned flags);
+typedef void (*uv_udp_recv_ex_cb)(uv_udp_t* handle,
+                                  ssize_t nread,
+                                  const uv_buf_t* buf,
+                                  const uv_udp_recv_info_t* info,
+                                  unsigned flags);
 
 /* uv_udp_t is a subclass of uv_handle_t. */
 struct uv_udp_s {
@@ -631,6 +763,10 @@ UV_EXTERN int uv_udp_bind(uv_udp_t* handle,
                           const struct sockaddr* addr,
                           unsigned int flags);
 
+UV_EXTERN int uv_udp_connect(uv_udp_t* handle, const struct sockaddr* addr);
+UV_EXTERN int uv_udp_getpeername(const uv_udp_t* handle,
+                                 struct sockaddr* name,
+                                 int* namelen);
 UV_EXTERN int uv_udp_getsockname(const uv_udp_t* handle,
                                  struct sockaddr* name,
                                  int* namelen);
@@ -644,12 +780,28 @@ UV_EXTERN int uv_udp_set_multicast_interface(uv_udp_t* handle,
                                              const char* interface_addr);
 UV_EXTERN int uv_udp_set_broadcast(uv_udp_t* handle, int on);
 UV_EXTERN int uv_udp_set_ttl(uv_udp_t* handle, int ttl);
+UV_EXTERN int uv_udp_set_gro(uv_udp_t* handle, int on);
 UV_EXTERN int uv_udp_send(uv_udp_send_t* req,
                           uv_udp_t* handle,
                           const uv_buf_t bufs[],
                           unsigned int nbufs,
                           const struct sockaddr* addr,
                           uv_udp_send_cb send_cb);
+UV_EXTERN int uv_udp_send_gso(uv_udp_send_t* req,
+                              uv_udp_t* handle,
+                              const uv_buf_t bufs[],
+                              unsigned int nbufs,
+                              const struct sockaddr* addr,
+                              unsigned int segment_size,
+                              uv_udp_send_cb send_cb);
+UV_EXTERN int uv_udp_send_from(uv_udp_send_t* req,
+                               uv_udp_t* handle,
+                               const uv_buf_t bufs[],
+                               unsigned int nbufs,
+                               const struct sockaddr* addr,
+                               const struct sockaddr* src_addr,
+                               unsigned int ifindex,
+                               uv_udp_send_cb send_cb);
 UV_EXTERN int uv_udp_try_send(uv_udp_t* handle,
                               const uv_buf_t bufs[],
                               unsigned int nbufs,
@@ -657,6 +809,10 @@ UV_EXTERN int uv_udp_try_send(uv_udp_t* handle,
 UV_EXTERN int uv_udp_recv_start(uv_udp_t* handle,
                                 uv_alloc_cb alloc_cb,
                                 uv_udp_recv_cb recv_cb);
+UV_EXTERN int uv_udp_recv_start_ex(uv_udp_t* handle,
+                                   uv_alloc_cb alloc_cb,
+                                   uv_udp_recv_ex_cb recv_cb,
+                                   unsigned int flags);
 UV_EXTERN int uv_udp_recv_stop(uv_udp_t* handle);
 UV_EXTERN size_t uv_udp_get_send_queue_size(const uv_udp_t* handle);
 UV_EXTERN size_t uv_udp_get_send_queue_count(const uv_udp_t* handle);
@@ -1192,7 +1348,12 @@ typedef enum {
   UV_FS_FCHOWN,
   UV_FS_REALPATH,
   UV_FS_COPYFILE,
-  UV_FS_LCHOWN
+  UV_FS_LCHOWN,
+  UV_FS_FADVISE,
+  UV_FS_READAHEAD,
+  UV_FS_FALLOCATE,
+  UV_FS_READ_ALIGNED,
+  UV_FS_READ_MULTI
 } uv_fs_type;
 
 /* uv_fs_t is a subclass of uv_req_t. */
@@ -1313,6 +1474,90 @@ UV_EXTERN int uv_fs_ftruncate(uv_loop_t* loop,
                               uv_file file,
                               int64_t offset,
                               uv_fs_cb cb);
+
+/*
+ * Access pattern hints for uv_fs_fadvise().
+ */
+#define UV_FS_FADV_NORMAL     0
+#define UV_FS_FADV_RANDOM     1
+#define UV_FS_FADV_SEQUENTIAL 2
+#define UV_FS_FADV_WILLNEED   3
+#define UV_FS_FADV_DONTNEED   4
+#define UV_FS_FADV_NOREUSE    5
+
+UV_EXTERN int uv_fs_fadvise(uv_loop_t* loop,
+                            uv_fs_t* req,
+                            uv_file file,
+                            int64_t offset,
+                            int64_t length,
+                            int advice,
+                            uv_fs_cb cb);
+UV_EXTERN int uv_fs_readahead(uv_loop_t* loop,
+                              uv_fs_t* req,
+                              uv_file file,
+                              int64_t offset,
+                              size_t length,
+                              uv_fs_cb cb);
+
+/*
+ * This flag can be used with uv_fs_fallocate() to reserve space without
+ * changing the apparent size of the file.
+ */
+#define UV_FS_FALLOCATE_KEEP_SIZE  0x0001
+
+/*
+ * This flag can be used with uv_fs_fallocate() to deallocate the given range.
+ * Implies UV_FS_FALLOCATE_KEEP_SIZE.
+ */
+#define UV_FS_FALLOCATE_PUNCH_HOLE 0x0002
+
+UV_EXTERN int uv_fs_fallocate(uv_loop_t* loop,
+                              uv_fs_t* req,
+                              uv_file file,
+                              int mode,
+                              int64_t offset,
+                              int64_t length,
+                              uv_fs_cb cb);
+/*
+ * Block-aligned buffers for use with files opened with UV_FS_O_DIRECT.
+ * Not thread-safe, only use a pool from the thread that owns it.
+ */
+struct uv_fs_buf_pool_s {
+  /* read-only */
+  size_t block_size;
+  size_t buf_size;
+  /* private */
+  void* free_list;
+  unsigned int nfree;
+  unsigned int nused;
+};
+
+UV_EXTERN int uv_fs_buf_pool_init(uv_fs_buf_pool_t* pool,
+                                  uv_file file,
+                                  size_t buf_size);
+UV_EXTERN void uv_fs_buf_pool_destroy(uv_fs_buf_pool_t* pool);
+UV_EXTERN int uv_fs_buf_pool_alloc(uv_fs_buf_pool_t* pool, uv_buf_t* buf);
+UV_EXTERN void uv_fs_buf_pool_free(uv_fs_buf_pool_t* pool, uv_buf_t buf);
+UV_EXTERN int uv_fs_read_aligned(uv_loop_t* loop,
+                                 uv_fs_t* req,
+                                 uv_fs_buf_pool_t* pool,
+                                 uv_file file,
+                                 int64_t offset,
+                                 size_t length,
+                                 uv_fs_cb cb);
+
+struct uv_fs_read_range_s {
+  int64_t offset;
+  uv_buf_t buf;
+  ssize_t result;
+};
+
+UV_EXTERN int uv_fs_read_multi(uv_loop_t* loop,
+                               uv_fs_t* req,
+                               uv_file file,
+                               uv_fs_read_range_t ranges[],
+                               unsigned int nranges,
+                               uv_fs_cb cb);
 UV_EXTERN int uv_fs_sendfile(uv_loop_t* loop,
                              uv_fs_t* req,
                              uv_file out_fd,
@@ -1483,7 +1728,15 @@ enum uv_fs_event_flags {
    * (is ignoring) changes in it's subdirectories.
    * This flag will override this behaviour on platforms that support it.
    */
-  UV_FS_EVENT_RECURSIVE = 4
+  UV_FS_EVENT_RECURSIVE = 4,
+
+  /*
+   * Watch the whole file system that the path is on with a single kernel
+   * object and report the changes below the path, like UV_FS_EVENT_RECURSIVE.
+   * On Linux this uses fanotify when the process has the privileges for it
+   * and falls back to UV_FS_EVENT_RECURSIVE otherwise.
+   */
+  UV_FS_EVENT_MOUNT = 8
 };
 
 
@@ -1493,6 +1746,8 @@ UV_EXTERN int uv_fs_event_start(uv_fs_event_t* handle,
                                 const char* path,
                                 unsigned int flags);
 UV_EXTERN int uv_fs_event_stop(uv_fs_event_t* handle);
+UV_EXTERN int uv_fs_event_set_coalesce(uv_fs_event_t* handle,
+                                       unsigned int window);
 UV_EXTERN int uv_fs_event_getpath(uv_fs_event_t* handle,
                                   char* buffer,
                                   size_t* size);
@@ -1626,9 +1881,11 @@ struct uv_loop_s {
   unsigned int active_handles;
   void* handle_queue[2];
   union {
-    void* unused[2];
+    void* unused;
     unsigned int count;
   } active_reqs;
+  /* Internal storage for future extensions. */
+  void* internal_fields;
   /* Internal flag to signal loop stop. */
   unsigned int stop_flag;
   UV_LOOP_PRIVATE_FIELDS
@@ -265,6 +265,10 @@ typedef struct {
 
 #define UV_SHUTDOWN_PRIVATE_FIELDS /* empty */
 
+#define UV_STREAM_PIPE_PRIVATE_FIELDS                                         \
+  int fds[2];                                                                 \
+  size_t buffered;                                                            \
+
 #define UV_UDP_SEND_PRIVATE_FIELDS                                            \
   void* queue[2];                                                             \
   struct sockaddr_storage addr;                                               \
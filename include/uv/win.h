@@ -387,6 +387,9 @@ typedef struct {
 #define UV_SHUTDOWN_PRIVATE_FIELDS                                            \
   /* empty */
 
+#define UV_STREAM_PIPE_PRIVATE_FIELDS                                         \
+  /* empty */
+
 #define UV_UDP_SEND_PRIVATE_FIELDS                                            \
   /* empty */
 
@@ -26,6 +26,15 @@
 #include <stdlib.h>
 #include <string.h>
 
+#if defined(__linux__)
+# include <sys/vfs.h>
+#endif
+
+/* Maximum number of paths that are stat'ed by one thread pool work item in
+ * UV_LOOP_FS_POLL_BATCH mode.
+ */
+#define UV__FS_POLL_BATCH_SIZE 64
+
 struct poll_ctx {
   uv_fs_poll_t* parent_handle; /* NULL if parent has been stopped or closed */
   int busy_polling;
@@ -36,13 +45,64 @@ struct poll_ctx {
   uv_timer_t timer_handle;
   uv_fs_t fs_req; /* TODO(bnoordhuis) mark fs_req internal */
   uv_stat_t statbuf;
+  /* UV_LOOP_FS_POLL_BATCH mode only. */
+  struct uv__fs_poll_sched* sched;
+  void* member[2];
+  uint64_t due;
+  int in_batch;
+  int recheck;
+#if defined(__linux__)
+  uv_fs_event_t watch;
+  int watch_open;
+  int watch_state;
+#endif
   char path[1]; /* variable length */
 };
 
+/* Shared by all fs_poll handles of a loop in UV_LOOP_FS_POLL_BATCH mode. One
+ * timer fires when the earliest handle is due and the stats of all handles
+ * that are (nearly) due are done together, UV__FS_POLL_BATCH_SIZE per thread
+ * pool work item.
+ */
+struct uv__fs_poll_sched {
+  uv_timer_t timer;
+  void* ctxs[2];  /* Handles that are not in a batch. */
+};
+
+struct poll_batch_entry {
+  struct poll_ctx* ctx;
+  int result;
+  uv_stat_t statbuf;
+#if defined(__linux__)
+  /* Set if the path wants a watch, batch_work() clears it for remote paths. */
+  int local;
+#endif
+};
+
+struct poll_batch {
+  uv_work_t req;
+  struct uv__fs_poll_sched* sched;
+  uint64_t start_time;
+  unsigned int n;
+  struct poll_batch_entry entries[UV__FS_POLL_BATCH_SIZE];
+};
+
+/* States of the inotify watch that assists a polled path. */
+enum {
+  WATCH_NONE,      /* Not watched, poll. */
+  WATCH_PENDING,   /* Watched, the next stat confirms nothing was missed. */
+  WATCH_COVERED    /* Watched, don't poll. */
+};
+
 static int statbuf_eq(const uv_stat_t* a, const uv_stat_t* b);
 static void poll_cb(uv_fs_t* req);
+static void poll_update(struct poll_ctx* ctx,
+                        int result,
+                        const uv_stat_t* statbuf);
 static void timer_cb(uv_timer_t* timer);
 static void timer_close_cb(uv_handle_t* handle);
+static void sched_add(struct poll_ctx* ctx);
+static void sched_remove(struct poll_ctx* ctx);
 
 static uv_stat_t zero_statbuf;
 
@@ -79,6 +139,14 @@ int uv_fs_poll_start(uv_fs_poll_t* handle,
   ctx->parent_handle = handle;
   memcpy(ctx->path, path, len + 1);
 
+  if (uv__get_internal_fields(loop)->fs_poll_sched != NULL) {
+    ctx->sched = uv__get_internal_fields(loop)->fs_poll_sched;
+    handle->poll_ctx = ctx;
+    uv__handle_start(handle);
+    sched_add(ctx);
+    return 0;
+  }
+
   err = uv_timer_init(loop, &ctx->timer_handle);
   if (err < 0)
     goto error;
@@ -113,11 +181,14 @@ int uv_fs_poll_stop(uv_fs_poll_t* handle) {
   ctx->parent_handle = NULL;
   handle->poll_ctx = NULL;
 
-  /* Close the timer if it's active. If it's inactive, there's a stat request
-   * in progress and poll_cb will take care of the cleanup.
-   */
-  if (uv__is_active(&ctx->timer_handle))
+  if (ctx->sched != NULL) {
+    sched_remove(ctx);
+  } else if (uv__is_active(&ctx->timer_handle)) {
+    /* Close the timer if it's active. If it's inactive, there's a stat
+     * request in progress and poll_cb will take care of the cleanup.
+     */
     uv_close((uv_handle_t*)&ctx->timer_handle, timer_close_cb);
+  }
 
   uv__handle_stop(handle);
 
@@ -169,40 +240,43 @@ static void timer_cb(uv_timer_t* timer) {
 }
 
 
-static void poll_cb(uv_fs_t* req) {
-  uv_stat_t* statbuf;
-  struct poll_ctx* ctx;
-  uint64_t interval;
-
-  ctx = container_of(req, struct poll_ctx, fs_req);
-
-  if (ctx->parent_handle == NULL) { /* handle has been stopped or closed */
-    uv_close((uv_handle_t*)&ctx->timer_handle, timer_close_cb);
-    uv_fs_req_cleanup(req);
-    return;
-  }
-
-  if (req->result != 0) {
-    if (ctx->busy_polling != req->result) {
+/* Reports the outcome of a stat to the user if it differs from the last. */
+static void poll_update(struct poll_ctx* ctx,
+                        int result,
+                        const uv_stat_t* statbuf) {
+  if (result != 0) {
+    if (ctx->busy_polling != result) {
       ctx->poll_cb(ctx->parent_handle,
-                   req->result,
+                   result,
                    &ctx->statbuf,
                    &zero_statbuf);
-      ctx->busy_polling = req->result;
+      ctx->busy_polling = result;
     }
-    goto out;
+    return;
   }
 
-  statbuf = &req->statbuf;
-
   if (ctx->busy_polling != 0)
     if (ctx->busy_polling < 0 || !statbuf_eq(&ctx->statbuf, statbuf))
       ctx->poll_cb(ctx->parent_handle, 0, &ctx->statbuf, statbuf);
 
   ctx->statbuf = *statbuf;
   ctx->busy_polling = 1;
+}
+
+
+static void poll_cb(uv_fs_t* req) {
+  struct poll_ctx* ctx;
+  uint64_t interval;
+
+  ctx = container_of(req, struct poll_ctx, fs_req);
 
-out:
+  if (ctx->parent_handle == NULL) { /* handle has been stopped or closed */
+    uv_close((uv_handle_t*)&ctx->timer_handle, timer_close_cb);
+    uv_fs_req_cleanup(req);
+    return;
+  }
+
+  poll_update(ctx, req->result, &req->statbuf);
   uv_fs_req_cleanup(req);
 
   if (ctx->parent_handle == NULL) { /* handle has been stopped by callback */
@@ -224,6 +298,352 @@ static void timer_close_cb(uv_handle_t* handle) {
 }
 
 
+/* Stat every UV__FS_POLL_WATCHED_FACTOR intervals when inotify covers a path.
+ * It doesn't see everything that can change the outcome of a stat, e.g. a
+ * parent directory being renamed.
+ */
+#define UV__FS_POLL_WATCHED_FACTOR 32
+
+static void sched_timer_cb(uv_timer_t* timer);
+static void batch_work(uv_work_t* req);
+static void batch_done(uv_work_t* req, int status);
+
+
+int uv__fs_poll_sched_init(uv_loop_t* loop) {
+  struct uv__fs_poll_sched* sched;
+  int err;
+
+  if (uv__get_internal_fields(loop)->fs_poll_sched != NULL)
+    return 0;
+
+  sched = uv__malloc(sizeof(*sched));
+  if (sched == NULL)
+    return UV_ENOMEM;
+
+  err = uv_timer_init(loop, &sched->timer);
+  if (err < 0) {
+    uv__free(sched);
+    return err;
+  }
+
+  sched->timer.flags |= UV_HANDLE_INTERNAL;
+  uv__handle_unref(&sched->timer);
+  QUEUE_INIT(&sched->ctxs);
+  uv__get_internal_fields(loop)->fs_poll_sched = sched;
+
+  return 0;
+}
+
+
+/* Called by uv_loop_close() once all handles have been closed. */
+void uv__fs_poll_sched_close(uv_loop_t* loop) {
+  struct uv__fs_poll_sched* sched;
+
+  sched = uv__get_internal_fields(loop)->fs_poll_sched;
+  if (sched == NULL)
+    return;
+
+  assert(QUEUE_EMPTY(&sched->ctxs));
+  uv_timer_stop(&sched->timer);
+  QUEUE_REMOVE(&sched->timer.handle_queue);
+  uv__free(sched);
+  uv__get_internal_fields(loop)->fs_poll_sched = NULL;
+}
+
+
+static void poll_ctx_maybe_free(struct poll_ctx* ctx) {
+  if (ctx->in_batch)
+    return;
+#if defined(__linux__)
+  if (ctx->watch_open)
+    return;
+#endif
+  uv__free(ctx);
+}
+
+
+static void sched_rearm(struct uv__fs_poll_sched* sched) {
+  struct poll_ctx* ctx;
+  uint64_t due;
+  uint64_t now;
+  QUEUE* q;
+
+  due = UINT64_MAX;
+  QUEUE_FOREACH(q, &sched->ctxs) {
+    ctx = QUEUE_DATA(q, struct poll_ctx, member);
+    if (ctx->due < due)
+      due = ctx->due;
+  }
+
+  if (due == UINT64_MAX) {
+    uv_timer_stop(&sched->timer);
+    return;
+  }
+
+  now = uv_now(sched->timer.loop);
+  if (uv_timer_start(&sched->timer,
+                     sched_timer_cb,
+                     due > now ? due - now : 0,
+                     0)) {
+    abort();
+  }
+}
+
+
+#if defined(__linux__)
+/* inotify doesn't see changes made by other hosts. */
+static int poll_path_is_local(const char* path) {
+  struct statfs buf;
+
+  if (statfs(path, &buf))
+    return 0;
+
+  switch ((uint32_t) buf.f_type) {
+    case 0x6969u:      /* NFS */
+    case 0x517Bu:      /* SMB */
+    case 0xFF534D42u:  /* CIFS */
+    case 0xFE534D42u:  /* SMB2 */
+    case 0x65735546u:  /* FUSE */
+    case 0x73757245u:  /* CODA */
+    case 0x5346414Fu:  /* AFS */
+    case 0x01021997u:  /* 9P */
+    case 0x00C36400u:  /* CEPH */
+      return 0;
+  }
+
+  return 1;
+}
+
+
+static void watch_cb(uv_fs_event_t* handle,
+                     const char* filename,
+                     int events,
+                     int status) {
+  struct poll_ctx* ctx;
+
+  ctx = container_of(handle, struct poll_ctx, watch);
+  if (ctx->parent_handle == NULL)
+    return;
+
+  /* The path may refer to a different inode now, or to nothing at all. Drop
+   * the watch, the stat below sets up a new one.
+   */
+  if (events & UV_RENAME) {
+    uv_fs_event_stop(&ctx->watch);
+    ctx->watch_state = WATCH_NONE;
+  }
+
+  if (ctx->in_batch) {
+    ctx->recheck = 1;
+  } else {
+    ctx->due = uv_now(ctx->loop);
+    sched_rearm(ctx->sched);
+  }
+}
+
+
+static void watch_close_cb(uv_handle_t* handle) {
+  struct poll_ctx* ctx;
+
+  ctx = container_of(handle, struct poll_ctx, watch);
+  ctx->watch_open = 0;
+  poll_ctx_maybe_free(ctx);
+}
+
+
+static void watch_start(struct poll_ctx* ctx) {
+  if (!ctx->watch_open) {
+    if (uv_fs_event_init(ctx->loop, &ctx->watch))
+      return;
+    ctx->watch.flags |= UV_HANDLE_INTERNAL;
+    uv__handle_unref(&ctx->watch);
+    ctx->watch_open = 1;
+  }
+
+  if (uv_fs_event_start(&ctx->watch, watch_cb, ctx->path, 0) == 0)
+    ctx->watch_state = WATCH_PENDING;
+}
+#endif  /* defined(__linux__) */
+
+
+/* Called after a stat. A watch is trusted once a stat that started after it
+ * was set up has completed, nothing can have been missed in between.
+ */
+static void watch_update(struct poll_ctx* ctx,
+                         const struct poll_batch_entry* e) {
+#if defined(__linux__)
+  if (ctx->recheck)
+    return;
+
+  if (ctx->watch_state == WATCH_PENDING)
+    ctx->watch_state = WATCH_COVERED;
+  else if (ctx->watch_state == WATCH_NONE && e->result == 0 && e->local)
+    watch_start(ctx);
+#endif
+}
+
+
+static int watch_covers(struct poll_ctx* ctx) {
+#if defined(__linux__)
+  return ctx->watch_state == WATCH_COVERED;
+#else
+  return 0;
+#endif
+}
+
+
+/* The watch is set up after the first stat, batch_work() tells if the path is
+ * local.
+ */
+static void sched_add(struct poll_ctx* ctx) {
+  ctx->due = uv_now(ctx->loop);
+  QUEUE_INSERT_TAIL(&ctx->sched->ctxs, &ctx->member);
+  sched_rearm(ctx->sched);
+}
+
+
+/* The timer goes off when it does, not worth rearming it here. */
+static void sched_remove(struct poll_ctx* ctx) {
+  if (!ctx->in_batch)
+    QUEUE_REMOVE(&ctx->member);
+
+#if defined(__linux__)
+  if (ctx->watch_open)
+    uv_close((uv_handle_t*) &ctx->watch, watch_close_cb);
+#endif
+
+  poll_ctx_maybe_free(ctx);
+}
+
+
+static void sched_timer_cb(uv_timer_t* timer) {
+  struct uv__fs_poll_sched* sched;
+  struct poll_batch* batch;
+  struct poll_ctx* ctx;
+  uint64_t now;
+  QUEUE* q;
+
+  sched = container_of(timer, struct uv__fs_poll_sched, timer);
+  now = uv_now(timer->loop);
+  batch = NULL;
+
+  /* Take along the handles that are due soon to make the batches bigger. */
+  q = QUEUE_HEAD(&sched->ctxs);
+  while (q != &sched->ctxs) {
+    ctx = QUEUE_DATA(q, struct poll_ctx, member);
+    q = QUEUE_NEXT(q);
+
+    if (ctx->due > now + ctx->interval / 8)
+      continue;
+
+    if (batch == NULL) {
+      batch = uv__malloc(sizeof(*batch));
+      if (batch == NULL) {
+        /* Try again later. */
+        if (uv_timer_start(timer, sched_timer_cb, 100, 0))
+          abort();
+        return;
+      }
+
+      batch->sched = sched;
+      batch->start_time = now;
+      batch->n = 0;
+    }
+
+    QUEUE_REMOVE(&ctx->member);
+    ctx->in_batch = 1;
+    ctx->recheck = 0;
+    batch->entries[batch->n].ctx = ctx;
+#if defined(__linux__)
+    batch->entries[batch->n].local = ctx->watch_state == WATCH_NONE;
+#endif
+    batch->n++;
+
+    if (batch->n == UV__FS_POLL_BATCH_SIZE) {
+      uv_queue_work(timer->loop, &batch->req, batch_work, batch_done);
+      batch = NULL;
+    }
+  }
+
+  if (batch != NULL)
+    uv_queue_work(timer->loop, &batch->req, batch_work, batch_done);
+
+  sched_rearm(sched);
+}
+
+
+static void batch_work(uv_work_t* req) {
+  struct poll_batch_entry* e;
+  struct poll_batch* batch;
+  uv_fs_t fs_req;
+  unsigned int i;
+
+  batch = container_of(req, struct poll_batch, req);
+
+  for (i = 0; i < batch->n; i++) {
+    e = &batch->entries[i];
+    e->result = uv_fs_stat(NULL, &fs_req, e->ctx->path, NULL);
+    if (e->result == 0)
+      e->statbuf = fs_req.statbuf;
+    uv_fs_req_cleanup(&fs_req);
+#if defined(__linux__)
+    if (e->result == 0 && e->local)
+      e->local = poll_path_is_local(e->ctx->path);
+#endif
+  }
+}
+
+
+static void batch_done(uv_work_t* req, int status) {
+  struct uv__fs_poll_sched* sched;
+  struct poll_batch_entry* e;
+  struct poll_batch* batch;
+  struct poll_ctx* ctx;
+  unsigned int i;
+  uint64_t now;
+
+  batch = container_of(req, struct poll_batch, req);
+  sched = batch->sched;
+  assert(status == 0);
+
+  for (i = 0; i < batch->n; i++) {
+    e = &batch->entries[i];
+    ctx = e->ctx;
+
+    if (ctx->parent_handle != NULL)
+      poll_update(ctx, e->result, &e->statbuf);
+
+    /* Stays set until here so that uv_fs_poll_stop() in the callback leaves
+     * the ctx alone.
+     */
+    ctx->in_batch = 0;
+
+    if (ctx->parent_handle == NULL) {
+      poll_ctx_maybe_free(ctx);
+      continue;
+    }
+
+    watch_update(ctx, e);
+
+    now = uv_now(ctx->loop);
+    if (ctx->recheck) {
+      ctx->recheck = 0;
+      ctx->due = now;
+    } else if (watch_covers(ctx)) {
+      ctx->due = batch->start_time +
+                 (uint64_t) ctx->interval * UV__FS_POLL_WATCHED_FACTOR;
+    } else {
+      ctx->due = batch->start_time + ctx->interval;
+    }
+
+    QUEUE_INSERT_TAIL(&sched->ctxs, &ctx->member);
+  }
+
+  uv__free(batch);
+  sched_rearm(sched);
+}
+
+
 static int statbuf_eq(const uv_stat_t* a, const uv_stat_t* b) {
   return a->st_ctim.tv_nsec == b->st_ctim.tv_nsec
       && a->st_mtim.tv_nsec == b->st_mtim.tv_nsec
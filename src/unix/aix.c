@@ -824,6 +824,11 @@ void uv__fs_event_close(uv_fs_event_t* handle) {
 }
 
 
+int uv_fs_event_set_coalesce(uv_fs_event_t* handle, unsigned int window) {
+  return UV_ENOSYS;
+}
+
+
 char** uv_setup_args(int argc, char** argv) {
   char** new_argv;
   size_t size;
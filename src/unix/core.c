@@ -358,8 +358,17 @@ int uv_run(uv_loop_t* loop, uv_run_mode mode) {
     if ((mode == UV_RUN_ONCE && !ran_pending) || mode == UV_RUN_DEFAULT)
       timeout = uv_backend_timeout(loop);
 
+    /* Send what batched TCP handles wrote so far before going to sleep. */
+    if (!QUEUE_EMPTY(&uv__get_internal_fields(loop)->corked_handles))
+      uv__tcp_uncork_all(loop);
+
     uv__io_poll(loop, timeout);
     uv__run_check(loop);
+
+    /* And again for what they wrote in I/O and check callbacks. */
+    if (!QUEUE_EMPTY(&uv__get_internal_fields(loop)->corked_handles))
+      uv__tcp_uncork_all(loop);
+
     uv__run_closing_handles(loop);
 
     if (mode == UV_RUN_ONCE) {
@@ -437,6 +446,31 @@ int uv__socket(int domain, int type, int protocol) {
   return sockfd;
 }
 
+
+/* Only enable port sharing where the kernel balances the load across the
+ * sockets. Elsewhere the last socket to bind steals all of the traffic and
+ * that is not what the caller asked for.
+ */
+int uv__sock_reuseport(int fd) {
+  int on;
+
+  on = 1;
+#if defined(SO_REUSEPORT_LB)
+  /* FreeBSD 12 and newer. */
+  if (setsockopt(fd, SOL_SOCKET, SO_REUSEPORT_LB, &on, sizeof(on)))
+    return UV__ERR(errno);
+#elif defined(SO_REUSEPORT) && \
+      (defined(__linux__) || defined(__DragonFly__))
+  if (setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &on, sizeof(on)))
+    return UV__ERR(errno);
+#else
+  (void) on;
+  return UV_ENOTSUP;
+#endif
+
+  return 0;
+}
+
 /* get a file pointer to a file in read-only and close-on-exec mode */
 FILE* uv__open_file(const char* path) {
   int fd;
@@ -67,6 +67,19 @@
 # define FICLONE _IOW(0x94, 9, int)
 #endif
 
+#if defined(__linux__)
+# include <sys/ioctl.h>
+# if !defined(BLKSSZGET)
+#  define BLKSSZGET _IO(0x12, 104)
+# endif
+# if !defined(FALLOC_FL_KEEP_SIZE)
+#  define FALLOC_FL_KEEP_SIZE 0x01
+# endif
+# if !defined(FALLOC_FL_PUNCH_HOLE)
+#  define FALLOC_FL_PUNCH_HOLE 0x02
+# endif
+#endif
+
 #if defined(_AIX) && !defined(_AIX71)
 # include <utime.h>
 #endif
@@ -176,6 +189,136 @@ static ssize_t uv__fs_fdatasync(uv_fs_t* req) {
 }
 
 
+static ssize_t uv__fs_fadvise(uv_fs_t* req) {
+#if defined(__APPLE__)
+  /* No posix_fadvise() but F_RDAHEAD and F_RDADVISE cover the useful cases. */
+  struct radvisory ra;
+
+  switch (req->flags) {
+  case UV_FS_FADV_NORMAL:
+  case UV_FS_FADV_SEQUENTIAL:
+    return fcntl(req->file, F_RDAHEAD, 1);
+  case UV_FS_FADV_RANDOM:
+    return fcntl(req->file, F_RDAHEAD, 0);
+  case UV_FS_FADV_WILLNEED:
+    ra.ra_offset = req->off;
+    ra.ra_count = INT_MAX;
+    if (req->bufsml[0].len > 0 && req->bufsml[0].len < INT_MAX)
+      ra.ra_count = req->bufsml[0].len;
+    return fcntl(req->file, F_RDADVISE, &ra);
+  default:
+    return 0;  /* Advisory only. */
+  }
+#elif defined(POSIX_FADV_NORMAL)
+  static const int advice[] = {
+    POSIX_FADV_NORMAL,
+    POSIX_FADV_RANDOM,
+    POSIX_FADV_SEQUENTIAL,
+    POSIX_FADV_WILLNEED,
+    POSIX_FADV_DONTNEED,
+    POSIX_FADV_NOREUSE
+  };
+  int r;
+
+  /* Returns the error number instead of setting errno. */
+  r = posix_fadvise(req->file,
+                    req->off,
+                    req->bufsml[0].len,
+                    advice[req->flags]);
+  if (r != 0) {
+    errno = r;
+    return -1;
+  }
+
+  return 0;
+#else
+  errno = ENOSYS;
+  return -1;
+#endif
+}
+
+
+static ssize_t uv__fs_readahead(uv_fs_t* req) {
+#if defined(__linux__)
+  return readahead(req->file, req->off, req->bufsml[0].len);
+#else
+  req->flags = UV_FS_FADV_WILLNEED;
+  return uv__fs_fadvise(req);
+#endif
+}
+
+
+static ssize_t uv__fs_fallocate(uv_fs_t* req) {
+#if defined(__linux__)
+  int mode;
+
+  mode = 0;
+  if (req->flags & UV_FS_FALLOCATE_KEEP_SIZE)
+    mode |= FALLOC_FL_KEEP_SIZE;
+  if (req->flags & UV_FS_FALLOCATE_PUNCH_HOLE)
+    mode |= FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE;
+
+  return fallocate(req->file, mode, req->off, req->bufsml[0].len);
+#elif defined(__APPLE__)
+  struct stat st;
+  fstore_t fst;
+  off_t end;
+
+  if (req->flags & UV_FS_FALLOCATE_PUNCH_HOLE) {
+    errno = ENOSYS;
+    return -1;
+  }
+
+  if (fstat(req->file, &st))
+    return -1;
+
+  end = req->off + req->bufsml[0].len;
+  if (end <= st.st_size)
+    return 0;
+
+  /* Try for a contiguous extent first, then settle for any extent. */
+  fst.fst_flags = F_ALLOCATECONTIG | F_ALLOCATEALL;
+  fst.fst_posmode = F_PEOFPOSMODE;
+  fst.fst_offset = 0;
+  fst.fst_length = end - st.st_size;
+  fst.fst_bytesalloc = 0;
+
+  if (fcntl(req->file, F_PREALLOCATE, &fst) == -1) {
+    fst.fst_flags = F_ALLOCATEALL;
+    if (fcntl(req->file, F_PREALLOCATE, &fst) == -1)
+      return -1;
+  }
+
+  if (req->flags & UV_FS_FALLOCATE_KEEP_SIZE)
+    return 0;
+
+  return ftruncate(req->file, end);
+#elif defined(__FreeBSD__)                                                    \
+    || defined(__NetBSD__)                                                    \
+    || defined(__sun)                                                         \
+    || defined(_AIX)
+  int r;
+
+  if (req->flags != 0) {
+    errno = ENOSYS;
+    return -1;
+  }
+
+  /* Returns the error number instead of setting errno. */
+  r = posix_fallocate(req->file, req->off, req->bufsml[0].len);
+  if (r != 0) {
+    errno = r;
+    return -1;
+  }
+
+  return 0;
+#else
+  errno = ENOSYS;
+  return -1;
+#endif
+}
+
+
 static ssize_t uv__fs_futime(uv_fs_t* req) {
 #if defined(__linux__)                                                        \
     || defined(_AIX71)
@@ -333,6 +476,107 @@ done:
 }
 
 
+/* The pool and the offsets to read from are stashed in req->bufsml[1], see
+ * uv_fs_read_aligned().
+ */
+static ssize_t uv__fs_read_aligned(uv_fs_t* req) {
+  size_t skip;
+  size_t len;
+  ssize_t r;
+
+  skip = req->bufsml[1].len;
+  len = req->bufsml[2].len;
+
+  r = uv__fs_read(req);
+  if (r == -1)
+    return -1;
+
+  req->ptr = req->bufsml[0].base + skip;
+
+  if ((size_t) r <= skip)
+    return 0;
+
+  r -= skip;
+  if ((size_t) r > len)
+    r = len;
+
+  return r;
+}
+
+
+/* The ranges are stashed in req->bufsml[0], see uv_fs_read_multi(). Each
+ * range is read in full unless EOF or an error is hit first, short reads are
+ * continued. Returns the total number of bytes read.
+ */
+static ssize_t uv__fs_read_multi(uv_fs_t* req) {
+  uv_fs_read_range_t* range;
+  unsigned int nranges;
+  unsigned int i;
+  ssize_t total;
+  size_t nread;
+  ssize_t r;
+
+  range = (uv_fs_read_range_t*) req->bufsml[0].base;
+  nranges = req->bufsml[0].len;
+  total = 0;
+
+  for (i = 0; i < nranges; i++, range++) {
+    nread = 0;
+    r = 0;
+
+    while (nread < range->buf.len) {
+      do
+        r = pread(req->file,
+                  range->buf.base + nread,
+                  range->buf.len - nread,
+                  range->offset + nread);
+      while (r == -1 && errno == EINTR);
+
+      if (r <= 0)
+        break;
+
+      nread += r;
+    }
+
+    if (r == -1 && nread == 0) {
+      range->result = UV__ERR(errno);
+    } else {
+      range->result = nread;
+      total += nread;
+    }
+  }
+
+  return total;
+}
+
+
+int uv__fs_get_block_size(uv_file file, size_t* size) {
+  struct stat st;
+#if defined(__linux__)
+  int ssz;
+#endif
+
+  if (fstat(file, &st))
+    return UV__ERR(errno);
+
+#if defined(__linux__)
+  /* Block devices report the page size in st_blksize. */
+  if (S_ISBLK(st.st_mode) && ioctl(file, BLKSSZGET, &ssz) == 0 && ssz > 0) {
+    *size = ssz;
+    return 0;
+  }
+#endif
+
+  /* The preferred I/O size is a multiple of the logical block size. */
+  if (st.st_blksize > 0)
+    *size = st.st_blksize;
+  else
+    *size = 512;
+
+  return 0;
+}
+
+
 #if defined(__APPLE__) && !defined(MAC_OS_X_VERSION_10_8)
 #define UV_CONST_DIRENT uv__dirent_t
 #else
@@ -1235,7 +1479,9 @@ static void uv__fs_work(struct uv__work* w) {
 
   req = container_of(w, uv_fs_t, work_req);
   retry_on_eintr = !(req->fs_type == UV_FS_CLOSE ||
-                     req->fs_type == UV_FS_READ);
+                     req->fs_type == UV_FS_READ ||
+                     req->fs_type == UV_FS_READ_ALIGNED ||
+                     req->fs_type == UV_FS_READ_MULTI);
 
   do {
     errno = 0;
@@ -1254,6 +1500,8 @@ static void uv__fs_work(struct uv__work* w) {
     X(FCHMOD, fchmod(req->file, req->mode));
     X(FCHOWN, fchown(req->file, req->uid, req->gid));
     X(LCHOWN, lchown(req->path, req->uid, req->gid));
+    X(FADVISE, uv__fs_fadvise(req));
+    X(FALLOCATE, uv__fs_fallocate(req));
     X(FDATASYNC, uv__fs_fdatasync(req));
     X(FSTAT, uv__fs_fstat(req->file, &req->statbuf));
     X(FSYNC, uv__fs_fsync(req));
@@ -1265,6 +1513,9 @@ static void uv__fs_work(struct uv__work* w) {
     X(MKDTEMP, uv__fs_mkdtemp(req));
     X(OPEN, uv__fs_open(req));
     X(READ, uv__fs_read(req));
+    X(READAHEAD, uv__fs_readahead(req));
+    X(READ_ALIGNED, uv__fs_read_aligned(req));
+    X(READ_MULTI, uv__fs_read_multi(req));
     X(SCANDIR, uv__fs_scandir(req));
     X(READLINK, uv__fs_readlink(req));
     X(REALPATH, uv__fs_realpath(req));
@@ -1309,6 +1560,399 @@ static void uv__fs_done(struct uv__work* w, int status) {
 }
 
 
+/* Group commit, enabled with UV_LOOP_FS_GROUP_COMMIT. At most one sync per
+ * file descriptor is in flight. Requests that arrive in the meantime can't
+ * piggyback on it because it may have started before their writes completed,
+ * so they are parked in `pending` and all of them are then served by a single
+ * fsync() or fdatasync() once the in-flight one finishes. Parked requests are
+ * linked through their (unused) work_req.wq.
+ */
+struct uv__fs_sync_group {
+  void* queue[2];
+  uv_file file;
+  uv_fs_t* leader;
+  void* followers[2];
+  void* pending[2];
+};
+
+
+static void uv__fs_sync_done(struct uv__work* w, int status);
+
+
+static struct uv__fs_sync_group* uv__fs_sync_group_find(uv_loop_t* loop,
+                                                        uv_file file) {
+  struct uv__fs_sync_group* group;
+  QUEUE* q;
+
+  QUEUE_FOREACH(q, &uv__get_internal_fields(loop)->fs_sync_groups) {
+    group = QUEUE_DATA(q, struct uv__fs_sync_group, queue);
+    if (group->file == file)
+      return group;
+  }
+
+  return NULL;
+}
+
+
+/* Turns the pending requests into the next batch. A full fsync() covers
+ * fdatasync() so if any request in the batch asked for one, it leads.
+ */
+static void uv__fs_sync_group_flush(uv_loop_t* loop,
+                                    struct uv__fs_sync_group* group) {
+  uv_fs_t* leader;
+  uv_fs_t* req;
+  QUEUE* q;
+
+  leader = NULL;
+  QUEUE_FOREACH(q, &group->pending) {
+    req = container_of(q, uv_fs_t, work_req.wq);
+    if (leader == NULL || req->fs_type == UV_FS_FSYNC)
+      leader = req;
+    if (req->fs_type == UV_FS_FSYNC)
+      break;
+  }
+
+  QUEUE_REMOVE(&leader->work_req.wq);
+  QUEUE_MOVE(&group->pending, &group->followers);
+  group->leader = leader;
+
+  uv__work_submit(loop,
+                  &leader->work_req,
+                  UV__WORK_FAST_IO,
+                  uv__fs_work,
+                  uv__fs_sync_done);
+}
+
+
+static int uv__fs_sync_submit(uv_loop_t* loop, uv_fs_t* req) {
+  struct uv__fs_sync_group* group;
+
+  group = uv__fs_sync_group_find(loop, req->file);
+
+  if (group == NULL) {
+    group = uv__malloc(sizeof(*group));
+    if (group == NULL)
+      return UV_ENOMEM;
+
+    group->file = req->file;
+    group->leader = NULL;
+    QUEUE_INIT(&group->followers);
+    QUEUE_INIT(&group->pending);
+    QUEUE_INSERT_TAIL(&uv__get_internal_fields(loop)->fs_sync_groups,
+                      &group->queue);
+  }
+
+  uv__req_register(loop, req);
+
+  /* Not submitted to the thread pool, uv_cancel() returns UV_EBUSY. */
+  req->work_req.loop = loop;
+  req->work_req.work = NULL;
+  QUEUE_INSERT_TAIL(&group->pending, &req->work_req.wq);
+
+  if (group->leader == NULL)
+    uv__fs_sync_group_flush(loop, group);
+
+  return 0;
+}
+
+
+static void uv__fs_sync_done(struct uv__work* w, int status) {
+  struct uv__fs_sync_group* group;
+  uv_fs_t* leader;
+  uv_fs_t* req;
+  uv_loop_t* loop;
+  QUEUE followers;
+  QUEUE* q;
+
+  leader = container_of(w, uv_fs_t, work_req);
+  loop = leader->loop;
+  group = uv__fs_sync_group_find(loop, leader->file);
+  assert(group != NULL && group->leader == leader);
+
+  QUEUE_INIT(&followers);
+  if (status == UV_ECANCELED) {
+    /* The followers weren't served, they go first in the next batch. */
+    if (!QUEUE_EMPTY(&group->pending))
+      QUEUE_ADD(&group->followers, &group->pending);
+    QUEUE_MOVE(&group->followers, &group->pending);
+  } else {
+    QUEUE_MOVE(&group->followers, &followers);
+  }
+
+  /* Start the next batch before running callbacks, syncs they issue must
+   * not be served by it.
+   */
+  group->leader = NULL;
+  if (QUEUE_EMPTY(&group->pending)) {
+    QUEUE_REMOVE(&group->queue);
+    uv__free(group);
+  } else {
+    uv__fs_sync_group_flush(loop, group);
+  }
+
+  while (!QUEUE_EMPTY(&followers)) {
+    q = QUEUE_HEAD(&followers);
+    QUEUE_REMOVE(q);
+    req = container_of(q, uv_fs_t, work_req.wq);
+    req->result = leader->result;
+    uv__req_unregister(loop, req);
+    req->cb(req);
+  }
+
+  uv__fs_done(w, status);
+}
+
+
+/* Write coalescing, enabled with UV_LOOP_FS_COALESCE_WRITES. Asynchronous
+ * writes to a file descriptor are run one batch at a time. Writes queued up
+ * behind the batch in flight are merged into a single pwritev() (or writev()
+ * for writes at the current file position) as long as they are contiguous
+ * and fit in uv__getiovmax() buffers. Like with group commit, queued requests
+ * are linked through their work_req.wq and can't be cancelled.
+ */
+struct uv__fs_write_queue {
+  void* queue[2];
+  uv_file file;
+  int busy;
+  void* batch[2];
+  void* pending[2];
+  uv_fs_t req;
+};
+
+
+static void uv__fs_write_queue_done(struct uv__work* w, int status);
+
+
+static struct uv__fs_write_queue* uv__fs_write_queue_find(uv_loop_t* loop,
+                                                          uv_file file) {
+  struct uv__fs_write_queue* wq;
+  QUEUE* q;
+
+  QUEUE_FOREACH(q, &uv__get_internal_fields(loop)->fs_write_queues) {
+    wq = QUEUE_DATA(q, struct uv__fs_write_queue, queue);
+    if (wq->file == file)
+      return wq;
+  }
+
+  return NULL;
+}
+
+
+static size_t uv__fs_bufs_len(const uv_buf_t* bufs, unsigned int nbufs) {
+  size_t len;
+  unsigned int i;
+
+  len = 0;
+  for (i = 0; i < nbufs; i++)
+    len += bufs[i].len;
+
+  return len;
+}
+
+
+static void uv__fs_write_queue_flush(uv_loop_t* loop,
+                                     struct uv__fs_write_queue* wq) {
+  unsigned int iovmax;
+  unsigned int nbufs;
+  uv_buf_t* bufs;
+  uv_fs_t* first;
+  uv_fs_t* req;
+  int64_t end;
+  QUEUE* q;
+
+  iovmax = uv__getiovmax();
+  first = container_of(QUEUE_HEAD(&wq->pending), uv_fs_t, work_req.wq);
+  QUEUE_REMOVE(&first->work_req.wq);
+  QUEUE_INSERT_TAIL(&wq->batch, &first->work_req.wq);
+
+  nbufs = first->nbufs;
+  end = first->off;
+  if (end >= 0)
+    end += uv__fs_bufs_len(first->bufs, first->nbufs);
+
+  while (!QUEUE_EMPTY(&wq->pending)) {
+    q = QUEUE_HEAD(&wq->pending);
+    req = container_of(q, uv_fs_t, work_req.wq);
+
+    if (nbufs + req->nbufs > iovmax)
+      break;
+
+    if (req->off < 0 ? end >= 0 : req->off != end)
+      break;
+
+    QUEUE_REMOVE(q);
+    QUEUE_INSERT_TAIL(&wq->batch, q);
+    nbufs += req->nbufs;
+    if (end >= 0)
+      end += uv__fs_bufs_len(req->bufs, req->nbufs);
+  }
+
+  bufs = wq->req.bufsml;
+  if (nbufs > ARRAY_SIZE(wq->req.bufsml))
+    bufs = uv__malloc(nbufs * sizeof(*bufs));
+
+  if (bufs == NULL) {
+    /* Out of memory, write just the first request. */
+    while (QUEUE_PREV(&wq->batch) != &first->work_req.wq) {
+      q = QUEUE_PREV(&wq->batch);
+      QUEUE_REMOVE(q);
+      QUEUE_INSERT_HEAD(&wq->pending, q);
+    }
+
+    /* uv__fs_write_all() frees the buffer list, hand over ours. */
+    bufs = wq->req.bufsml;
+    nbufs = first->nbufs;
+    if (first->bufs == first->bufsml)
+      memcpy(bufs, first->bufs, nbufs * sizeof(*bufs));
+    else
+      bufs = first->bufs;
+    first->bufs = first->bufsml;
+  } else {
+    nbufs = 0;
+    QUEUE_FOREACH(q, &wq->batch) {
+      req = container_of(q, uv_fs_t, work_req.wq);
+      memcpy(bufs + nbufs, req->bufs, req->nbufs * sizeof(*bufs));
+      nbufs += req->nbufs;
+    }
+  }
+
+  wq->busy = 1;
+  wq->req.fs_type = UV_FS_WRITE;
+  wq->req.loop = loop;
+  wq->req.file = wq->file;
+  wq->req.bufs = bufs;
+  wq->req.nbufs = nbufs;
+  wq->req.off = first->off;
+  wq->req.result = 0;
+
+  uv__work_submit(loop,
+                  &wq->req.work_req,
+                  UV__WORK_FAST_IO,
+                  uv__fs_work,
+                  uv__fs_write_queue_done);
+}
+
+
+static int uv__fs_write_submit(uv_loop_t* loop, uv_fs_t* req) {
+  struct uv__fs_write_queue* wq;
+
+  wq = uv__fs_write_queue_find(loop, req->file);
+
+  if (wq == NULL) {
+    wq = uv__malloc(sizeof(*wq));
+    if (wq == NULL)
+      return UV_ENOMEM;
+
+    wq->file = req->file;
+    wq->busy = 0;
+    QUEUE_INIT(&wq->batch);
+    QUEUE_INIT(&wq->pending);
+    QUEUE_INSERT_TAIL(&uv__get_internal_fields(loop)->fs_write_queues,
+                      &wq->queue);
+  }
+
+  uv__req_register(loop, req);
+
+  /* Not submitted to the thread pool, uv_cancel() returns UV_EBUSY. */
+  req->work_req.loop = loop;
+  req->work_req.work = NULL;
+  QUEUE_INSERT_TAIL(&wq->pending, &req->work_req.wq);
+
+  if (!wq->busy)
+    uv__fs_write_queue_flush(loop, wq);
+
+  return 0;
+}
+
+
+/* Splits the result of the merged write over the requests in the batch. A
+ * short write leaves the requests that didn't get any bytes written queued,
+ * they are retried and report their own error, if any.
+ */
+static void uv__fs_write_queue_done(struct uv__work* w, int status) {
+  struct uv__fs_write_queue* wq;
+  uv_fs_t* req;
+  uv_loop_t* loop;
+  ssize_t remaining;
+  size_t len;
+  QUEUE batch;
+  QUEUE retry;
+  QUEUE* q;
+
+  wq = container_of(w, struct uv__fs_write_queue, req.work_req);
+  loop = wq->req.loop;
+  assert(status == 0);
+
+  QUEUE_MOVE(&wq->batch, &batch);
+  QUEUE_INIT(&retry);
+  remaining = wq->req.result;
+
+  /* The first request always completes. It's the only one in the batch when
+   * its buffer list was handed over after a failed allocation.
+   */
+  q = QUEUE_HEAD(&batch);
+  req = container_of(q, uv_fs_t, work_req.wq);
+  q = QUEUE_NEXT(q);
+  if (remaining < 0 || q == &batch) {
+    req->result = remaining;
+  } else {
+    len = uv__fs_bufs_len(req->bufs, req->nbufs);
+    if (len > (size_t) remaining)
+      len = remaining;
+    req->result = len;
+    remaining -= len;
+  }
+
+  while (q != &batch) {
+    req = container_of(q, uv_fs_t, work_req.wq);
+    q = QUEUE_NEXT(q);
+    len = uv__fs_bufs_len(req->bufs, req->nbufs);
+
+    if (remaining <= 0 && len > 0) {
+      QUEUE_REMOVE(&req->work_req.wq);
+      QUEUE_INSERT_TAIL(&retry, &req->work_req.wq);
+      continue;
+    }
+
+    if (len > (size_t) remaining)
+      len = remaining;
+    req->result = len;
+    remaining -= len;
+  }
+
+  if (!QUEUE_EMPTY(&retry)) {
+    if (!QUEUE_EMPTY(&wq->pending))
+      QUEUE_ADD(&retry, &wq->pending);
+    QUEUE_MOVE(&retry, &wq->pending);
+  }
+
+  /* Start the next batch before running callbacks so that writes issued from
+   * them queue up behind the ones that are already waiting.
+   */
+  wq->busy = 0;
+  if (QUEUE_EMPTY(&wq->pending)) {
+    QUEUE_REMOVE(&wq->queue);
+    uv__free(wq);
+  } else {
+    uv__fs_write_queue_flush(loop, wq);
+  }
+
+  while (!QUEUE_EMPTY(&batch)) {
+    q = QUEUE_HEAD(&batch);
+    QUEUE_REMOVE(q);
+    req = container_of(q, uv_fs_t, work_req.wq);
+
+    if (req->bufs != req->bufsml)
+      uv__free(req->bufs);
+    req->bufs = NULL;
+    req->nbufs = 0;
+
+    uv__req_unregister(loop, req);
+    req->cb(req);
+  }
+}
+
+
 int uv_fs_access(uv_loop_t* loop,
                  uv_fs_t* req,
                  const char* path,
@@ -1397,6 +2041,8 @@ int uv_fs_lchown(uv_loop_t* loop,
 int uv_fs_fdatasync(uv_loop_t* loop, uv_fs_t* req, uv_file file, uv_fs_cb cb) {
   INIT(FDATASYNC);
   req->file = file;
+  if (cb != NULL && (loop->flags & UV_LOOP_GROUP_COMMIT))
+    return uv__fs_sync_submit(loop, req);
   POST;
 }
 
@@ -1411,6 +2057,8 @@ int uv_fs_fstat(uv_loop_t* loop, uv_fs_t* req, uv_file file, uv_fs_cb cb) {
 int uv_fs_fsync(uv_loop_t* loop, uv_fs_t* req, uv_file file, uv_fs_cb cb) {
   INIT(FSYNC);
   req->file = file;
+  if (cb != NULL && (loop->flags & UV_LOOP_GROUP_COMMIT))
+    return uv__fs_sync_submit(loop, req);
   POST;
 }
 
@@ -1427,6 +2075,52 @@ int uv_fs_ftruncate(uv_loop_t* loop,
 }
 
 
+int uv_fs_fadvise(uv_loop_t* loop,
+                  uv_fs_t* req,
+                  uv_file file,
+                  int64_t off,
+                  int64_t len,
+                  int advice,
+                  uv_fs_cb cb) {
+  INIT(FADVISE);
+
+  if (advice < UV_FS_FADV_NORMAL || advice > UV_FS_FADV_NOREUSE)
+    return UV_EINVAL;
+
+  if (off < 0 || len < 0 || (uint64_t) len > (size_t) -1)
+    return UV_EINVAL;
+
+  req->file = file;
+  req->off = off;
+  req->bufsml[0].len = len;
+  req->flags = advice;
+  POST;
+}
+
+
+int uv_fs_fallocate(uv_loop_t* loop,
+                    uv_fs_t* req,
+                    uv_file file,
+                    int mode,
+                    int64_t off,
+                    int64_t len,
+                    uv_fs_cb cb) {
+  INIT(FALLOCATE);
+
+  if (mode & ~(UV_FS_FALLOCATE_KEEP_SIZE | UV_FS_FALLOCATE_PUNCH_HOLE))
+    return UV_EINVAL;
+
+  if (off < 0 || len <= 0 || (uint64_t) len > (size_t) -1)
+    return UV_EINVAL;
+
+  req->file = file;
+  req->off = off;
+  req->bufsml[0].len = len;
+  req->flags = mode;
+  POST;
+}
+
+
 int uv_fs_futime(uv_loop_t* loop,
                  uv_fs_t* req,
                  uv_file file,
@@ -1525,6 +2219,74 @@ int uv_fs_read(uv_loop_t* loop, uv_fs_t* req,
 }
 
 
+int uv_fs_read_aligned(uv_loop_t* loop,
+                       uv_fs_t* req,
+                       uv_fs_buf_pool_t* pool,
+                       uv_file file,
+                       int64_t off,
+                       size_t len,
+                       uv_fs_cb cb) {
+  uint64_t start;
+  uint64_t end;
+  uv_buf_t buf;
+  int err;
+
+  INIT(READ_ALIGNED);
+  req->bufsml[0].base = NULL;  /* No pool buffer for uv_fs_req_cleanup(). */
+
+  if (pool == NULL || off < 0 || len == 0)
+    return UV_EINVAL;
+
+  start = off & ~(uint64_t) (pool->block_size - 1);
+  end = ((uint64_t) off + len + pool->block_size - 1) &
+        ~(uint64_t) (pool->block_size - 1);
+
+  if (end - start > pool->buf_size)
+    return UV_EINVAL;
+
+  err = uv_fs_buf_pool_alloc(pool, &buf);
+  if (err)
+    return err;
+
+  req->file = file;
+  req->off = start;
+  req->bufsml[0].base = buf.base;
+  req->bufsml[0].len = end - start;
+  req->bufsml[1].base = (char*) pool;  /* hack */
+  req->bufsml[1].len = off - start;
+  req->bufsml[2].len = len;
+  req->bufs = req->bufsml;
+  req->nbufs = 1;
+  POST;
+}
+
+
+int uv_fs_read_multi(uv_loop_t* loop,
+                     uv_fs_t* req,
+                     uv_file file,
+                     uv_fs_read_range_t ranges[],
+                     unsigned int nranges,
+                     uv_fs_cb cb) {
+  unsigned int i;
+
+  INIT(READ_MULTI);
+
+  if (ranges == NULL || nranges == 0)
+    return UV_EINVAL;
+
+  for (i = 0; i < nranges; i++) {
+    if (ranges[i].offset < 0)
+      return UV_EINVAL;
+    ranges[i].result = 0;
+  }
+
+  req->file = file;
+  req->bufsml[0].base = (char*) ranges;  /* hack */
+  req->bufsml[0].len = nranges;
+  POST;
+}
+
+
 int uv_fs_scandir(uv_loop_t* loop,
                   uv_fs_t* req,
                   const char* path,
@@ -1547,6 +2309,24 @@ int uv_fs_readlink(uv_loop_t* loop,
 }
 
 
+int uv_fs_readahead(uv_loop_t* loop,
+                    uv_fs_t* req,
+                    uv_file file,
+                    int64_t off,
+                    size_t len,
+                    uv_fs_cb cb) {
+  INIT(READAHEAD);
+
+  if (off < 0)
+    return UV_EINVAL;
+
+  req->file = file;
+  req->off = off;
+  req->bufsml[0].len = len;
+  POST;
+}
+
+
 int uv_fs_realpath(uv_loop_t* loop,
                   uv_fs_t* req,
                   const char * path,
@@ -1639,6 +2419,8 @@ int uv_fs_write(uv_loop_t* loop,
                 unsigned int nbufs,
                 int64_t off,
                 uv_fs_cb cb) {
+  int err;
+
   INIT(WRITE);
 
   if (bufs == NULL || nbufs == 0)
@@ -1657,6 +2439,17 @@ int uv_fs_write(uv_loop_t* loop,
   memcpy(req->bufs, bufs, nbufs * sizeof(*bufs));
 
   req->off = off;
+
+  if (cb != NULL && (loop->flags & UV_LOOP_COALESCE_WRITES)) {
+    err = uv__fs_write_submit(loop, req);
+    if (err != 0) {
+      if (req->bufs != req->bufsml)
+        uv__free(req->bufs);
+      req->bufs = NULL;
+    }
+    return err;
+  }
+
   POST;
 }
 
@@ -1679,6 +2472,14 @@ void uv_fs_req_cleanup(uv_fs_t* req) {
   if (req->fs_type == UV_FS_SCANDIR && req->ptr != NULL)
     uv__fs_scandir_cleanup(req);
 
+  /* req->ptr points into the pool buffer. */
+  if (req->fs_type == UV_FS_READ_ALIGNED && req->bufsml[0].base != NULL) {
+    uv_fs_buf_pool_free((uv_fs_buf_pool_t*) req->bufsml[1].base,
+                        req->bufsml[0]);
+    req->bufsml[0].base = NULL;
+    req->ptr = NULL;
+  }
+
   if (req->bufs != req->bufsml)
     uv__free(req->bufs);
   req->bufs = NULL;
@@ -129,7 +129,9 @@ typedef struct uv__stream_queued_fds_s uv__stream_queued_fds_t;
 
 /* loop flags */
 enum {
-  UV_LOOP_BLOCK_SIGPROF = 1
+  UV_LOOP_BLOCK_SIGPROF = 1,
+  UV_LOOP_GROUP_COMMIT = 2,
+  UV_LOOP_COALESCE_WRITES = 4
 };
 
 /* flags of excluding ifaddr */
@@ -149,6 +151,39 @@ struct uv__stream_queued_fds_s {
   int fds[1];
 };
 
+/* The I/O counters of uv_tcp_get_info(). */
+typedef struct {
+  uint64_t bytes_read;
+  uint64_t bytes_written;
+  uint64_t read_calls;
+  uint64_t write_calls;
+} uv__stream_stats_t;
+
+/* Stream state that doesn't fit in uv_stream_t, see
+ * uv__handle_internal_fields(). Allocated by the first API call that needs
+ * it and freed by uv__stream_destroy().
+ */
+typedef struct {
+  uv_stream_t* stream;
+  size_t write_queue_high;
+  size_t write_queue_low;
+  uv_write_queue_cb write_queue_cb;
+  unsigned int accept_budget;
+  uv_connection_batch_cb connection_batch_cb;
+  void* cork_queue[2];
+  void* zerocopy;
+  void* splice_src;
+  void* splice_dst;
+  uv__stream_stats_t* stats;  /* Set by uv_tcp_enable_stats(). */
+} uv__stream_internal_fields_t;
+
+#define uv__stream_internal_fields(s)                                         \
+  ((uv__stream_internal_fields_t*) uv__handle_internal_fields(s))
+
+#define uv__stream_stats(s)                                                   \
+  (uv__stream_internal_fields(s) != NULL ?                                    \
+      uv__stream_internal_fields(s)->stats : NULL)
+
 
 #if defined(_AIX) || \
     defined(__APPLE__) || \
@@ -185,6 +220,7 @@ int uv__nonblock_fcntl(int fd, int set);
 int uv__close(int fd); /* preserves errno */
 int uv__close_nocheckstdio(int fd);
 int uv__socket(int domain, int type, int protocol);
+int uv__sock_reuseport(int fd);
 ssize_t uv__recvmsg(int fd, struct msghdr *msg, int flags);
 void uv__make_close_pending(uv_handle_t* handle);
 int uv__getiovmax(void);
@@ -215,6 +251,9 @@ void uv__stream_init(uv_loop_t* loop, uv_stream_t* stream,
     uv_handle_type type);
 int uv__stream_open(uv_stream_t*, int fd, int flags);
 void uv__stream_destroy(uv_stream_t* stream);
+uv__stream_internal_fields_t* uv__stream_internal_fields_get(
+    uv_stream_t* stream);
+void uv__stream_fastopen_sent(uv_write_t* req, size_t n);
 #if defined(__APPLE__)
 int uv__stream_try_select(uv_stream_t* stream, int* fd);
 #endif /* defined(__APPLE__) */
@@ -227,6 +266,8 @@ int uv__open_cloexec(const char* path, int flags);
 int uv_tcp_listen(uv_tcp_t* tcp, int backlog, uv_connection_cb cb);
 int uv__tcp_nodelay(int fd, int on);
 int uv__tcp_keepalive(int fd, int on, unsigned int delay);
+void uv__tcp_cork(uv_tcp_t* handle);
+void uv__tcp_uncork_all(uv_loop_t* loop);
 
 /* pipe */
 int uv_pipe_listen(uv_pipe_t* handle, int backlog, uv_connection_cb cb);
@@ -464,6 +464,8 @@ int uv_fs_event_start(uv_fs_event_t* handle,
   handle->realpath = NULL;
   handle->realpath_len = 0;
   handle->cf_flags = flags;
+  if (flags & UV_FS_EVENT_MOUNT)
+    handle->cf_flags |= UV_FS_EVENT_RECURSIVE;
 
   if (!uv__has_forked_with_cfrunloop) {
     int r;
@@ -531,3 +533,8 @@ int uv_fs_event_stop(uv_fs_event_t* handle) {
 void uv__fs_event_close(uv_fs_event_t* handle) {
   uv_fs_event_stop(handle);
 }
+
+
+int uv_fs_event_set_coalesce(uv_fs_event_t* handle, unsigned int window) {
+  return UV_ENOSYS;
+}
@@ -30,16 +30,102 @@
 #include <errno.h>
 
 #include <sys/types.h>
+#include <sys/stat.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <limits.h>
 #include <unistd.h>
 
+/* Not every libc ships <sys/fanotify.h>, e.g. glibc < 2.13 and older Android
+ * NDKs. Without it UV_FS_EVENT_MOUNT uses the recursive inotify watcher.
+ */
+#if defined(__has_include)
+# if __has_include(<sys/fanotify.h>)
+#  define UV__HAVE_FANOTIFY_H 1
+# endif
+#elif defined(__GLIBC__)
+# if __GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 13)
+#  define UV__HAVE_FANOTIFY_H 1
+# endif
+#endif
+
+#if defined(UV__HAVE_FANOTIFY_H)
+# include <sys/fanotify.h>
+#endif
+
 struct watcher_list {
   RB_ENTRY(watcher_list) entry;
   QUEUE watchers;
+  QUEUE subdirs;
   int iterating;
   char* path;
   int wd;
 };
 
+/* A subdirectory that is watched on behalf of a UV_FS_EVENT_RECURSIVE handle.
+ * It's linked into the watcher_list of its inotify watch, which may be shared
+ * with other handles, and into the handle's list of subdirectories. Events in
+ * it are reported with `path` prepended.
+ */
+struct watcher_subdir {
+  QUEUE member;
+  QUEUE handle_member;
+  struct watcher_list* list;
+  uv_fs_event_t* handle;
+  char* path;  /* Relative to handle->path. */
+};
+
+/* Events for one path that are waiting for the coalescing window to end. */
+struct coalesce_entry {
+  QUEUE member;
+  struct coalesce_entry* next;  /* Hash chain. */
+  unsigned int hash;
+  int events;
+  char path[1];  /* Variable length. */
+};
+
+/* Enabled with uv_fs_event_set_coalesce(). Outlives the handle until the
+ * timer is closed.
+ */
+struct coalesce_ctx {
+  uv_fs_event_t* handle;  /* NULL once the handle is closed. */
+  uv_timer_t timer;
+  unsigned int window;
+  QUEUE pending;
+  struct coalesce_entry** buckets;
+  unsigned int nbuckets;
+  unsigned int count;
+};
+
+/* A UV_FS_EVENT_MOUNT handle that is backed by fanotify. Events for the
+ * whole file system are read from one fanotify group, only the ones below
+ * `realpath` are reported.
+ */
+struct fanotify_ctx {
+  uv_fs_event_t* handle;
+  uv__io_t watcher;
+  int mount_fd;  /* For open_by_handle_at(). */
+  int iterating;
+  int stopped;
+  char* path;  /* As passed to uv_fs_event_start(). */
+  char* realpath;
+  size_t realpath_len;
+  /* The directory of the last event, most events come in runs. */
+  unsigned char* cached_handle;
+  size_t cached_handle_len;
+  char* cached_path;
+};
+
+/* The state of a handle that watches a tree, coalesces events or watches a
+ * whole mount. It's allocated by the first of those features that is used,
+ * see fs_event_fields_get().
+ */
+struct fs_event_fields {
+  QUEUE subdirs;  /* struct watcher_subdir, by handle_member. */
+  struct coalesce_ctx* coalesce;
+  struct fanotify_ctx* fanotify;
+};
+
 struct watcher_root {
   struct watcher_list* rbh_root;
 };
@@ -64,6 +150,39 @@ static void uv__inotify_read(uv_loop_t* loop,
 static void maybe_free_watcher_list(struct watcher_list* w,
                                     uv_loop_t* loop);
 
+static int watch_subtree(uv_fs_event_t* handle, const char* path);
+
+static void deliver_event(uv_fs_event_t* handle, const char* path, int events);
+
+static void coalesce_drop(struct coalesce_ctx* ctx);
+
+static void unwatch_subtree(uv_fs_event_t* handle, const char* path);
+
+static void fanotify_stop(uv_fs_event_t* handle);
+
+
+static struct fs_event_fields* fs_event_fields(uv_fs_event_t* handle) {
+  return uv__handle_internal_fields(handle);
+}
+
+
+static struct fs_event_fields* fs_event_fields_get(uv_fs_event_t* handle) {
+  struct fs_event_fields* fields;
+
+  fields = fs_event_fields(handle);
+  if (fields != NULL)
+    return fields;
+
+  fields = uv__calloc(1, sizeof(*fields));
+  if (fields == NULL)
+    return NULL;
+
+  QUEUE_INIT(&fields->subdirs);
+  uv__handle_internal_fields(handle) = fields;
+
+  return fields;
+}
+
 static int new_inotify_fd(void) {
   int err;
   int fd;
@@ -119,6 +238,7 @@ int uv__inotify_fork(uv_loop_t* loop, void* old_watchers) {
   QUEUE queue;
   QUEUE* q;
   uv_fs_event_t* handle;
+  unsigned int flags;
   char* tmp_path;
 
   if (old_watchers != NULL) {
@@ -130,12 +250,14 @@ int uv__inotify_fork(uv_loop_t* loop, void* old_watchers) {
     QUEUE_INIT(&tmp_watcher_list.watchers);
     /* Note that the queue we use is shared with the start and stop()
      * functions, making QUEUE_FOREACH unsafe to use. So we use the
-     * QUEUE_MOVE trick to safely iterate. Also don't free the watcher
-     * list until we're done iterating. c.f. uv__inotify_read.
+     * QUEUE_MOVE trick to safely iterate. Also don't free any watcher
+     * list until we're done iterating, stopping a recursive handle drops
+     * subdirectory watches from other lists. c.f. uv__inotify_read.
      */
-    RB_FOREACH_SAFE(watcher_list, watcher_root,
-                    CAST(&old_watchers), tmp_watcher_list_iter) {
+    RB_FOREACH(watcher_list, watcher_root, CAST(&old_watchers))
       watcher_list->iterating = 1;
+
+    RB_FOREACH(watcher_list, watcher_root, CAST(&old_watchers)) {
       QUEUE_MOVE(&watcher_list->watchers, &queue);
       while (!QUEUE_EMPTY(&queue)) {
         q = QUEUE_HEAD(&queue);
@@ -153,6 +275,10 @@ int uv__inotify_fork(uv_loop_t* loop, void* old_watchers) {
         QUEUE_INSERT_TAIL(&tmp_watcher_list.watchers, &handle->watchers);
         handle->path = tmp_path;
       }
+    }
+
+    RB_FOREACH_SAFE(watcher_list, watcher_root,
+                    CAST(&old_watchers), tmp_watcher_list_iter) {
       watcher_list->iterating = 0;
       maybe_free_watcher_list(watcher_list, loop);
     }
@@ -164,7 +290,10 @@ int uv__inotify_fork(uv_loop_t* loop, void* old_watchers) {
         handle = QUEUE_DATA(q, uv_fs_event_t, watchers);
         tmp_path = handle->path;
         handle->path = NULL;
-        err = uv_fs_event_start(handle, handle->cb, tmp_path, 0);
+        flags = 0;
+        if (handle->flags & UV_HANDLE_FS_EVENT_RECURSIVE)
+          flags = UV_FS_EVENT_RECURSIVE;
+        err = uv_fs_event_start(handle, handle->cb, tmp_path, flags);
         uv__free(tmp_path);
         if (err)
           return err;
@@ -183,7 +312,9 @@ static struct watcher_list* find_watcher(uv_loop_t* loop, int wd) {
 
 static void maybe_free_watcher_list(struct watcher_list* w, uv_loop_t* loop) {
   /* if the watcher_list->watchers is being iterated over, we can't free it. */
-  if ((!w->iterating) && QUEUE_EMPTY(&w->watchers)) {
+  if ((!w->iterating) &&
+      QUEUE_EMPTY(&w->watchers) &&
+      QUEUE_EMPTY(&w->subdirs)) {
     /* No watchers left for this path. Clean up. */
     RB_REMOVE(watcher_root, CAST(&loop->inotify_watchers), w);
     uv__inotify_rm_watch(loop->inotify_fd, w->wd);
@@ -191,16 +322,301 @@ static void maybe_free_watcher_list(struct watcher_list* w, uv_loop_t* loop) {
   }
 }
 
+/* Returns `a` and `b` joined with a slash, or a copy of `b` if `a` is NULL. */
+static char* join_path(const char* a, const char* b) {
+  size_t alen;
+  size_t blen;
+  char* path;
+
+  if (a == NULL)
+    return uv__strdup(b);
+
+  alen = strlen(a);
+  blen = strlen(b) + 1;
+  path = uv__malloc(alen + 1 + blen);
+  if (path == NULL)
+    return NULL;
+
+  memcpy(path, a, alen);
+  path[alen] = '/';
+  memcpy(path + alen + 1, b, blen);
+
+  return path;
+}
+
+
+/* Adds an inotify watch for `path`. The watcher_list is shared by everything
+ * that watches the same inode.
+ */
+static int add_watch(uv_loop_t* loop,
+                     const char* path,
+                     int events,
+                     struct watcher_list** result) {
+  struct watcher_list* w;
+  size_t len;
+  int wd;
+
+  wd = uv__inotify_add_watch(loop->inotify_fd, path, events);
+  if (wd == -1)
+    return UV__ERR(errno);
+
+  w = find_watcher(loop, wd);
+  if (w == NULL) {
+    len = strlen(path) + 1;
+    w = uv__malloc(sizeof(*w) + len);
+    if (w == NULL)
+      return UV_ENOMEM;
+
+    w->wd = wd;
+    w->path = memcpy(w + 1, path, len);
+    QUEUE_INIT(&w->watchers);
+    QUEUE_INIT(&w->subdirs);
+    w->iterating = 0;
+    RB_INSERT(watcher_root, CAST(&loop->inotify_watchers), w);
+  }
+
+  *result = w;
+  return 0;
+}
+
+
+static int watches_dir(uv_fs_event_t* handle, struct watcher_list* w) {
+  struct watcher_subdir* s;
+  QUEUE* q;
+
+  if (handle->wd == w->wd)
+    return 1;
+
+  QUEUE_FOREACH(q, &w->subdirs) {
+    s = QUEUE_DATA(q, struct watcher_subdir, member);
+    if (s->handle == handle)
+      return 1;
+  }
+
+  return 0;
+}
+
+
+/* Starts watching `path`, a directory below handle->path. Directories that
+ * vanished or that can't be read are skipped.
+ */
+static int watch_subdir(uv_fs_event_t* handle, const char* path) {
+  struct watcher_subdir* s;
+  struct watcher_list* w;
+  char* abspath;
+  size_t len;
+  int err;
+
+  abspath = join_path(handle->path, path);
+  if (abspath == NULL)
+    return UV_ENOMEM;
+
+  err = add_watch(handle->loop,
+                  abspath,
+                  UV__IN_ATTRIB
+                  | UV__IN_CREATE
+                  | UV__IN_MODIFY
+                  | UV__IN_DELETE
+                  | UV__IN_DELETE_SELF
+                  | UV__IN_MOVE_SELF
+                  | UV__IN_MOVED_FROM
+                  | UV__IN_MOVED_TO
+                  | UV__IN_ONLYDIR
+                  | UV__IN_DONT_FOLLOW,
+                  &w);
+  uv__free(abspath);
+
+  if (err == UV_ENOENT || err == UV_ENOTDIR || err == UV_EACCES)
+    return 0;
+
+  if (err)
+    return err;
+
+  /* Bind mounts can make a directory show up more than once. */
+  if (watches_dir(handle, w))
+    return 0;
+
+  len = strlen(path) + 1;
+  s = uv__malloc(sizeof(*s) + len);
+  if (s == NULL) {
+    maybe_free_watcher_list(w, handle->loop);
+    return UV_ENOMEM;
+  }
+
+  s->list = w;
+  s->handle = handle;
+  s->path = memcpy(s + 1, path, len);
+  QUEUE_INSERT_TAIL(&w->subdirs, &s->member);
+  QUEUE_INSERT_TAIL(&fs_event_fields(handle)->subdirs, &s->handle_member);
+
+  return 0;
+}
+
+
+/* Adds watches for the subdirectories of `path`, which is relative to
+ * handle->path or NULL for handle->path itself.
+ */
+static int scan_dir(uv_fs_event_t* handle, const char* path) {
+  struct dirent* ent;
+  struct stat st;
+  char* abspath;
+  char* subpath;
+  DIR* dir;
+  int isdir;
+  int err;
+
+  if (path == NULL)
+    abspath = uv__strdup(handle->path);
+  else
+    abspath = join_path(handle->path, path);
+  if (abspath == NULL)
+    return UV_ENOMEM;
+
+  dir = opendir(abspath);
+  if (dir == NULL) {
+    err = UV__ERR(errno);
+    uv__free(abspath);
+    if (err == UV_ENOENT || err == UV_ENOTDIR || err == UV_EACCES)
+      return 0;
+    return err;
+  }
+
+  err = 0;
+  while (err == 0 && (ent = readdir(dir)) != NULL) {
+    if (strcmp(ent->d_name, ".") == 0 || strcmp(ent->d_name, "..") == 0)
+      continue;
+
+#if defined(DT_DIR)
+    isdir = ent->d_type == DT_DIR;
+    if (ent->d_type != DT_UNKNOWN)
+      goto known;
+#endif
+
+    subpath = join_path(abspath, ent->d_name);
+    if (subpath == NULL) {
+      err = UV_ENOMEM;
+      break;
+    }
+    isdir = lstat(subpath, &st) == 0 && S_ISDIR(st.st_mode);
+    uv__free(subpath);
+
+#if defined(DT_DIR)
+known:
+#endif
+    if (!isdir)
+      continue;
+
+    subpath = join_path(path, ent->d_name);
+    if (subpath == NULL) {
+      err = UV_ENOMEM;
+      break;
+    }
+    err = watch_subdir(handle, subpath);
+    uv__free(subpath);
+  }
+
+  closedir(dir);
+  uv__free(abspath);
+
+  return err;
+}
+
+
+/* Watches `path` and everything below it, breadth first. New subdirectories
+ * are appended to the handle's subdirs so the list doubles as the work queue.
+ */
+static int watch_subtree(uv_fs_event_t* handle, const char* path) {
+  struct watcher_subdir* s;
+  QUEUE* subdirs;
+  QUEUE* q;
+  int err;
+
+  subdirs = &fs_event_fields(handle)->subdirs;
+  q = QUEUE_PREV(subdirs);
+
+  if (path == NULL)
+    err = scan_dir(handle, NULL);
+  else
+    err = watch_subdir(handle, path);
+
+  while (err == 0 && (q = QUEUE_NEXT(q)) != subdirs) {
+    s = QUEUE_DATA(q, struct watcher_subdir, handle_member);
+    err = scan_dir(handle, s->path);
+  }
+
+  return err;
+}
+
+
+/* Stops watching `path` and everything below it, or all subdirectories when
+ * `path` is NULL.
+ */
+static void unwatch_subtree(uv_fs_event_t* handle, const char* path) {
+  struct fs_event_fields* fields;
+  struct watcher_subdir* s;
+  size_t len;
+  QUEUE* next;
+  QUEUE* q;
+
+  fields = fs_event_fields(handle);
+  if (fields == NULL)
+    return;
+
+  len = path == NULL ? 0 : strlen(path);
+
+  for (q = QUEUE_HEAD(&fields->subdirs); q != &fields->subdirs; q = next) {
+    next = QUEUE_NEXT(q);
+    s = QUEUE_DATA(q, struct watcher_subdir, handle_member);
+
+    if (path != NULL) {
+      if (strncmp(s->path, path, len) != 0)
+        continue;
+      if (s->path[len] != '\0' && s->path[len] != '/')
+        continue;
+    }
+
+    QUEUE_REMOVE(&s->member);
+    QUEUE_REMOVE(&s->handle_member);
+    maybe_free_watcher_list(s->list, handle->loop);
+    uv__free(s);
+  }
+}
+
+
+/* Keeps the set of watched subdirectories of a recursive handle in sync with
+ * directories being created, moved or removed below it. Returns an error if
+ * a new directory couldn't be watched, e.g. UV_ENOSPC when max_user_watches
+ * is exhausted.
+ */
+static int update_subtree(uv_fs_event_t* handle,
+                          const char* path,
+                          uint32_t mask) {
+  if (!(mask & UV__IN_ISDIR))
+    return 0;
+
+  if (mask & (UV__IN_DELETE | UV__IN_MOVED_FROM))
+    unwatch_subtree(handle, path);
+
+  if (mask & (UV__IN_CREATE | UV__IN_MOVED_TO))
+    return watch_subtree(handle, path);
+
+  return 0;
+}
+
+
 static void uv__inotify_read(uv_loop_t* loop,
                              uv__io_t* dummy,
                              unsigned int events) {
   const struct uv__inotify_event* e;
+  struct watcher_subdir* s;
   struct watcher_list* w;
   uv_fs_event_t* h;
   QUEUE queue;
   QUEUE* q;
   const char* path;
+  char* subpath;
   ssize_t size;
+  int err;
   const char *p;
   /* needs to be large enough for sizeof(inotify_event) + strlen(path) */
   char buf[4096];
@@ -257,8 +673,50 @@ static void uv__inotify_read(uv_loop_t* loop,
         QUEUE_REMOVE(q);
         QUEUE_INSERT_TAIL(&w->watchers, q);
 
-        h->cb(h, path, events, 0);
+        err = 0;
+        if (e->len && (h->flags & UV_HANDLE_FS_EVENT_RECURSIVE))
+          err = update_subtree(h, path, e->mask);
+
+        deliver_event(h, path, events);
+
+        if (err && uv__is_active(h))
+          h->cb(h, path, 0, err);
+      }
+
+      /* Recursive handles only get events about the entries of their
+       * subdirectories. Changes to a subdirectory itself are reported by the
+       * watch on its parent.
+       */
+      if (e->len == 0 || (e->mask & UV__IN_IGNORED))
+        QUEUE_INIT(&queue);
+      else
+        QUEUE_MOVE(&w->subdirs, &queue);
+
+      while (!QUEUE_EMPTY(&queue)) {
+        q = QUEUE_HEAD(&queue);
+        s = QUEUE_DATA(q, struct watcher_subdir, member);
+        h = s->handle;
+
+        QUEUE_REMOVE(q);
+        QUEUE_INSERT_TAIL(&w->subdirs, q);
+
+        subpath = join_path(s->path, path);
+        if (subpath == NULL) {
+          h->cb(h, s->path, 0, UV_ENOMEM);
+          continue;
+        }
+
+        /* `s` may be freed from here on. */
+        err = update_subtree(h, subpath, e->mask);
+
+        deliver_event(h, subpath, events);
+
+        if (err && uv__is_active(h))
+          h->cb(h, subpath, 0, err);
+
+        uv__free(subpath);
       }
+
       /* done iterating, time to (maybe) free empty watcher_list */
       w->iterating = 0;
       maybe_free_watcher_list(w, loop);
@@ -267,6 +725,492 @@ static void uv__inotify_read(uv_loop_t* loop,
 }
 
 
+static unsigned int coalesce_hash(const char* path) {
+  unsigned int h;
+
+  /* FNV-1a. */
+  for (h = 2166136261u; *path != '\0'; path++)
+    h = (h ^ (unsigned char) *path) * 16777619u;
+
+  return h;
+}
+
+
+static int coalesce_grow(struct coalesce_ctx* ctx) {
+  struct coalesce_entry** buckets;
+  struct coalesce_entry* e;
+  unsigned int nbuckets;
+  unsigned int i;
+  QUEUE* q;
+
+  nbuckets = ctx->nbuckets ? 2 * ctx->nbuckets : 16;
+  buckets = uv__calloc(nbuckets, sizeof(*buckets));
+  if (buckets == NULL)
+    return UV_ENOMEM;
+
+  QUEUE_FOREACH(q, &ctx->pending) {
+    e = QUEUE_DATA(q, struct coalesce_entry, member);
+    i = e->hash & (nbuckets - 1);
+    e->next = buckets[i];
+    buckets[i] = e;
+  }
+
+  uv__free(ctx->buckets);
+  ctx->buckets = buckets;
+  ctx->nbuckets = nbuckets;
+
+  return 0;
+}
+
+
+/* Delivers all pending events now. */
+static void coalesce_flush(struct coalesce_ctx* ctx) {
+  struct coalesce_entry* e;
+  uv_fs_event_t* handle;
+  QUEUE queue;
+  QUEUE* q;
+
+  handle = ctx->handle;
+
+  uv_timer_stop(&ctx->timer);
+  QUEUE_MOVE(&ctx->pending, &queue);
+  if (ctx->count > 0)
+    memset(ctx->buckets, 0, ctx->nbuckets * sizeof(*ctx->buckets));
+  ctx->count = 0;
+
+  /* The callback may stop or close the handle. Whatever is left is dropped
+   * then, like undelivered events of a stopped handle are.
+   */
+  while (!QUEUE_EMPTY(&queue)) {
+    q = QUEUE_HEAD(&queue);
+    QUEUE_REMOVE(q);
+    e = QUEUE_DATA(q, struct coalesce_entry, member);
+
+    if (ctx->handle == handle && uv__is_active(handle))
+      handle->cb(handle, e->path, e->events, 0);
+
+    uv__free(e);
+  }
+}
+
+
+static void coalesce_timer_cb(uv_timer_t* timer) {
+  coalesce_flush(container_of(timer, struct coalesce_ctx, timer));
+}
+
+
+static void coalesce_close_cb(uv_handle_t* timer) {
+  struct coalesce_ctx* ctx;
+
+  ctx = container_of(timer, struct coalesce_ctx, timer);
+  coalesce_drop(ctx);
+  uv__free(ctx->buckets);
+  uv__free(ctx);
+}
+
+
+/* Forgets all pending events. */
+static void coalesce_drop(struct coalesce_ctx* ctx) {
+  QUEUE* q;
+
+  uv_timer_stop(&ctx->timer);
+
+  while (!QUEUE_EMPTY(&ctx->pending)) {
+    q = QUEUE_HEAD(&ctx->pending);
+    QUEUE_REMOVE(q);
+    uv__free(QUEUE_DATA(q, struct coalesce_entry, member));
+  }
+
+  if (ctx->count > 0)
+    memset(ctx->buckets, 0, ctx->nbuckets * sizeof(*ctx->buckets));
+  ctx->count = 0;
+}
+
+
+/* Merges the event into the pending events for `path`. The window belongs to
+ * the handle, the first event that finds nothing pending starts it. Returns
+ * an error if the event has to be delivered right away instead.
+ */
+static int coalesce_add(struct coalesce_ctx* ctx,
+                        const char* path,
+                        int events) {
+  struct coalesce_entry* e;
+  unsigned int hash;
+  size_t len;
+  int err;
+
+  hash = coalesce_hash(path);
+
+  if (ctx->count > 0) {
+    for (e = ctx->buckets[hash & (ctx->nbuckets - 1)]; e != NULL; e = e->next) {
+      if (e->hash == hash && strcmp(e->path, path) == 0) {
+        e->events |= events;
+        return 0;
+      }
+    }
+  }
+
+  if (ctx->count >= ctx->nbuckets) {
+    err = coalesce_grow(ctx);
+    if (err)
+      return err;
+  }
+
+  len = strlen(path);
+  e = uv__malloc(sizeof(*e) + len);
+  if (e == NULL)
+    return UV_ENOMEM;
+
+  e->hash = hash;
+  e->events = events;
+  memcpy(e->path, path, len + 1);
+  e->next = ctx->buckets[hash & (ctx->nbuckets - 1)];
+  ctx->buckets[hash & (ctx->nbuckets - 1)] = e;
+  QUEUE_INSERT_TAIL(&ctx->pending, &e->member);
+
+  if (ctx->count++ == 0)
+    uv_timer_start(&ctx->timer, coalesce_timer_cb, ctx->window, 0);
+
+  return 0;
+}
+
+
+static void deliver_event(uv_fs_event_t* handle, const char* path, int events) {
+  struct fs_event_fields* fields;
+  struct coalesce_ctx* ctx;
+
+  fields = fs_event_fields(handle);
+  ctx = fields != NULL ? fields->coalesce : NULL;
+
+  /* Events without a path, like a queue overflow, can't be merged. They are
+   * delivered right away, after the events that came before them.
+   */
+  if (ctx != NULL && path == NULL && ctx->count > 0) {
+    coalesce_flush(ctx);
+    if (ctx->handle != handle || !uv__is_active(handle))
+      return;
+  }
+
+  if (ctx != NULL && ctx->window > 0 && path != NULL)
+    if (coalesce_add(ctx, path, events) == 0)
+      return;
+
+  handle->cb(handle, path, events, 0);
+}
+
+
+int uv_fs_event_set_coalesce(uv_fs_event_t* handle, unsigned int window) {
+  struct fs_event_fields* fields;
+  struct coalesce_ctx* ctx;
+  int err;
+
+  if (uv__is_closing(handle))
+    return UV_EINVAL;
+
+  fields = fs_event_fields(handle);
+  ctx = fields != NULL ? fields->coalesce : NULL;
+
+  if (ctx == NULL) {
+    if (window == 0)
+      return 0;
+
+    fields = fs_event_fields_get(handle);
+    if (fields == NULL)
+      return UV_ENOMEM;
+
+    ctx = uv__calloc(1, sizeof(*ctx));
+    if (ctx == NULL)
+      return UV_ENOMEM;
+
+    err = uv_timer_init(handle->loop, &ctx->timer);
+    if (err) {
+      uv__free(ctx);
+      return err;
+    }
+
+    ctx->timer.flags |= UV_HANDLE_INTERNAL;
+    uv__handle_unref(&ctx->timer);
+    ctx->handle = handle;
+    QUEUE_INIT(&ctx->pending);
+    fields->coalesce = ctx;
+  }
+
+  ctx->window = window;
+
+  /* Don't hold back events that are already pending any longer. */
+  if (window == 0 && ctx->count > 0)
+    uv_timer_start(&ctx->timer, coalesce_timer_cb, 0, 0);
+
+  return 0;
+}
+
+
+#if defined(FAN_REPORT_FID) && defined(FAN_MARK_FILESYSTEM)
+static void fanotify_clear_cache(struct fanotify_ctx* ctx) {
+  uv__free(ctx->cached_handle);
+  uv__free(ctx->cached_path);
+  ctx->cached_handle = NULL;
+  ctx->cached_handle_len = 0;
+  ctx->cached_path = NULL;
+}
+
+
+/* Returns the path of the object behind a file handle, relative to the
+ * watched path, or NULL if it's gone or outside of the watched path.
+ */
+static char* fanotify_resolve(struct fanotify_ctx* ctx,
+                              struct file_handle* fh,
+                              const char* name) {
+  char proc_path[32];
+  char buf[PATH_MAX];
+  const char* rel;
+  size_t fh_len;
+  ssize_t n;
+  int fd;
+
+  fh_len = sizeof(*fh) + fh->handle_bytes;
+
+  if (ctx->cached_handle != NULL &&
+      ctx->cached_handle_len == fh_len &&
+      memcmp(ctx->cached_handle, fh, fh_len) == 0) {
+    rel = ctx->cached_path;
+  } else {
+    fd = open_by_handle_at(ctx->mount_fd, fh, O_PATH | O_CLOEXEC);
+    if (fd == -1)
+      return NULL;
+
+    snprintf(proc_path, sizeof(proc_path), "/proc/self/fd/%d", fd);
+    n = readlink(proc_path, buf, sizeof(buf) - 1);
+    uv__close(fd);
+
+    if (n == -1)
+      return NULL;
+    buf[n] = '\0';
+
+    if (strncmp(buf, ctx->realpath, ctx->realpath_len) != 0)
+      return NULL;
+
+    rel = buf + ctx->realpath_len;
+    if (*rel == '/')
+      rel++;
+    else if (*rel != '\0' && ctx->realpath_len > 1)
+      return NULL;  /* E.g. /foo/barbaz when watching /foo/bar. */
+
+    fanotify_clear_cache(ctx);
+    ctx->cached_handle = uv__malloc(fh_len);
+    ctx->cached_path = uv__strdup(rel);
+    if (ctx->cached_handle == NULL || ctx->cached_path == NULL) {
+      fanotify_clear_cache(ctx);
+    } else {
+      memcpy(ctx->cached_handle, fh, fh_len);
+      ctx->cached_handle_len = fh_len;
+    }
+  }
+
+  if (name == NULL || *rel == '\0')
+    return uv__strdup(name != NULL ? name : rel);
+
+  return join_path(rel, name);
+}
+
+
+static void fanotify_read(uv_loop_t* loop, uv__io_t* w, unsigned int revents) {
+  const struct fanotify_event_metadata* e;
+  struct fanotify_event_info_fid* fid;
+  struct fanotify_ctx* ctx;
+  uv_fs_event_t* handle;
+  const char* name;
+  char* path;
+  ssize_t size;
+  int events;
+  /* Keep this large, many events are returned by a single read. */
+  char buf[16384];
+
+  ctx = container_of(w, struct fanotify_ctx, watcher);
+  handle = ctx->handle;
+
+  ctx->iterating = 1;
+
+  while (!ctx->stopped) {
+    do
+      size = read(w->fd, buf, sizeof(buf));
+    while (size == -1 && errno == EINTR);
+
+    if (size == -1) {
+      assert(errno == EAGAIN || errno == EWOULDBLOCK);
+      break;
+    }
+
+    for (e = (const struct fanotify_event_metadata*) buf;
+         FAN_EVENT_OK(e, size) && !ctx->stopped;
+         e = FAN_EVENT_NEXT(e, size)) {
+      if (e->vers != FANOTIFY_METADATA_VERSION)
+        continue;
+
+      if (e->mask & FAN_Q_OVERFLOW) {
+        /* Events were lost, tell the user to rescan. */
+        fanotify_clear_cache(ctx);
+        deliver_event(handle, NULL, UV_RENAME);
+        continue;
+      }
+
+      if (e->event_len < e->metadata_len + sizeof(*fid))
+        continue;
+
+      fid = (struct fanotify_event_info_fid*) ((char*) e + e->metadata_len);
+      name = NULL;
+#if defined(FAN_EVENT_INFO_TYPE_DFID_NAME)
+      if (fid->hdr.info_type == FAN_EVENT_INFO_TYPE_DFID_NAME) {
+        name = (const char*) fid->handle + sizeof(struct file_handle) +
+               ((struct file_handle*) fid->handle)->handle_bytes;
+        if (name[0] == '.' && name[1] == '\0')
+          name = NULL;
+      }
+#endif
+
+      path = fanotify_resolve(ctx, (struct file_handle*) fid->handle, name);
+
+      /* Directory renames and deletes change the paths below them. */
+      if ((e->mask & FAN_ONDIR) &&
+          (e->mask & (FAN_DELETE | FAN_MOVED_FROM | FAN_MOVED_TO))) {
+        fanotify_clear_cache(ctx);
+      }
+
+      if (path == NULL)
+        continue;
+
+      events = 0;
+      if (e->mask & FAN_MODIFY)
+        events |= UV_CHANGE;
+      if (e->mask & (FAN_CREATE | FAN_DELETE | FAN_MOVED_FROM | FAN_MOVED_TO))
+        events |= UV_RENAME;
+
+      deliver_event(handle, path, events);
+      uv__free(path);
+    }
+  }
+
+  ctx->iterating = 0;
+
+  if (ctx->stopped) {
+    fanotify_clear_cache(ctx);
+    uv__free(ctx);
+  }
+}
+
+
+static int fanotify_start(uv_fs_event_t* handle, const char* path) {
+  struct fs_event_fields* fields;
+  struct fanotify_ctx* ctx;
+  size_t len;
+  int err;
+  int fd;
+
+  fields = fs_event_fields_get(handle);
+  if (fields == NULL)
+    return UV_ENOMEM;
+
+  fd = -1;
+#if defined(FAN_REPORT_DFID_NAME)
+  fd = fanotify_init(FAN_CLASS_NOTIF | FAN_CLOEXEC | FAN_NONBLOCK |
+                         FAN_REPORT_DFID_NAME,
+                     O_RDONLY | O_CLOEXEC);
+#endif
+  /* Before Linux 5.9 there are no names, events in a directory are reported
+   * against the directory itself.
+   */
+  if (fd == -1)
+    fd = fanotify_init(FAN_CLASS_NOTIF | FAN_CLOEXEC | FAN_NONBLOCK |
+                           FAN_REPORT_FID,
+                       O_RDONLY | O_CLOEXEC);
+  if (fd == -1)
+    return UV__ERR(errno);
+
+  if (fanotify_mark(fd,
+                    FAN_MARK_ADD | FAN_MARK_FILESYSTEM,
+                    FAN_CREATE | FAN_DELETE | FAN_MODIFY |
+                        FAN_MOVED_FROM | FAN_MOVED_TO | FAN_ONDIR,
+                    AT_FDCWD,
+                    path)) {
+    err = UV__ERR(errno);
+    uv__close(fd);
+    return err;
+  }
+
+  len = strlen(path);
+  ctx = uv__calloc(1, sizeof(*ctx) + len + 1);
+  if (ctx == NULL) {
+    uv__close(fd);
+    return UV_ENOMEM;
+  }
+
+  ctx->path = (char*) (ctx + 1);
+  memcpy(ctx->path, path, len + 1);
+  ctx->handle = handle;
+
+  ctx->mount_fd = uv__open_cloexec(path, O_RDONLY);
+  if (ctx->mount_fd < 0) {
+    err = ctx->mount_fd;
+    goto fail;
+  }
+
+  ctx->realpath = realpath(path, NULL);
+  if (ctx->realpath == NULL) {
+    err = UV__ERR(errno);
+    goto fail;
+  }
+  ctx->realpath_len = strlen(ctx->realpath);
+
+  uv__io_init(&ctx->watcher, fanotify_read, fd);
+  uv__io_start(handle->loop, &ctx->watcher, POLLIN);
+  fields->fanotify = ctx;
+
+  return 0;
+
+fail:
+  if (ctx->mount_fd >= 0)
+    uv__close(ctx->mount_fd);
+  uv__close(fd);
+  uv__free(ctx);
+  return err;
+}
+
+
+static void fanotify_stop(uv_fs_event_t* handle) {
+  struct fs_event_fields* fields;
+  struct fanotify_ctx* ctx;
+
+  fields = fs_event_fields(handle);
+  ctx = fields->fanotify;
+  fields->fanotify = NULL;
+
+  uv__io_close(handle->loop, &ctx->watcher);
+  uv__close(ctx->watcher.fd);
+  uv__close(ctx->mount_fd);
+  free(ctx->realpath);  /* Allocated by realpath(). */
+  ctx->realpath = NULL;
+
+  /* fanotify_read() frees it when it's done. */
+  if (ctx->iterating) {
+    ctx->stopped = 1;
+    return;
+  }
+
+  fanotify_clear_cache(ctx);
+  uv__free(ctx);
+}
+#else
+static int fanotify_start(uv_fs_event_t* handle, const char* path) {
+  return UV_ENOSYS;
+}
+
+
+static void fanotify_stop(uv_fs_event_t* handle) {
+  assert(0 && "unreachable");
+}
+#endif  /* defined(FAN_REPORT_FID) && defined(FAN_MARK_FILESYSTEM) */
+
+
 int uv_fs_event_init(uv_loop_t* loop, uv_fs_event_t* handle) {
   uv__handle_init(loop, (uv_handle_t*)handle, UV_FS_EVENT);
   return 0;
@@ -278,14 +1222,33 @@ int uv_fs_event_start(uv_fs_event_t* handle,
                       const char* path,
                       unsigned int flags) {
   struct watcher_list* w;
-  size_t len;
   int events;
   int err;
-  int wd;
 
   if (uv__is_active(handle))
     return UV_EINVAL;
 
+  if (flags & (UV_FS_EVENT_RECURSIVE | UV_FS_EVENT_MOUNT))
+    if (fs_event_fields_get(handle) == NULL)
+      return UV_ENOMEM;
+
+  /* fanotify needs CAP_SYS_ADMIN and a file system that supports file
+   * handles. Fall back to watching the tree with inotify when it's not
+   * available.
+   */
+  if (flags & UV_FS_EVENT_MOUNT) {
+    if (fanotify_start(handle, path) == 0) {
+      uv__handle_start(handle);
+      handle->path = fs_event_fields(handle)->fanotify->path;
+      handle->cb = cb;
+      handle->wd = -1;
+      handle->flags &= ~UV_HANDLE_FS_EVENT_RECURSIVE;
+      return 0;
+    }
+
+    flags |= UV_FS_EVENT_RECURSIVE;
+  }
+
   err = init_inotify(handle->loop);
   if (err)
     return err;
@@ -299,45 +1262,53 @@ int uv_fs_event_start(uv_fs_event_t* handle,
          | UV__IN_MOVED_FROM
          | UV__IN_MOVED_TO;
 
-  wd = uv__inotify_add_watch(handle->loop->inotify_fd, path, events);
-  if (wd == -1)
-    return UV__ERR(errno);
-
-  w = find_watcher(handle->loop, wd);
-  if (w)
-    goto no_insert;
-
-  len = strlen(path) + 1;
-  w = uv__malloc(sizeof(*w) + len);
-  if (w == NULL)
-    return UV_ENOMEM;
-
-  w->wd = wd;
-  w->path = memcpy(w + 1, path, len);
-  QUEUE_INIT(&w->watchers);
-  w->iterating = 0;
-  RB_INSERT(watcher_root, CAST(&handle->loop->inotify_watchers), w);
+  err = add_watch(handle->loop, path, events, &w);
+  if (err)
+    return err;
 
-no_insert:
   uv__handle_start(handle);
   QUEUE_INSERT_TAIL(&w->watchers, &handle->watchers);
   handle->path = w->path;
   handle->cb = cb;
-  handle->wd = wd;
+  handle->wd = w->wd;
+  handle->flags &= ~UV_HANDLE_FS_EVENT_RECURSIVE;
+
+  if (flags & UV_FS_EVENT_RECURSIVE) {
+    handle->flags |= UV_HANDLE_FS_EVENT_RECURSIVE;
+    err = watch_subtree(handle, NULL);
+    if (err) {
+      uv_fs_event_stop(handle);
+      return err;
+    }
+  }
 
   return 0;
 }
 
 
 int uv_fs_event_stop(uv_fs_event_t* handle) {
+  struct fs_event_fields* fields;
   struct watcher_list* w;
 
   if (!uv__is_active(handle))
     return 0;
 
+  fields = fs_event_fields(handle);
+  if (fields != NULL && fields->coalesce != NULL)
+    coalesce_drop(fields->coalesce);
+
+  if (fields != NULL && fields->fanotify != NULL) {
+    fanotify_stop(handle);
+    handle->path = NULL;
+    uv__handle_stop(handle);
+    return 0;
+  }
+
   w = find_watcher(handle->loop, handle->wd);
   assert(w != NULL);
 
+  unwatch_subtree(handle, NULL);
+
   handle->wd = -1;
   handle->path = NULL;
   uv__handle_stop(handle);
@@ -350,5 +1321,21 @@ int uv_fs_event_stop(uv_fs_event_t* handle) {
 
 
 void uv__fs_event_close(uv_fs_event_t* handle) {
+  struct fs_event_fields* fields;
+  struct coalesce_ctx* ctx;
+
   uv_fs_event_stop(handle);
+
+  fields = fs_event_fields(handle);
+  if (fields == NULL)
+    return;
+
+  ctx = fields->coalesce;
+  if (ctx != NULL) {
+    ctx->handle = NULL;
+    uv_close((uv_handle_t*) &ctx->timer, coalesce_close_cb);
+  }
+
+  uv__free(fields);
+  uv__handle_internal_fields(handle) = NULL;
 }
@@ -79,6 +79,10 @@
 #define UV__IN_DELETE         0x200
 #define UV__IN_DELETE_SELF    0x400
 #define UV__IN_MOVE_SELF      0x800
+#define UV__IN_IGNORED        0x8000
+#define UV__IN_ONLYDIR        0x1000000
+#define UV__IN_DONT_FOLLOW    0x2000000
+#define UV__IN_ISDIR          0x40000000
 
 struct uv__statx_timestamp {
   int64_t tv_sec;
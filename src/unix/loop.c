@@ -28,6 +28,7 @@
 #include <unistd.h>
 
 int uv_loop_init(uv_loop_t* loop) {
+  uv__loop_internal_fields_t* lfields;
   void* saved_data;
   int err;
 
@@ -36,6 +37,11 @@ int uv_loop_init(uv_loop_t* loop) {
   memset(loop, 0, sizeof(*loop));
   loop->data = saved_data;
 
+  lfields = uv__calloc(1, sizeof(*lfields));
+  if (lfields == NULL)
+    return UV_ENOMEM;
+  loop->internal_fields = lfields;
+
   heap_init((struct heap*) &loop->timer_heap);
   QUEUE_INIT(&loop->wq);
   QUEUE_INIT(&loop->idle_handles);
@@ -43,6 +49,9 @@ int uv_loop_init(uv_loop_t* loop) {
   QUEUE_INIT(&loop->check_handles);
   QUEUE_INIT(&loop->prepare_handles);
   QUEUE_INIT(&loop->handle_queue);
+  QUEUE_INIT(&lfields->fs_sync_groups);
+  QUEUE_INIT(&lfields->fs_write_queues);
+  QUEUE_INIT(&lfields->corked_handles);
 
   loop->active_handles = 0;
   loop->active_reqs.count = 0;
@@ -66,7 +75,7 @@ int uv_loop_init(uv_loop_t* loop) {
 
   err = uv__platform_loop_init(loop);
   if (err)
-    return err;
+    goto fail_platform_init;
 
   uv__signal_global_once_init();
   err = uv_signal_init(loop, &loop->child_watcher);
@@ -106,6 +115,10 @@ fail_rwlock_init:
 fail_signal_init:
   uv__platform_loop_delete(loop);
 
+fail_platform_init:
+  uv__free(lfields);
+  loop->internal_fields = NULL;
+
   return err;
 }
 
@@ -144,6 +157,8 @@ int uv_loop_fork(uv_loop_t* loop) {
 
 
 void uv__loop_close(uv_loop_t* loop) {
+  uv__loop_internal_fields_t* lfields;
+
   uv__signal_loop_cleanup(loop);
   uv__platform_loop_delete(loop);
   uv__async_stop(loop);
@@ -158,6 +173,11 @@ void uv__loop_close(uv_loop_t* loop) {
     loop->backend_fd = -1;
   }
 
+  lfields = uv__get_internal_fields(loop);
+  assert(QUEUE_EMPTY(&lfields->fs_sync_groups));
+  assert(QUEUE_EMPTY(&lfields->fs_write_queues));
+  assert(QUEUE_EMPTY(&lfields->corked_handles));
+
   uv_mutex_lock(&loop->wq_mutex);
   assert(QUEUE_EMPTY(&loop->wq) && "thread pool work queue not empty!");
   assert(!uv__has_active_reqs(loop));
@@ -179,10 +199,24 @@ void uv__loop_close(uv_loop_t* loop) {
   uv__free(loop->watchers);
   loop->watchers = NULL;
   loop->nwatchers = 0;
+
+  uv__free(lfields->read_pool);
+  uv__free(lfields);
+  loop->internal_fields = NULL;
 }
 
 
 int uv__loop_configure(uv_loop_t* loop, uv_loop_option option, va_list ap) {
+  if (option == UV_LOOP_FS_GROUP_COMMIT) {
+    loop->flags |= UV_LOOP_GROUP_COMMIT;
+    return 0;
+  }
+
+  if (option == UV_LOOP_FS_COALESCE_WRITES) {
+    loop->flags |= UV_LOOP_COALESCE_WRITES;
+    return 0;
+  }
+
   if (option != UV_LOOP_BLOCK_SIGNAL)
     return UV_ENOSYS;
 
@@ -699,6 +699,11 @@ void uv__fs_event_close(uv_fs_event_t* handle) {
 }
 
 
+int uv_fs_event_set_coalesce(uv_fs_event_t* handle, unsigned int window) {
+  return UV_ENOSYS;
+}
+
+
 int uv_fs_event_init(uv_loop_t* loop, uv_fs_event_t* handle) {
   uv__handle_init(loop, (uv_handle_t*)handle, UV_FS_EVENT);
   return 0;
@@ -74,12 +74,89 @@ struct uv__stream_select_s {
     (errno == EAGAIN || errno == EWOULDBLOCK || errno == ENOBUFS)
 #endif /* defined(__APPLE__) */
 
+#if defined(__linux__)
+# include <sys/sendfile.h>
+#endif
+
+#if defined(__linux__) && defined(SO_ZEROCOPY) && defined(MSG_ZEROCOPY)
+# include <linux/errqueue.h>
+# define UV__STREAM_ZEROCOPY 1
+# ifndef SO_EE_ORIGIN_ZEROCOPY
+#  define SO_EE_ORIGIN_ZEROCOPY 5
+# endif
+# ifndef SO_EE_CODE_ZEROCOPY_COPIED
+#  define SO_EE_CODE_ZEROCOPY_COPIED 1
+# endif
+#endif
+
+/* Upper bound on the number of buffers, across queued write requests, that
+ * uv__write() hands to a single writev() call.
+ */
+#define UV__WRITE_GATHER_MAX 256
+
+/* Upper bound on the number of connections that uv__server_io() hands to a
+ * uv_connection_batch_cb in one call.
+ */
+#define UV__ACCEPT_BATCH_MAX 64
+
+/* Size of the loop-owned buffer that uv_read_start_pooled() reads into. */
+#define UV__READ_POOL_SIZE (64 * 1024)
+
+/* Zero-copy writes smaller than this are copied anyway. Pinning the pages and
+ * waiting for the completion notification costs more than the copy does.
+ */
+#define UV__ZEROCOPY_MIN (10 * 1024)
+
+#if defined(UV__STREAM_ZEROCOPY)
+typedef struct {
+  QUEUE queue;  /* Written requests that the kernel still has pages of. */
+  unsigned int next_seq;
+  int enabled;
+} uv__stream_zerocopy_t;
+#endif
+
+/* The part of a uv_write_t that only zero-copy and file writes use. Plain
+ * writes don't have it, see uv__req_internal_fields().
+ */
+typedef struct {
+  int zerocopy;
+  unsigned int zerocopy_seq;
+  unsigned int zerocopy_sends;
+  unsigned int zerocopy_done;
+  uv_file file;
+  int64_t file_offset;
+} uv__write_internal_fields_t;
+
+#define uv__write_internal_fields(req)                                        \
+  ((uv__write_internal_fields_t*) uv__req_internal_fields(req))
+
 static void uv__stream_connect(uv_stream_t*);
 static void uv__write(uv_stream_t* stream);
+static void uv__write_req_finish(uv_write_t* req);
 static void uv__read(uv_stream_t* stream);
 static void uv__stream_io(uv_loop_t* loop, uv__io_t* w, unsigned int events);
 static void uv__write_callbacks(uv_stream_t* stream);
 static size_t uv__write_req_size(uv_write_t* req);
+#if defined(__linux__)
+static void uv__stream_splice_stop(uv_stream_pipe_t* req);
+static void uv__stream_splice_finish(uv_stream_pipe_t* req, int status);
+
+/* The uv_stream_pipe_t that reads from or writes to the stream, if any. */
+static uv_stream_pipe_t* uv__stream_splice_src(uv_stream_t* stream) {
+  uv__stream_internal_fields_t* fields;
+
+  fields = uv__stream_internal_fields(stream);
+  return fields != NULL ? fields->splice_src : NULL;
+}
+
+
+static uv_stream_pipe_t* uv__stream_splice_dst(uv_stream_t* stream) {
+  uv__stream_internal_fields_t* fields;
+
+  fields = uv__stream_internal_fields(stream);
+  return fields != NULL ? fields->splice_dst : NULL;
+}
+#endif
 
 
 void uv__stream_init(uv_loop_t* loop,
@@ -455,7 +532,65 @@ void uv__stream_flush_write_queue(uv_stream_t* stream, int error) {
 }
 
 
+#if defined(UV__STREAM_ZEROCOPY)
+/* Cancels the requests that are still waiting for zero-copy notifications.
+ * The socket is gone and with it the error queue that would have reported
+ * them, but the kernel can still be sending from their buffers while the
+ * connection lingers. They fail with UV_ECANCELED so the user doesn't take
+ * that as a sign that the buffers are free.
+ */
+static void uv__stream_zerocopy_flush(uv_stream_t* stream) {
+  uv__stream_internal_fields_t* fields;
+  uv__stream_zerocopy_t* zc;
+  uv_write_t* req;
+  QUEUE* q;
+
+  fields = uv__stream_internal_fields(stream);
+  if (fields == NULL || fields->zerocopy == NULL)
+    return;
+
+  zc = fields->zerocopy;
+
+  while (!QUEUE_EMPTY(&zc->queue)) {
+    q = QUEUE_HEAD(&zc->queue);
+    QUEUE_REMOVE(q);
+
+    req = QUEUE_DATA(q, uv_write_t, queue);
+    if (req->error == 0)
+      req->error = UV_ECANCELED;
+
+    QUEUE_INSERT_TAIL(&stream->write_completed_queue, &req->queue);
+  }
+
+  uv__free(zc);
+  fields->zerocopy = NULL;
+}
+#endif
+
+
+uv__stream_internal_fields_t* uv__stream_internal_fields_get(
+    uv_stream_t* stream) {
+  uv__stream_internal_fields_t* fields;
+
+  fields = uv__stream_internal_fields(stream);
+  if (fields != NULL)
+    return fields;
+
+  fields = uv__calloc(1, sizeof(*fields));
+  if (fields == NULL)
+    return NULL;
+
+  fields->stream = stream;
+  QUEUE_INIT(&fields->cork_queue);
+  uv__handle_internal_fields(stream) = fields;
+
+  return fields;
+}
+
+
 void uv__stream_destroy(uv_stream_t* stream) {
+  uv__stream_internal_fields_t* fields;
+
   assert(!uv__io_active(&stream->io_watcher, POLLIN | POLLOUT));
   assert(stream->flags & UV_HANDLE_CLOSED);
 
@@ -465,6 +600,16 @@ void uv__stream_destroy(uv_stream_t* stream) {
     stream->connect_req = NULL;
   }
 
+#if defined(__linux__)
+  if (uv__stream_splice_src(stream) != NULL)
+    uv__stream_splice_finish(uv__stream_splice_src(stream), UV_ECANCELED);
+  if (uv__stream_splice_dst(stream) != NULL)
+    uv__stream_splice_finish(uv__stream_splice_dst(stream), UV_ECANCELED);
+#endif
+
+#if defined(UV__STREAM_ZEROCOPY)
+  uv__stream_zerocopy_flush(stream);
+#endif
   uv__stream_flush_write_queue(stream, UV_ECANCELED);
   uv__write_callbacks(stream);
 
@@ -480,6 +625,12 @@ void uv__stream_destroy(uv_stream_t* stream) {
   }
 
   assert(stream->write_queue_size == 0);
+
+  fields = uv__stream_internal_fields(stream);
+  if (fields != NULL)
+    uv__free(fields->stats);
+  uv__free(fields);
+  uv__handle_internal_fields(stream) = NULL;
 }
 
 
@@ -525,8 +676,82 @@ static int uv__emfile_trick(uv_loop_t* loop, int accept_fd) {
 #endif /* defined(UV_HAVE_KQUEUE) */
 
 
+/* Accepts connections for a server started with uv_listen_batch() and hands
+ * them to the callback in groups of up to UV__ACCEPT_BATCH_MAX.
+ */
+static void uv__server_io_batch(uv_loop_t* loop,
+                                uv__io_t* w,
+                                uv_stream_t* stream) {
+  uv__stream_internal_fields_t* fields;
+  uv_os_fd_t fds[UV__ACCEPT_BATCH_MAX];
+  unsigned int accepted;
+  unsigned int max;
+  unsigned int n;
+  int err;
+
+  fields = uv__stream_internal_fields(stream);
+  accepted = 0;
+
+  while (uv__stream_fd(stream) != -1) {
+    max = ARRAY_SIZE(fds);
+    if (fields->accept_budget != 0 &&
+        fields->accept_budget - accepted < max) {
+      max = fields->accept_budget - accepted;
+    }
+
+    n = 0;
+    err = 0;
+    while (n < max && err == 0) {
+#if defined(UV_HAVE_KQUEUE)
+      if (w->rcount <= 0) {
+        err = UV_EAGAIN;
+        break;
+      }
+#endif /* defined(UV_HAVE_KQUEUE) */
+
+      err = uv__accept(uv__stream_fd(stream));
+      if (err >= 0) {
+        UV_DEC_BACKLOG(w)
+        fds[n++] = err;
+        err = 0;
+      } else if (err == UV_ECONNABORTED) {
+        err = 0;  /* Ignore. Nothing we can do about that. */
+      }
+    }
+
+    /* Hand over what was accepted before reporting an error. */
+    if (n > 0) {
+      accepted += n;
+      fields->connection_batch_cb(stream, fds, n, 0);
+      if (uv__stream_fd(stream) == -1)
+        return;  /* connection_batch_cb closed the server. */
+    }
+
+    if (err == UV_EAGAIN || err == UV__ERR(EWOULDBLOCK))
+      return;  /* Not an error. */
+
+    if (err == UV_EMFILE || err == UV_ENFILE) {
+      err = uv__emfile_trick(loop, uv__stream_fd(stream));
+      if (err == UV_EAGAIN || err == UV__ERR(EWOULDBLOCK))
+        return;
+    }
+
+    if (err != 0) {
+      fields->connection_batch_cb(stream, NULL, 0, err);
+      continue;
+    }
+
+    if (fields->accept_budget != 0 && accepted == fields->accept_budget)
+      return;  /* The rest waits for the next loop iteration. */
+  }
+}
+
+
 void uv__server_io(uv_loop_t* loop, uv__io_t* w, unsigned int events) {
+  uv__stream_internal_fields_t* fields;
   uv_stream_t* stream;
+  unsigned int accepted;
+  unsigned int budget;
   int err;
 
   stream = container_of(w, uv_stream_t, io_watcher);
@@ -536,6 +761,15 @@ void uv__server_io(uv_loop_t* loop, uv__io_t* w, unsigned int events) {
 
   uv__io_start(stream->loop, &stream->io_watcher, POLLIN);
 
+  fields = uv__stream_internal_fields(stream);
+  if (fields != NULL && fields->connection_batch_cb != NULL) {
+    uv__server_io_batch(loop, w, stream);
+    return;
+  }
+
+  budget = fields != NULL ? fields->accept_budget : 0;
+  accepted = 0;
+
   /* connection_cb can close the server socket while we're
    * in the loop so check it on each iteration.
    */
@@ -581,6 +815,13 @@ void uv__server_io(uv_loop_t* loop, uv__io_t* w, unsigned int events) {
       struct timespec timeout = { 0, 1 };
       nanosleep(&timeout, NULL);
     }
+
+    /* Leave the rest for the next loop iteration. Epoll and kqueue report
+     * the listen socket again right away, but established connections get
+     * their turn first.
+     */
+    if (budget != 0 && ++accepted == budget)
+      return;
   }
 }
 
@@ -676,6 +917,46 @@ int uv_listen(uv_stream_t* stream, int backlog, uv_connection_cb cb) {
 }
 
 
+int uv_listen_batch(uv_stream_t* stream,
+                    int backlog,
+                    uv_connection_batch_cb cb) {
+  uv__stream_internal_fields_t* fields;
+  int err;
+
+  if (cb == NULL)
+    return UV_EINVAL;
+
+  fields = uv__stream_internal_fields_get(stream);
+  if (fields == NULL)
+    return UV_ENOMEM;
+
+  err = uv_listen(stream, backlog, NULL);
+  if (err == 0)
+    fields->connection_batch_cb = cb;
+
+  return err;
+}
+
+
+int uv_stream_set_accept_budget(uv_stream_t* stream, unsigned int budget) {
+  uv__stream_internal_fields_t* fields;
+
+  if (stream->type != UV_TCP && stream->type != UV_NAMED_PIPE)
+    return UV_EINVAL;
+
+  fields = uv__stream_internal_fields(stream);
+  if (fields == NULL && budget == 0)
+    return 0;  /* Nothing to undo. */
+
+  fields = uv__stream_internal_fields_get(stream);
+  if (fields == NULL)
+    return UV_ENOMEM;
+
+  fields->accept_budget = budget;
+  return 0;
+}
+
+
 static void uv__drain(uv_stream_t* stream) {
   uv_shutdown_t* req;
   int err;
@@ -737,12 +1018,24 @@ static size_t uv__write_req_size(uv_write_t* req) {
 static int uv__write_req_update(uv_stream_t* stream,
                                 uv_write_t* req,
                                 size_t n) {
+  uv__write_internal_fields_t* wfields;
   uv_buf_t* buf;
   size_t len;
 
   assert(n <= stream->write_queue_size);
   stream->write_queue_size -= n;
 
+  wfields = uv__write_internal_fields(req);
+  if (wfields != NULL && wfields->file != -1) {
+    /* A file segment, see uv_stream_sendfile(). Its single buffer has no
+     * memory behind it, only the length that is left to send.
+     */
+    wfields->file_offset += n;
+    req->bufs[0].len -= n;
+    req->write_index = (req->bufs[0].len == 0);
+    return req->write_index == req->nbufs;
+  }
+
   buf = req->bufs + req->write_index;
 
   do {
@@ -759,12 +1052,73 @@ static int uv__write_req_update(uv_stream_t* stream,
 }
 
 
+/* Consumes `n` bytes written from a gathered batch of requests, see
+ * uv__write_gather(). Returns 1 if it ended on a request boundary, or 0 if
+ * the head request is still partially unwritten.
+ */
+static int uv__write_queue_update(uv_stream_t* stream, size_t n) {
+  uv_write_t* req;
+  size_t size;
+
+  while (!QUEUE_EMPTY(&stream->write_queue)) {
+    req = QUEUE_DATA(QUEUE_HEAD(&stream->write_queue), uv_write_t, queue);
+    size = uv__write_req_size(req);
+
+    if (n < size) {
+      if (n > 0)
+        uv__write_req_update(stream, req, n);
+      return 0;
+    }
+
+    stream->write_queue_size -= size;
+    req->write_index = req->nbufs;
+    n -= size;
+    uv__write_req_finish(req);
+
+    if (n == 0)
+      break;
+  }
+
+  assert(n == 0);
+  return 1;
+}
+
+
+/* Accounts for the first `n` bytes of `req` that uv__tcp_connect_fastopen()
+ * sent along with the SYN. The request stays queued even when that was all
+ * of it, completing it now would make uv__stream_io() look at the socket
+ * before the handshake is done. uv__write() completes it once the
+ * connection is up.
+ */
+void uv__stream_fastopen_sent(uv_write_t* req, size_t n) {
+  if (n > 0)
+    uv__write_req_update(req->handle, req, n);
+}
+
+
 static void uv__write_req_finish(uv_write_t* req) {
   uv_stream_t* stream = req->handle;
+#if defined(UV__STREAM_ZEROCOPY)
+  uv__write_internal_fields_t* wfields = uv__write_internal_fields(req);
+#endif
 
   /* Pop the req off tcp->write_queue. */
   QUEUE_REMOVE(&req->queue);
 
+#if defined(UV__STREAM_ZEROCOPY)
+  /* The kernel still references the buffers of a zero-copy write, also when
+   * a later send failed. Park the request until the error queue says it's
+   * done with them. The watcher must stay registered for that, POLLERR is
+   * only reported for fds that are in the epoll set.
+   */
+  if (wfields != NULL && wfields->zerocopy_done != wfields->zerocopy_sends) {
+    uv__stream_zerocopy_t* zc = uv__stream_internal_fields(stream)->zerocopy;
+    QUEUE_INSERT_TAIL(&zc->queue, &req->queue);
+    uv__io_start(stream->loop, &stream->io_watcher, UV__POLLPRI);
+    return;
+  }
+#endif
+
   /* Only free when there was no error. On error, we touch up write_queue_size
    * right before making the callback. The reason we don't do that right away
    * is that a write_queue_size > 0 is our only way to signal to the user that
@@ -799,10 +1153,212 @@ static int uv__handle_fd(uv_handle_t* handle) {
   }
 }
 
+/* Collects the unwritten buffers of consecutive queued requests, starting
+ * with the head, into `iov`. A request that passes a handle, asks for
+ * zero-copy or sends from a file ends the batch, it needs a system call of
+ * its own. Returns the number of iovecs.
+ */
+static int uv__write_gather(uv_stream_t* stream, struct iovec* iov, int max) {
+  uv_write_t* req;
+  unsigned int i;
+  QUEUE* q;
+  int n;
+
+  n = 0;
+  QUEUE_FOREACH(q, &stream->write_queue) {
+    req = QUEUE_DATA(q, uv_write_t, queue);
+    if (req->send_handle != NULL || uv__write_internal_fields(req) != NULL)
+      break;
+
+    for (i = req->write_index; i < req->nbufs; i++) {
+      if (n == max)
+        return n;
+      iov[n].iov_base = req->bufs[i].base;
+      iov[n].iov_len = req->bufs[i].len;
+      n++;
+    }
+  }
+
+  return n;
+}
+
+
+#if defined(UV__STREAM_ZEROCOPY)
+static int uv__stream_zerocopy_init(uv_stream_t* stream) {
+  uv__stream_internal_fields_t* fields;
+  uv__stream_zerocopy_t* zc;
+  int on;
+
+  fields = uv__stream_internal_fields_get(stream);
+  if (fields == NULL)
+    return UV_ENOMEM;
+
+  zc = fields->zerocopy;
+  if (zc == NULL) {
+    zc = uv__malloc(sizeof(*zc));
+    if (zc == NULL)
+      return UV_ENOMEM;
+
+    /* Kernels without SO_ZEROCOPY fail here. Remember that and don't retry. */
+    on = 1;
+    zc->enabled = 0 == setsockopt(uv__stream_fd(stream),
+                                  SOL_SOCKET,
+                                  SO_ZEROCOPY,
+                                  &on,
+                                  sizeof(on));
+    zc->next_seq = 0;
+    QUEUE_INIT(&zc->queue);
+    fields->zerocopy = zc;
+  }
+
+  return zc->enabled ? 0 : UV_ENOTSUP;
+}
+
+
+static ssize_t uv__stream_zerocopy_send(uv_stream_t* stream,
+                                        uv_write_t* req,
+                                        struct iovec* iov,
+                                        int iovcnt) {
+  uv__write_internal_fields_t* wfields;
+  uv__stream_zerocopy_t* zc;
+  struct msghdr msg;
+  ssize_t n;
+
+  zc = uv__stream_internal_fields(stream)->zerocopy;
+  if (!zc->enabled)
+    return uv__writev(uv__stream_fd(stream), iov, iovcnt);
+
+  memset(&msg, 0, sizeof(msg));
+  msg.msg_iov = iov;
+  msg.msg_iovlen = iovcnt;
+
+  n = sendmsg(uv__stream_fd(stream), &msg, MSG_ZEROCOPY);
+
+  /* Each successful send takes the next sequence number. The kernel reports
+   * completions as ranges of those, the sends of one request are contiguous.
+   */
+  if (n > 0) {
+    wfields = uv__write_internal_fields(req);
+    if (wfields->zerocopy_sends == 0)
+      wfields->zerocopy_seq = zc->next_seq;
+    wfields->zerocopy_sends++;
+    zc->next_seq++;
+  }
+
+  return n;
+}
+
+
+/* Accounts for the completed sends `lo` to `hi`, inclusive, that belong to
+ * `req`. Notifications can arrive out of order so count rather than assume
+ * that everything up to `hi` is done.
+ */
+static void uv__write_req_zerocopy_ack(uv_write_t* req,
+                                       unsigned int lo,
+                                       unsigned int hi) {
+  uv__write_internal_fields_t* wfields;
+  int first;
+  int last;
+
+  wfields = uv__write_internal_fields(req);
+  if (wfields == NULL || wfields->zerocopy_sends == 0)
+    return;
+
+  /* Sequence numbers wrap around, compare offsets from the first send. */
+  first = (int) (lo - wfields->zerocopy_seq);
+  last = (int) (hi - wfields->zerocopy_seq);
+
+  if (first < 0)
+    first = 0;
+  if (last >= (int) wfields->zerocopy_sends)
+    last = wfields->zerocopy_sends - 1;
+
+  if (last >= first)
+    wfields->zerocopy_done += last - first + 1;
+}
+
+
+static void uv__stream_zerocopy_reap(uv_stream_t* stream) {
+  uv__stream_zerocopy_t* zc;
+  struct sock_extended_err* serr;
+  struct cmsghdr* cmsg;
+  struct msghdr msg;
+  uv_write_t* req;
+  QUEUE* q;
+  ssize_t r;
+  union {
+    char data[CMSG_SPACE(sizeof(*serr) + sizeof(struct sockaddr_in6))];
+    struct cmsghdr alias;
+  } scratch;
+
+  zc = uv__stream_internal_fields(stream)->zerocopy;
+
+  for (;;) {
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_control = &scratch.alias;
+    msg.msg_controllen = sizeof(scratch.data);
+
+    do
+      r = recvmsg(uv__stream_fd(stream), &msg, MSG_ERRQUEUE);
+    while (r == -1 && errno == EINTR);
+
+    if (r == -1)
+      break;  /* EAGAIN, the error queue is empty. */
+
+    for (cmsg = CMSG_FIRSTHDR(&msg);
+         cmsg != NULL;
+         cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+      if (!(cmsg->cmsg_level == SOL_IP && cmsg->cmsg_type == IP_RECVERR) &&
+          !(cmsg->cmsg_level == SOL_IPV6 && cmsg->cmsg_type == IPV6_RECVERR))
+        continue;
+
+      serr = (struct sock_extended_err*) CMSG_DATA(cmsg);
+      if (serr->ee_errno != 0 || serr->ee_origin != SO_EE_ORIGIN_ZEROCOPY)
+        continue;
+
+      /* The kernel fell back to copying, e.g. because the route goes over
+       * loopback. It will keep doing that, stop paying for the pinning.
+       */
+      if (serr->ee_code & SO_EE_CODE_ZEROCOPY_COPIED)
+        zc->enabled = 0;
+
+      QUEUE_FOREACH(q, &zc->queue) {
+        req = QUEUE_DATA(q, uv_write_t, queue);
+        uv__write_req_zerocopy_ack(req, serr->ee_info, serr->ee_data);
+      }
+
+      /* The head of the write queue may be partially written. */
+      if (!QUEUE_EMPTY(&stream->write_queue)) {
+        q = QUEUE_HEAD(&stream->write_queue);
+        req = QUEUE_DATA(q, uv_write_t, queue);
+        uv__write_req_zerocopy_ack(req, serr->ee_info, serr->ee_data);
+      }
+    }
+  }
+
+  q = QUEUE_HEAD(&zc->queue);
+  while (q != &zc->queue) {
+    req = QUEUE_DATA(q, uv_write_t, queue);
+    q = QUEUE_NEXT(q);
+    if (uv__write_internal_fields(req)->zerocopy_done ==
+        uv__write_internal_fields(req)->zerocopy_sends) {
+      uv__write_req_finish(req);
+    }
+  }
+
+  if (QUEUE_EMPTY(&zc->queue))
+    uv__io_stop(stream->loop, &stream->io_watcher, UV__POLLPRI);
+}
+#endif
+
+
 static void uv__write(uv_stream_t* stream) {
+  struct iovec gather[UV__WRITE_GATHER_MAX];
+  uv__stream_stats_t* stats;
   struct iovec* iov;
   QUEUE* q;
   uv_write_t* req;
+  int gathered;
   int iovmax;
   int iovcnt;
   ssize_t n;
@@ -819,6 +1375,16 @@ start:
   req = QUEUE_DATA(q, uv_write_t, queue);
   assert(req->handle == stream);
 
+  /* Sent in full along with the SYN, see uv__stream_fastopen_sent(). */
+  if (req->write_index == req->nbufs) {
+    uv__write_req_finish(req);
+    goto start;
+  }
+
+  /* Held back until the end of the loop iteration, see uv__tcp_cork(). */
+  if (stream->type == UV_TCP && (stream->flags & UV_HANDLE_TCP_BATCH_WRITES))
+    uv__tcp_cork((uv_tcp_t*) stream);
+
   /*
    * Cast to iovec. We had to have our own uv_buf_t instead of iovec
    * because Windows's WSABUF is not an iovec.
@@ -833,6 +1399,23 @@ start:
   if (iovcnt > iovmax)
     iovcnt = iovmax;
 
+  /* Write the following requests along with this one when they fit, instead
+   * of spending a system call and a loop iteration on each of them.
+   */
+  gathered = 0;
+  if (req->send_handle == NULL &&
+      uv__write_internal_fields(req) == NULL &&
+      iovcnt < iovmax &&
+      iovcnt < (int) ARRAY_SIZE(gather) &&
+      QUEUE_NEXT(q) != &stream->write_queue) {
+    iovcnt = uv__write_gather(stream,
+                              gather,
+                              iovmax < (int) ARRAY_SIZE(gather) ?
+                                  iovmax : (int) ARRAY_SIZE(gather));
+    iov = gather;
+    gathered = 1;
+  }
+
   /*
    * Now do the actual writev. Note that we've been updating the pointers
    * inside the iov each time we write. So there is no need to offset it.
@@ -886,20 +1469,63 @@ start:
     /* Ensure the handle isn't sent again in case this is a partial write. */
     if (n >= 0)
       req->send_handle = NULL;
+#if defined(UV__STREAM_ZEROCOPY)
+  } else if (uv__write_internal_fields(req) != NULL &&
+             uv__write_internal_fields(req)->zerocopy) {
+    do
+      n = uv__stream_zerocopy_send(stream, req, iov, iovcnt);
+    while (n == -1 && RETRY_ON_WRITE_ERROR(errno));
+#endif
+#if defined(__linux__)
+  } else if (uv__write_internal_fields(req) != NULL &&
+             uv__write_internal_fields(req)->file != -1) {
+    uv__write_internal_fields_t* wfields;
+    off_t off;
+
+    if (req->bufs[0].len == 0) {
+      uv__write_req_finish(req);
+      return;
+    }
+
+    wfields = uv__write_internal_fields(req);
+    off = wfields->file_offset;
+    do
+      n = sendfile(uv__stream_fd(stream),
+                   wfields->file,
+                   &off,
+                   req->bufs[0].len);
+    while (n == -1 && RETRY_ON_WRITE_ERROR(errno));
+
+    /* The file ended before the segment did. */
+    if (n == 0) {
+      err = UV_EOF;
+      goto error;
+    }
+#endif
   } else {
     do
       n = uv__writev(uv__stream_fd(stream), iov, iovcnt);
     while (n == -1 && RETRY_ON_WRITE_ERROR(errno));
   }
 
+  stats = uv__stream_stats(stream);
+  if (stats != NULL) {
+    stats->write_calls++;
+    if (n > 0)
+      stats->bytes_written += n;
+  }
+
   if (n == -1 && !IS_TRANSIENT_WRITE_ERROR(errno, req->send_handle)) {
     err = UV__ERR(errno);
     goto error;
   }
 
-  if (n >= 0 && uv__write_req_update(stream, req, n)) {
+  if (gathered) {
+    if (n >= 0 && uv__write_queue_update(stream, n))
+      return;
+  } else if (n >= 0 && uv__write_req_update(stream, req, n)) {
     uv__write_req_finish(req);
-    return;  /* TODO(bnoordhuis) Start trying to write the next request. */
+    return;
   }
 
   /* If this is a blocking stream, try again. */
@@ -924,13 +1550,40 @@ error:
 }
 
 
+/* Tells the user when the write queue grows past the high watermark, and
+ * again when it has shrunk back to the low watermark.
+ */
+static void uv__stream_write_queue_check(uv_stream_t* stream) {
+  uv__stream_internal_fields_t* fields;
+
+  fields = uv__stream_internal_fields(stream);
+  if (fields == NULL || fields->write_queue_cb == NULL)
+    return;
+
+  if (stream->flags & UV_HANDLE_CLOSING)
+    return;
+
+  if (stream->flags & UV_HANDLE_WRITE_QUEUE_FULL) {
+    if (stream->write_queue_size <= fields->write_queue_low) {
+      stream->flags &= ~UV_HANDLE_WRITE_QUEUE_FULL;
+      fields->write_queue_cb(stream, 0);
+    }
+  } else if (stream->write_queue_size > fields->write_queue_high) {
+    stream->flags |= UV_HANDLE_WRITE_QUEUE_FULL;
+    fields->write_queue_cb(stream, 1);
+  }
+}
+
+
 static void uv__write_callbacks(uv_stream_t* stream) {
   uv_write_t* req;
   QUEUE* q;
   QUEUE pq;
 
-  if (QUEUE_EMPTY(&stream->write_completed_queue))
+  if (QUEUE_EMPTY(&stream->write_completed_queue)) {
+    uv__stream_write_queue_check(stream);
     return;
+  }
 
   QUEUE_MOVE(&stream->write_completed_queue, &pq);
 
@@ -948,10 +1601,15 @@ static void uv__write_callbacks(uv_stream_t* stream) {
       req->bufs = NULL;
     }
 
+    uv__free(uv__req_internal_fields(req));
+    uv__req_internal_fields(req) = NULL;
+
     /* NOTE: call callback AFTER freeing the request data. */
     if (req->cb)
       req->cb(req, req->error);
   }
+
+  uv__stream_write_queue_check(stream);
 }
 
 
@@ -1109,6 +1767,7 @@ static int uv__stream_recv_cmsg(uv_stream_t* stream, struct msghdr* msg) {
 #endif
 
 static void uv__read(uv_stream_t* stream) {
+  uv__stream_stats_t* stats;
   uv_buf_t buf;
   ssize_t nread;
   struct msghdr msg;
@@ -1167,6 +1826,13 @@ static void uv__read(uv_stream_t* stream) {
       while (nread < 0 && errno == EINTR);
     }
 
+    stats = uv__stream_stats(stream);
+    if (stats != NULL) {
+      stats->read_calls++;
+      if (nread > 0)
+        stats->bytes_read += nread;
+    }
+
     if (nread < 0) {
       /* Error */
       if (errno == EAGAIN || errno == EWOULDBLOCK) {
@@ -1263,6 +1929,11 @@ int uv_shutdown(uv_shutdown_t* req, uv_stream_t* stream, uv_shutdown_cb cb) {
     return UV_ENOTCONN;
   }
 
+#if defined(__linux__)
+  if (uv__stream_splice_dst(stream) != NULL)
+    return UV_EBUSY;
+#endif
+
   assert(uv__stream_fd(stream) >= 0);
 
   /* Initialize request */
@@ -1279,6 +1950,184 @@ int uv_shutdown(uv_shutdown_t* req, uv_stream_t* stream, uv_shutdown_cb cb) {
 }
 
 
+#if defined(__linux__)
+/* Upper bound on what a single splice() moves into the intermediate pipe.
+ * That's also the default capacity of a pipe.
+ */
+#define UV__SPLICE_SIZE (64 * 1024)
+
+/* Stops moving data and releases the intermediate pipe. Safe to call more
+ * than once, and after one of the streams has been closed.
+ */
+static void uv__stream_splice_stop(uv_stream_pipe_t* req) {
+  if (req->fds[0] == -1)
+    return;
+
+  if (uv__stream_fd(req->src) != -1)
+    uv__io_stop(req->src->loop, &req->src->io_watcher, POLLIN);
+
+  if (uv__stream_fd(req->dst) != -1)
+    uv__io_stop(req->dst->loop, &req->dst->io_watcher, POLLOUT);
+
+  uv__close(req->fds[0]);
+  uv__close(req->fds[1]);
+  req->fds[0] = -1;
+  req->fds[1] = -1;
+}
+
+
+static void uv__stream_splice_finish(uv_stream_pipe_t* req, int status) {
+  uv__stream_splice_stop(req);
+  uv__stream_internal_fields(req->src)->splice_src = NULL;
+  uv__stream_internal_fields(req->dst)->splice_dst = NULL;
+  uv__req_unregister(req->src->loop, req);
+
+  if (req->cb != NULL)
+    req->cb(req, status);
+}
+
+
+/* Moves data from the source to the destination through the intermediate
+ * pipe, without it ever passing through user space. Only one side is polled
+ * at a time: the source while the pipe is empty, the destination while the
+ * pipe holds data it didn't accept yet. That's what provides flow control.
+ */
+static void uv__stream_splice(uv_stream_pipe_t* req) {
+  uv__stream_stats_t* stats;
+  uv_stream_t* src;
+  uv_stream_t* dst;
+  uv_loop_t* loop;
+  ssize_t n;
+  int count;
+
+  if (req->fds[0] == -1)
+    return;  /* Stopped, one of the streams is closing. */
+
+  src = req->src;
+  dst = req->dst;
+  loop = src->loop;
+
+  /* Bound the work per wakeup, like uv__read() does. */
+  for (count = 32; count > 0; count--) {
+    while (req->buffered > 0) {
+      do
+        n = splice(req->fds[0],
+                   NULL,
+                   uv__stream_fd(dst),
+                   NULL,
+                   req->buffered,
+                   SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+      while (n == -1 && errno == EINTR);
+
+      stats = uv__stream_stats(dst);
+      if (stats != NULL) {
+        stats->write_calls++;
+        if (n > 0)
+          stats->bytes_written += n;
+      }
+
+      if (n == -1) {
+        if (errno != EAGAIN)
+          goto error;
+
+        uv__io_stop(loop, &src->io_watcher, POLLIN);
+        uv__io_start(loop, &dst->io_watcher, POLLOUT);
+        return;
+      }
+
+      req->buffered -= n;
+      req->nbytes += n;
+    }
+
+    if (src->flags & UV_HANDLE_READ_EOF) {
+      /* Propagate the half-close. A pipe that isn't a socket can't be shut
+       * down, it's up to the user to close it.
+       */
+      if (shutdown(uv__stream_fd(dst), SHUT_WR) && errno != ENOTSOCK)
+        goto error;
+
+      dst->flags |= UV_HANDLE_SHUT;
+      uv__stream_splice_finish(req, 0);
+      return;
+    }
+
+    do
+      n = splice(uv__stream_fd(src),
+                 NULL,
+                 req->fds[1],
+                 NULL,
+                 UV__SPLICE_SIZE,
+                 SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+    while (n == -1 && errno == EINTR);
+
+    stats = uv__stream_stats(src);
+    if (stats != NULL) {
+      stats->read_calls++;
+      if (n > 0)
+        stats->bytes_read += n;
+    }
+
+    if (n == -1) {
+      if (errno != EAGAIN)
+        goto error;
+
+      uv__io_stop(loop, &dst->io_watcher, POLLOUT);
+      uv__io_start(loop, &src->io_watcher, POLLIN);
+      return;
+    }
+
+    if (n == 0)
+      src->flags |= UV_HANDLE_READ_EOF;
+
+    req->buffered += n;
+  }
+
+  /* Out of budget, continue on the next loop iteration. */
+  if (req->buffered > 0) {
+    uv__io_stop(loop, &src->io_watcher, POLLIN);
+    uv__io_start(loop, &dst->io_watcher, POLLOUT);
+  } else {
+    uv__io_stop(loop, &dst->io_watcher, POLLOUT);
+    uv__io_start(loop, &src->io_watcher, POLLIN);
+  }
+
+  return;
+
+error:
+  uv__stream_splice_finish(req, UV__ERR(errno));
+}
+
+
+/* I/O handler for streams that take part in a splice. The direction that is
+ * being spliced belongs to the uv_stream_pipe_t, the other one still works
+ * as usual.
+ */
+static void uv__stream_splice_io(uv_stream_t* stream, unsigned int events) {
+  if (events & (POLLIN | POLLERR | POLLHUP)) {
+    if (uv__stream_splice_src(stream) != NULL)
+      uv__stream_splice(uv__stream_splice_src(stream));
+    else
+      uv__read(stream);
+  }
+
+  if (uv__stream_fd(stream) == -1)
+    return;  /* Callback closed stream. */
+
+  if (events & (POLLOUT | POLLERR | POLLHUP)) {
+    if (uv__stream_splice_dst(stream) != NULL) {
+      uv__stream_splice(uv__stream_splice_dst(stream));
+    } else {
+      uv__write(stream);
+      uv__write_callbacks(stream);
+
+      if (QUEUE_EMPTY(&stream->write_queue))
+        uv__drain(stream);
+    }
+  }
+}
+#endif
+
+
 static void uv__stream_io(uv_loop_t* loop, uv__io_t* w, unsigned int events) {
   uv_stream_t* stream;
 
@@ -1296,6 +2145,22 @@ static void uv__stream_io(uv_loop_t* loop, uv__io_t* w, unsigned int events) {
 
   assert(uv__stream_fd(stream) >= 0);
 
+#if defined(UV__STREAM_ZEROCOPY)
+  /* Zero-copy completions are queued on the socket's error queue. */
+  if (uv__stream_internal_fields(stream) != NULL &&
+      uv__stream_internal_fields(stream)->zerocopy != NULL &&
+      (events & (POLLERR | UV__POLLPRI)))
+    uv__stream_zerocopy_reap(stream);
+#endif
+
+#if defined(__linux__)
+  if (uv__stream_splice_src(stream) != NULL ||
+      uv__stream_splice_dst(stream) != NULL) {
+    uv__stream_splice_io(stream, events);
+    return;
+  }
+#endif
+
   /* Ignore POLLHUP here. Even if it's set, there may still be data to read. */
   if (events & (POLLIN | POLLERR | POLLHUP))
     uv__read(stream);
@@ -1385,14 +2250,15 @@ static void uv__stream_connect(uv_stream_t* stream) {
 }
 
 
-int uv_write2(uv_write_t* req,
-              uv_stream_t* stream,
-              const uv_buf_t bufs[],
-              unsigned int nbufs,
-              uv_stream_t* send_handle,
-              uv_write_cb cb) {
-  int empty_queue;
-
+/* Validates and initializes a write request. The caller can then adjust it
+ * before handing it to uv__write_req_queue().
+ */
+static int uv__write_req_init(uv_write_t* req,
+                              uv_stream_t* stream,
+                              const uv_buf_t bufs[],
+                              unsigned int nbufs,
+                              uv_stream_t* send_handle,
+                              uv_write_cb cb) {
   assert(nbufs > 0);
   assert((stream->type == UV_TCP ||
           stream->type == UV_NAMED_PIPE ||
@@ -1405,6 +2271,11 @@ int uv_write2(uv_write_t* req,
   if (!(stream->flags & UV_HANDLE_WRITABLE))
     return -EPIPE;
 
+#if defined(__linux__)
+  if (uv__stream_splice_dst(stream) != NULL)
+    return UV_EBUSY;
+#endif
+
   if (send_handle) {
     if (stream->type != UV_NAMED_PIPE || !((uv_pipe_t*)stream)->ipc)
       return UV_EINVAL;
@@ -1425,14 +2296,6 @@ int uv_write2(uv_write_t* req,
 #endif
   }
 
-  /* It's legal for write_queue_size > 0 even when the write_queue is empty;
-   * it means there are error-state requests in the write_completed_queue that
-   * will touch up write_queue_size later, see also uv__write_req_finish().
-   * We could check that write_queue is empty instead but that implies making
-   * a write() syscall when we know that the handle is in error mode.
-   */
-  empty_queue = (stream->write_queue_size == 0);
-
   /* Initialize the req */
   uv__req_init(stream->loop, req, UV_WRITE);
   req->cb = cb;
@@ -1451,7 +2314,26 @@ int uv_write2(uv_write_t* req,
   memcpy(req->bufs, bufs, nbufs * sizeof(bufs[0]));
   req->nbufs = nbufs;
   req->write_index = 0;
-  stream->write_queue_size += uv__count_bufs(bufs, nbufs);
+
+  return 0;
+}
+
+
+static void uv__write_req_queue(uv_write_t* req) {
+  uv__stream_internal_fields_t* fields;
+  uv_stream_t* stream;
+  int empty_queue;
+
+  stream = req->handle;
+
+  /* It's legal for write_queue_size > 0 even when the write_queue is empty;
+   * it means there are error-state requests in the write_completed_queue that
+   * will touch up write_queue_size later, see also uv__write_req_finish().
+   * We could check that write_queue is empty instead but that implies making
+   * a write() syscall when we know that the handle is in error mode.
+   */
+  empty_queue = (stream->write_queue_size == 0);
+  stream->write_queue_size += uv__count_bufs(req->bufs, req->nbufs);
 
   /* Append the request to write_queue. */
   QUEUE_INSERT_TAIL(&stream->write_queue, &req->queue);
@@ -1477,6 +2359,33 @@ int uv_write2(uv_write_t* req,
     uv__stream_osx_interrupt_select(stream);
   }
 
+  /* Past the high watermark. The callback is made from the loop, not from
+   * inside uv_write().
+   */
+  fields = uv__stream_internal_fields(stream);
+  if (fields != NULL &&
+      fields->write_queue_cb != NULL &&
+      stream->connect_req == NULL &&
+      !(stream->flags & UV_HANDLE_WRITE_QUEUE_FULL) &&
+      stream->write_queue_size > fields->write_queue_high) {
+    uv__io_feed(stream->loop, &stream->io_watcher);
+  }
+}
+
+
+int uv_write2(uv_write_t* req,
+              uv_stream_t* stream,
+              const uv_buf_t bufs[],
+              unsigned int nbufs,
+              uv_stream_t* send_handle,
+              uv_write_cb cb) {
+  int err;
+
+  err = uv__write_req_init(req, stream, bufs, nbufs, send_handle, cb);
+  if (err)
+    return err;
+
+  uv__write_req_queue(req);
   return 0;
 }
 
@@ -1493,6 +2402,154 @@ int uv_write(uv_write_t* req,
 }
 
 
+int uv_write_zerocopy(uv_write_t* req,
+                      uv_stream_t* handle,
+                      const uv_buf_t bufs[],
+                      unsigned int nbufs,
+                      uv_write_cb cb) {
+#if defined(UV__STREAM_ZEROCOPY)
+  uv__write_internal_fields_t* wfields;
+#endif
+  int err;
+
+  err = uv__write_req_init(req, handle, bufs, nbufs, NULL, cb);
+  if (err)
+    return err;
+
+#if defined(UV__STREAM_ZEROCOPY)
+  /* Without the internal fields it's a plain write, zero-copy is a hint. */
+  if (handle->type == UV_TCP &&
+      uv__count_bufs(bufs, nbufs) >= UV__ZEROCOPY_MIN &&
+      uv__stream_zerocopy_init(handle) == 0) {
+    wfields = uv__calloc(1, sizeof(*wfields));
+    if (wfields != NULL) {
+      wfields->zerocopy = 1;
+      wfields->file = -1;
+      uv__req_internal_fields(req) = wfields;
+    }
+  }
+#endif
+
+  uv__write_req_queue(req);
+  return 0;
+}
+
+
+int uv_stream_sendfile(uv_write_t* req,
+                       uv_stream_t* handle,
+                       uv_file file,
+                       int64_t offset,
+                       size_t length,
+                       uv_write_cb cb) {
+#if defined(__linux__)
+  uv__write_internal_fields_t* wfields;
+  uv_buf_t buf;
+  int err;
+
+  if (file < 0)
+    return UV_EBADF;
+
+  if (offset < 0)
+    return UV_EINVAL;
+
+  wfields = uv__calloc(1, sizeof(*wfields));
+  if (wfields == NULL)
+    return UV_ENOMEM;
+
+  /* The segment stands in for a buffer. It has no memory behind it, only a
+   * length that uv__write() counts down as sendfile() makes progress.
+   */
+  buf.base = NULL;
+  buf.len = length;
+  err = uv__write_req_init(req, handle, &buf, 1, NULL, cb);
+  if (err) {
+    uv__free(wfields);
+    return err;
+  }
+
+  wfields->file = file;
+  wfields->file_offset = offset;
+  uv__req_internal_fields(req) = wfields;
+
+  uv__write_req_queue(req);
+  return 0;
+#else
+  return UV_ENOSYS;
+#endif
+}
+
+
+int uv_stream_pipe_to(uv_stream_pipe_t* req,
+                      uv_stream_t* src,
+                      uv_stream_t* dst,
+                      uv_stream_pipe_cb cb) {
+#if defined(__linux__)
+  uv__stream_internal_fields_t* src_fields;
+  uv__stream_internal_fields_t* dst_fields;
+  int err;
+
+  if (src == dst)
+    return UV_EINVAL;
+
+  if (src->type != UV_TCP && src->type != UV_NAMED_PIPE)
+    return UV_EINVAL;
+
+  if (dst->type != UV_TCP && dst->type != UV_NAMED_PIPE)
+    return UV_EINVAL;
+
+  /* Handles that come with the data would be lost. */
+  if (src->type == UV_NAMED_PIPE && ((uv_pipe_t*) src)->ipc)
+    return UV_EINVAL;
+
+  if (uv__stream_fd(src) < 0 || uv__stream_fd(dst) < 0)
+    return UV_EBADF;
+
+  if (uv__is_closing(src) || uv__is_closing(dst))
+    return UV_EBADF;
+
+  if (!(src->flags & UV_HANDLE_READABLE))
+    return UV_ENOTCONN;
+
+  if (!(dst->flags & UV_HANDLE_WRITABLE) ||
+      (dst->flags & (UV_HANDLE_SHUTTING | UV_HANDLE_SHUT)))
+    return UV_EPIPE;
+
+  /* Nothing else may read from the source or write to the destination. */
+  if ((src->flags & UV_HANDLE_READING) ||
+      uv__stream_splice_src(src) != NULL ||
+      uv__stream_splice_dst(dst) != NULL ||
+      dst->connect_req != NULL ||
+      dst->write_queue_size != 0)
+    return UV_EBUSY;
+
+  src_fields = uv__stream_internal_fields_get(src);
+  dst_fields = uv__stream_internal_fields_get(dst);
+  if (src_fields == NULL || dst_fields == NULL)
+    return UV_ENOMEM;
+
+  err = uv__make_pipe(req->fds, UV__F_NONBLOCK);
+  if (err)
+    return err;
+
+  uv__req_init(src->loop, req, UV_STREAM_PIPE);
+  req->src = src;
+  req->dst = dst;
+  req->nbytes = 0;
+  req->buffered = 0;
+  req->cb = cb;
+
+  src_fields->splice_src = req;
+  dst_fields->splice_dst = req;
+
+  uv__io_start(src->loop, &src->io_watcher, POLLIN);
+
+  return 0;
+#else
+  return UV_ENOSYS;
+#endif
+}
+
+
 void uv_try_write_cb(uv_write_t* req, int status) {
   /* Should not be called */
   abort();
@@ -1559,6 +2616,11 @@ int uv_read_start(uv_stream_t* stream,
   if (!(stream->flags & UV_HANDLE_READABLE))
     return -ENOTCONN;
 
+#if defined(__linux__)
+  if (uv__stream_splice_src(stream) != NULL)
+    return UV_EBUSY;
+#endif
+
   /* The UV_HANDLE_READING flag is irrelevant of the state of the tcp - it just
    * expresses the desired state of the user.
    */
@@ -1582,6 +2644,29 @@ int uv_read_start(uv_stream_t* stream,
 }
 
 
+/* Hands out the loop's read buffer. Reads are only borrowed for the duration
+ * of the read callback and callbacks don't nest, so a single buffer serves
+ * every stream on the loop. It's allocated on first use.
+ */
+static void uv__stream_pool_alloc(uv_handle_t* handle,
+                                  size_t suggested_size,
+                                  uv_buf_t* buf) {
+  uv__loop_internal_fields_t* lfields;
+
+  lfields = uv__get_internal_fields(handle->loop);
+  if (lfields->read_pool == NULL)
+    lfields->read_pool = uv__malloc(UV__READ_POOL_SIZE);
+
+  if (lfields->read_pool != NULL)
+    *buf = uv_buf_init(lfields->read_pool, UV__READ_POOL_SIZE);
+}
+
+
+int uv_read_start_pooled(uv_stream_t* stream, uv_read_cb read_cb) {
+  return uv_read_start(stream, uv__stream_pool_alloc, read_cb);
+}
+
+
 int uv_read_stop(uv_stream_t* stream) {
   if (!(stream->flags & UV_HANDLE_READING))
     return 0;
@@ -1650,6 +2735,13 @@ void uv__stream_close(uv_stream_t* handle) {
   }
 #endif /* defined(__APPLE__) */
 
+#if defined(__linux__)
+  if (uv__stream_splice_src(handle) != NULL)
+    uv__stream_splice_stop(uv__stream_splice_src(handle));
+  if (uv__stream_splice_dst(handle) != NULL)
+    uv__stream_splice_stop(uv__stream_splice_dst(handle));
+#endif
+
   uv__io_close(handle->loop, &handle->io_watcher);
   uv_read_stop(handle);
   uv__handle_stop(handle);
@@ -1680,6 +2772,35 @@ void uv__stream_close(uv_stream_t* handle) {
 }
 
 
+int uv_stream_set_write_queue_limits(uv_stream_t* stream,
+                                     size_t high,
+                                     size_t low,
+                                     uv_write_queue_cb cb) {
+  uv__stream_internal_fields_t* fields;
+
+  if (low > high)
+    return UV_EINVAL;
+
+  fields = uv__stream_internal_fields_get(stream);
+  if (fields == NULL)
+    return UV_ENOMEM;
+
+  fields->write_queue_high = high;
+  fields->write_queue_low = low;
+  fields->write_queue_cb = cb;
+  stream->flags &= ~UV_HANDLE_WRITE_QUEUE_FULL;
+
+  if (cb != NULL &&
+      stream->write_queue_size > high &&
+      stream->connect_req == NULL &&
+      uv__stream_fd(stream) >= 0) {
+    uv__io_feed(stream->loop, &stream->io_watcher);
+  }
+
+  return 0;
+}
+
+
 int uv_stream_set_blocking(uv_stream_t* handle, int blocking) {
   /* Don't need to check the file descriptor, uv__nonblock()
    * will fail with EBADF if it's not valid.
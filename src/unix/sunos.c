@@ -546,6 +546,11 @@ void uv__fs_event_close(uv_fs_event_t* handle) {
 #endif /* defined(PORT_SOURCE_FILE) */
 
 
+int uv_fs_event_set_coalesce(uv_fs_event_t* handle, unsigned int window) {
+  return UV_ENOSYS;
+}
+
+
 int uv_resident_set_memory(size_t* rss) {
   psinfo_t psinfo;
   int err;
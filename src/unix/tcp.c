@@ -164,6 +164,12 @@ int uv__tcp_bind(uv_tcp_t* tcp,
   if (setsockopt(tcp->io_watcher.fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on)))
     return UV__ERR(errno);
 
+  if (flags & UV_TCP_REUSEPORT) {
+    err = uv__sock_reuseport(tcp->io_watcher.fd);
+    if (err)
+      return err;
+  }
+
 #ifndef __OpenBSD__
 #ifdef IPV6_V6ONLY
   if (addr->sa_family == AF_INET6) {
@@ -201,6 +207,76 @@ int uv__tcp_bind(uv_tcp_t* tcp,
 }
 
 
+/* Deals with connect() failing. Returns 0 if the connection is on its way,
+ * or an error.
+ */
+static int uv__tcp_connect_errno(uv_tcp_t* handle) {
+  if (errno == EINPROGRESS)
+    ; /* not an error */
+  else if (errno == ECONNREFUSED
+#if defined(__OpenBSD__)
+    || errno == EINVAL
+#endif
+    )
+  /* If we get ECONNREFUSED (Solaris) or EINVAL (OpenBSD) wait until the
+   * next tick to report the error. Solaris and OpenBSD wants to report
+   * immediately -- other unixes want to wait.
+   */
+    handle->delayed_error = UV__ERR(ECONNREFUSED);
+  else
+    return UV__ERR(errno);
+
+  return 0;
+}
+
+
+static void uv__tcp_connect_wait(uv_connect_t* req,
+                                 uv_tcp_t* handle,
+                                 uv_connect_cb cb) {
+  uv__req_init(handle->loop, req, UV_CONNECT);
+  req->cb = cb;
+  req->handle = (uv_stream_t*) handle;
+  QUEUE_INIT(&req->queue);
+  handle->connect_req = req;
+
+  uv__io_start(handle->loop, &handle->io_watcher, POLLOUT);
+
+  if (handle->delayed_error)
+    uv__io_feed(handle->loop, &handle->io_watcher);
+}
+
+
+static void uv__tcp_connect_unwait(uv_tcp_t* handle) {
+  uv__req_unregister(handle->loop, handle->connect_req);
+  handle->connect_req = NULL;
+  uv__io_stop(handle->loop, &handle->io_watcher, POLLOUT);
+}
+
+
+/* A regular connect with the data queued behind it. */
+static int uv__tcp_connect_fastopen_fallback(uv_connect_t* req,
+                                             uv_tcp_t* handle,
+                                             const struct sockaddr* addr,
+                                             unsigned int addrlen,
+                                             uv_write_t* write_req,
+                                             const uv_buf_t bufs[],
+                                             unsigned int nbufs,
+                                             uv_connect_cb cb,
+                                             uv_write_cb write_cb) {
+  int err;
+
+  err = uv__tcp_connect(req, handle, addr, addrlen, cb);
+  if (err)
+    return err;
+
+  err = uv_write(write_req, (uv_stream_t*) handle, bufs, nbufs, write_cb);
+  if (err)
+    uv__tcp_connect_unwait(handle);
+
+  return err;
+}
+
+
 int uv__tcp_connect(uv_connect_t* req,
                     uv_tcp_t* handle,
                     const struct sockaddr* addr,
@@ -233,34 +309,113 @@ int uv__tcp_connect(uv_connect_t* req,
    * and actually the tcp three-way handshake is completed.
    */
   if (r == -1 && errno != 0) {
-    if (errno == EINPROGRESS)
-      ; /* not an error */
-    else if (errno == ECONNREFUSED
-#if defined(__OpenBSD__)
-      || errno == EINVAL
-#endif
-      )
-    /* If we get ECONNREFUSED (Solaris) or EINVAL (OpenBSD) wait until the
-     * next tick to report the error. Solaris and OpenBSD wants to report
-     * immediately -- other unixes want to wait.
-     */
-      handle->delayed_error = UV__ERR(ECONNREFUSED);
-    else
-      return UV__ERR(errno);
+    err = uv__tcp_connect_errno(handle);
+    if (err)
+      return err;
   }
 
-  uv__req_init(handle->loop, req, UV_CONNECT);
-  req->cb = cb;
-  req->handle = (uv_stream_t*) handle;
-  QUEUE_INIT(&req->queue);
-  handle->connect_req = req;
+  uv__tcp_connect_wait(req, handle, cb);
 
-  uv__io_start(handle->loop, &handle->io_watcher, POLLOUT);
+  return 0;
+}
 
-  if (handle->delayed_error)
-    uv__io_feed(handle->loop, &handle->io_watcher);
+
+int uv__tcp_connect_fastopen(uv_connect_t* req,
+                             uv_tcp_t* handle,
+                             const struct sockaddr* addr,
+                             unsigned int addrlen,
+                             uv_write_t* write_req,
+                             const uv_buf_t bufs[],
+                             unsigned int nbufs,
+                             uv_connect_cb cb,
+                             uv_write_cb write_cb) {
+#if defined(MSG_FASTOPEN)
+  uv__stream_stats_t* stats;
+  struct msghdr msg;
+  ssize_t n;
+  int err;
+
+  assert(handle->type == UV_TCP);
+
+  if (handle->connect_req != NULL)
+    return UV_EALREADY;
+
+  err = maybe_new_socket(handle,
+                         addr->sa_family,
+                         UV_HANDLE_READABLE | UV_HANDLE_WRITABLE);
+  if (err)
+    return err;
+
+  handle->delayed_error = 0;
+
+  /* Connect and send as much of the data as fits in the SYN. Without a
+   * cookie from an earlier connection to the server the SYN carries no data,
+   * it asks for a cookie instead and sendmsg() fails with EINPROGRESS.
+   */
+  memset(&msg, 0, sizeof(msg));
+  msg.msg_name = (struct sockaddr*) addr;
+  msg.msg_namelen = addrlen;
+  msg.msg_iov = (struct iovec*) bufs;
+  msg.msg_iovlen = nbufs;
+  if (msg.msg_iovlen > (size_t) uv__getiovmax())
+    msg.msg_iovlen = uv__getiovmax();
+
+  do
+    n = sendmsg(uv__stream_fd(handle), &msg, MSG_FASTOPEN);
+  while (n == -1 && errno == EINTR);
+
+  stats = uv__stream_stats(handle);
+  if (stats != NULL) {
+    stats->write_calls++;
+    if (n > 0)
+      stats->bytes_written += n;
+  }
+
+  if (n == -1) {
+    /* Fast Open is turned off for clients on this system. */
+    if (errno == EOPNOTSUPP)
+      return uv__tcp_connect_fastopen_fallback(req,
+                                               handle,
+                                               addr,
+                                               addrlen,
+                                               write_req,
+                                               bufs,
+                                               nbufs,
+                                               cb,
+                                               write_cb);
+
+    err = uv__tcp_connect_errno(handle);
+    if (err)
+      return err;
+
+    n = 0;
+  }
+
+  uv__tcp_connect_wait(req, handle, cb);
+
+  /* Queue what's left. uv_write() leaves the socket alone while the handle
+   * is connecting.
+   */
+  err = uv_write(write_req, (uv_stream_t*) handle, bufs, nbufs, write_cb);
+  if (err) {
+    uv__tcp_connect_unwait(handle);
+    return err;
+  }
+
+  uv__stream_fastopen_sent(write_req, n);
 
   return 0;
+#else
+  return uv__tcp_connect_fastopen_fallback(req,
+                                           handle,
+                                           addr,
+                                           addrlen,
+                                           write_req,
+                                           bufs,
+                                           nbufs,
+                                           cb,
+                                           write_cb);
+#endif
 }
 
 
@@ -324,6 +479,70 @@ int uv_tcp_getpeername(const uv_tcp_t* handle,
 }
 
 
+int uv_tcp_enable_stats(uv_tcp_t* handle) {
+#if defined(__linux__) && defined(TCP_INFO)
+  uv__stream_internal_fields_t* fields;
+
+  fields = uv__stream_internal_fields_get((uv_stream_t*) handle);
+  if (fields == NULL)
+    return UV_ENOMEM;
+
+  if (fields->stats == NULL) {
+    fields->stats = uv__calloc(1, sizeof(*fields->stats));
+    if (fields->stats == NULL)
+      return UV_ENOMEM;
+  }
+
+  return 0;
+#else
+  return UV_ENOTSUP;
+#endif
+}
+
+
+int uv_tcp_get_info(const uv_tcp_t* handle, uv_tcp_info_t* info) {
+#if defined(__linux__) && defined(TCP_INFO)
+  const uv__stream_stats_t* stats;
+  struct tcp_info ti;
+  socklen_t len;
+
+  memset(info, 0, sizeof(*info));
+
+  if (uv__stream_fd(handle) < 0)
+    return UV_EBADF;
+
+  /* The kernel copies no more than `len` bytes. Newer kernels have a much
+   * bigger struct tcp_info than the libc headers describe, asking for the
+   * fields we use only keeps sampling cheap.
+   */
+  len = sizeof(ti);
+  if (getsockopt(uv__stream_fd(handle), IPPROTO_TCP, TCP_INFO, &ti, &len))
+    return UV__ERR(errno);
+
+  info->rtt = ti.tcpi_rtt;
+  info->rtt_var = ti.tcpi_rttvar;
+  info->cwnd = (uint64_t) ti.tcpi_snd_cwnd * ti.tcpi_snd_mss;
+  info->mss = ti.tcpi_snd_mss;
+  info->bytes_in_flight = (uint64_t) ti.tcpi_unacked * ti.tcpi_snd_mss;
+  info->retransmits = ti.tcpi_total_retrans;
+
+  /* Zero unless uv_tcp_enable_stats() was called. */
+  stats = uv__stream_stats(handle);
+  if (stats != NULL) {
+    info->bytes_read = stats->bytes_read;
+    info->bytes_written = stats->bytes_written;
+    info->read_calls = stats->read_calls;
+    info->write_calls = stats->write_calls;
+  }
+
+  return 0;
+#else
+  memset(info, 0, sizeof(*info));
+  return UV_ENOTSUP;
+#endif
+}
+
+
 int uv_tcp_listen(uv_tcp_t* tcp, int backlog, uv_connection_cb cb) {
   static int single_accept = -1;
   unsigned long flags;
@@ -444,6 +663,114 @@ int uv_tcp_simultaneous_accepts(uv_tcp_t* handle, int enable) {
 }
 
 
+/* Holds back partial segments until uv__tcp_uncork_all() runs at the end of
+ * the loop iteration, so that small writes made from different callbacks go
+ * out together. Called by uv__write() for handles with batching enabled.
+ */
+void uv__tcp_cork(uv_tcp_t* handle) {
+#if defined(TCP_CORK)
+  uv__stream_internal_fields_t* fields;
+  int on;
+
+  /* Allocated by uv_tcp_batch_writes(). */
+  fields = uv__stream_internal_fields(handle);
+  if (!QUEUE_EMPTY(&fields->cork_queue))
+    return;  /* Already corked. */
+
+  on = 1;
+  if (setsockopt(uv__stream_fd(handle), IPPROTO_TCP, TCP_CORK, &on, sizeof(on)))
+    return;  /* Not fatal, the data just goes out unbatched. */
+
+  QUEUE_INSERT_TAIL(&uv__get_internal_fields(handle->loop)->corked_handles,
+                    &fields->cork_queue);
+#endif
+}
+
+
+static void uv__tcp_uncork(uv_tcp_t* handle) {
+#if defined(TCP_CORK)
+  uv__stream_internal_fields_t* fields;
+  int off;
+
+  fields = uv__stream_internal_fields(handle);
+  if (fields == NULL || QUEUE_EMPTY(&fields->cork_queue))
+    return;
+
+  QUEUE_REMOVE(&fields->cork_queue);
+  QUEUE_INIT(&fields->cork_queue);
+
+  /* Clearing TCP_CORK sends whatever is pending right away. */
+  off = 0;
+  setsockopt(uv__stream_fd(handle), IPPROTO_TCP, TCP_CORK, &off, sizeof(off));
+#endif
+}
+
+
+void uv__tcp_uncork_all(uv_loop_t* loop) {
+  uv__loop_internal_fields_t* lfields;
+  uv__stream_internal_fields_t* fields;
+  QUEUE* q;
+
+  lfields = uv__get_internal_fields(loop);
+  while (!QUEUE_EMPTY(&lfields->corked_handles)) {
+    q = QUEUE_HEAD(&lfields->corked_handles);
+    fields = QUEUE_DATA(q, uv__stream_internal_fields_t, cork_queue);
+    uv__tcp_uncork((uv_tcp_t*) fields->stream);
+  }
+}
+
+
+int uv_tcp_fastopen(uv_tcp_t* handle, int queue_len) {
+#if defined(TCP_FASTOPEN)
+  if (queue_len < 0)
+    return UV_EINVAL;
+
+  if (uv__stream_fd(handle) == -1)
+    return UV_EBADF;
+
+  if (setsockopt(uv__stream_fd(handle),
+                 IPPROTO_TCP,
+                 TCP_FASTOPEN,
+                 &queue_len,
+                 sizeof(queue_len))) {
+    return UV__ERR(errno);
+  }
+
+  return 0;
+#else
+  return UV_ENOTSUP;
+#endif
+}
+
+
+int uv_tcp_batch_writes(uv_tcp_t* handle, int enable) {
+#if defined(TCP_CORK)
+  if (enable) {
+    if (uv__stream_internal_fields_get((uv_stream_t*) handle) == NULL)
+      return UV_ENOMEM;
+
+    handle->flags |= UV_HANDLE_TCP_BATCH_WRITES;
+  } else {
+    handle->flags &= ~UV_HANDLE_TCP_BATCH_WRITES;
+    uv__tcp_uncork(handle);
+  }
+
+  return 0;
+#else
+  return UV_ENOTSUP;
+#endif
+}
+
+
 void uv__tcp_close(uv_tcp_t* handle) {
+  uv__stream_internal_fields_t* fields;
+
+  /* The kernel sends what's left when the socket is closed. */
+  fields = uv__stream_internal_fields(handle);
+  if (fields != NULL && !QUEUE_EMPTY(&fields->cork_queue)) {
+    QUEUE_REMOVE(&fields->cork_queue);
+    QUEUE_INIT(&fields->cork_queue);
+  }
+
   uv__stream_close((uv_stream_t*)handle);
 }
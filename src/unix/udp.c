@@ -39,6 +39,47 @@
 # define IPV6_DROP_MEMBERSHIP IPV6_LEAVE_GROUP
 #endif
 
+/* Largest datagram we receive, and the number of them read by one call to
+ * recvmmsg() on UV_UDP_RECVMMSG handles.
+ */
+#define UV__UDP_DGRAM_MAXSIZE (64 * 1024)
+#define UV__MMSG_MAXWIDTH 20
+
+#if defined(__linux__)
+# ifndef SOL_UDP
+#  define SOL_UDP 17
+# endif
+# ifndef UDP_SEGMENT
+#  define UDP_SEGMENT 103
+# endif
+# ifndef UDP_GRO
+#  define UDP_GRO 104
+# endif
+#endif
+
+/* Room for the control messages of one datagram: UDP_SEGMENT or UDP_GRO,
+ * a receive timestamp and a pktinfo.
+ */
+union uv__udp_ctrl {
+  char buf[CMSG_SPACE(sizeof(int)) +
+           CMSG_SPACE(sizeof(struct timespec)) +
+           CMSG_SPACE(sizeof(struct sockaddr_in6))];
+  struct cmsghdr align;
+};
+
+/* The part of a uv_udp_send_t that only uv_udp_send_gso() and
+ * uv_udp_send_from() requests use, see uv__req_internal_fields().
+ */
+typedef struct {
+  unsigned int gso_size;
+  size_t gso_offset;
+  struct sockaddr_in6 src_addr;
+  unsigned int src_ifindex;
+} uv__udp_send_internal_fields_t;
+
+#define uv__udp_send_internal_fields(req)                                     \
+  ((uv__udp_send_internal_fields_t*) uv__req_internal_fields(req))
+
 
 static void uv__udp_run_completed(uv_udp_t* handle);
 static void uv__udp_io(uv_loop_t* loop, uv__io_t* w, unsigned int revents);
@@ -81,6 +122,9 @@ void uv__udp_finish_close(uv_udp_t* handle) {
   assert(handle->send_queue_size == 0);
   assert(handle->send_queue_count == 0);
 
+  uv__free(uv__handle_internal_fields(handle));
+  uv__handle_internal_fields(handle) = NULL;
+
   /* Now tear down the handle. */
   handle->recv_cb = NULL;
   handle->alloc_cb = NULL;
@@ -109,6 +153,9 @@ static void uv__udp_run_completed(uv_udp_t* handle) {
       uv__free(req->bufs);
     req->bufs = NULL;
 
+    uv__free(uv__req_internal_fields(req));
+    uv__req_internal_fields(req) = NULL;
+
     if (req->send_cb == NULL)
       continue;
 
@@ -148,12 +195,219 @@ static void uv__udp_io(uv_loop_t* loop, uv__io_t* w, unsigned int revents) {
 }
 
 
+static void uv__udp_ctrl_prep(uv_udp_t* handle,
+                              struct msghdr* h,
+                              union uv__udp_ctrl* ctrl) {
+  if (handle->flags & (UV_HANDLE_UDP_GRO | UV_HANDLE_UDP_RECV_INFO)) {
+    h->msg_control = ctrl->buf;
+    h->msg_controllen = sizeof(ctrl->buf);
+  } else {
+    h->msg_control = NULL;
+    h->msg_controllen = 0;
+  }
+}
+
+
+/* Returns UV_UDP_GRO and the segment size for coalesced datagrams. */
+static unsigned int uv__udp_gro_flags(struct msghdr* h) {
+#if defined(__linux__)
+  struct cmsghdr* cmsg;
+  int size;
+
+  if (h->msg_controllen == 0)
+    return 0;
+
+  for (cmsg = CMSG_FIRSTHDR(h); cmsg != NULL; cmsg = CMSG_NXTHDR(h, cmsg)) {
+    if (cmsg->cmsg_level == SOL_UDP && cmsg->cmsg_type == UDP_GRO) {
+      memcpy(&size, CMSG_DATA(cmsg), sizeof(size));
+      if (size > 0 && size <= 0xFFFF)
+        return UV_UDP_GRO | ((unsigned int) size << 16);
+    }
+  }
+#endif
+
+  return 0;
+}
+
+
+/* Fills in the receive timestamp, destination address and interface from the
+ * control messages of `h`. IPv4 destinations of datagrams that arrived on a
+ * dual-stack socket are reported as IPv4-mapped IPv6 addresses, so they can
+ * be passed back to uv_udp_send_from() as they are.
+ */
+static void uv__udp_recv_info(struct msghdr* h,
+                              uv_udp_recv_info_t* info,
+                              struct sockaddr_storage* local) {
+  struct cmsghdr* cmsg;
+  struct sockaddr_in6* sin6;
+  struct sockaddr_in* sin;
+#if defined(SCM_TIMESTAMPNS)
+  struct timespec ts;
+#endif
+#if defined(SCM_TIMESTAMP)
+  struct timeval tv;
+#endif
+#if defined(IP_PKTINFO)
+  struct in_pktinfo pi;
+#endif
+#if defined(IPV6_PKTINFO)
+  struct in6_pktinfo pi6;
+#endif
+
+  if (h->msg_controllen == 0)
+    return;
+
+  sin = (struct sockaddr_in*) local;
+  sin6 = (struct sockaddr_in6*) local;
+
+  for (cmsg = CMSG_FIRSTHDR(h); cmsg != NULL; cmsg = CMSG_NXTHDR(h, cmsg)) {
+#if defined(SCM_TIMESTAMPNS)
+    if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_TIMESTAMPNS) {
+      memcpy(&ts, CMSG_DATA(cmsg), sizeof(ts));
+      info->timestamp = ts.tv_sec * (uint64_t) 1e9 + ts.tv_nsec;
+      continue;
+    }
+#endif
+#if defined(SCM_TIMESTAMP)
+    if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_TIMESTAMP) {
+      memcpy(&tv, CMSG_DATA(cmsg), sizeof(tv));
+      info->timestamp = tv.tv_sec * (uint64_t) 1e9 + tv.tv_usec * 1000;
+      continue;
+    }
+#endif
+#if defined(IP_PKTINFO)
+    if (cmsg->cmsg_level == IPPROTO_IP && cmsg->cmsg_type == IP_PKTINFO) {
+      memcpy(&pi, CMSG_DATA(cmsg), sizeof(pi));
+      memset(local, 0, sizeof(*local));
+      if (info->addr != NULL && info->addr->sa_family == AF_INET6) {
+        sin6->sin6_family = AF_INET6;
+        sin6->sin6_addr.s6_addr[10] = 0xFF;
+        sin6->sin6_addr.s6_addr[11] = 0xFF;
+        memcpy(sin6->sin6_addr.s6_addr + 12, &pi.ipi_addr, 4);
+      } else {
+        sin->sin_family = AF_INET;
+        sin->sin_addr = pi.ipi_addr;
+      }
+      info->local_addr = (const struct sockaddr*) local;
+      info->ifindex = pi.ipi_ifindex;
+      continue;
+    }
+#endif
+#if defined(IPV6_PKTINFO)
+    if (cmsg->cmsg_level == IPPROTO_IPV6 && cmsg->cmsg_type == IPV6_PKTINFO) {
+      memcpy(&pi6, CMSG_DATA(cmsg), sizeof(pi6));
+      memset(local, 0, sizeof(*local));
+      sin6->sin6_family = AF_INET6;
+      sin6->sin6_addr = pi6.ipi6_addr;
+      if (IN6_IS_ADDR_LINKLOCAL(&pi6.ipi6_addr))
+        sin6->sin6_scope_id = pi6.ipi6_ifindex;
+      info->local_addr = (const struct sockaddr*) local;
+      info->ifindex = pi6.ipi6_ifindex;
+      continue;
+    }
+#endif
+  }
+}
+
+
+/* Hands a datagram to the extended callback when ancillary data was
+ * requested with uv_udp_recv_start_ex(), to the regular one otherwise.
+ */
+static void uv__udp_recv_deliver(uv_udp_t* handle,
+                                 ssize_t nread,
+                                 const uv_buf_t* buf,
+                                 const struct sockaddr* addr,
+                                 unsigned int flags,
+                                 struct msghdr* h) {
+  struct sockaddr_storage local;
+  uv_udp_recv_info_t info;
+
+  if (!(handle->flags & UV_HANDLE_UDP_RECV_INFO)) {
+    handle->recv_cb(handle, nread, buf, addr, flags);
+    return;
+  }
+
+  memset(&info, 0, sizeof(info));
+  info.addr = addr;
+  uv__udp_recv_info(h, &info, &local);
+  uv__udp_internal_fields(handle)->recv_ex_cb(handle, nread, buf, &info, flags);
+}
+
+
+#if defined(__linux__)
+/* Receives up to UV__MMSG_MAXWIDTH datagrams into UV__UDP_DGRAM_MAXSIZE
+ * slices of `buf` with one system call. Returns the number of datagrams,
+ * 0 if there was nothing to read, or an error.
+ */
+static int uv__udp_recvmmsg(uv_udp_t* handle, uv_buf_t* buf) {
+  struct sockaddr_storage peers[UV__MMSG_MAXWIDTH];
+  struct iovec iov[UV__MMSG_MAXWIDTH];
+  struct uv__mmsghdr msgs[UV__MMSG_MAXWIDTH];
+  union uv__udp_ctrl ctrl[UV__MMSG_MAXWIDTH];
+  uv_udp_recv_cb recv_cb;
+  uv_buf_t chunk_buf;
+  size_t chunks;
+  size_t k;
+  int nread;
+  unsigned int flags;
+
+  chunks = buf->len / UV__UDP_DGRAM_MAXSIZE;
+  if (chunks > ARRAY_SIZE(iov))
+    chunks = ARRAY_SIZE(iov);
+
+  for (k = 0; k < chunks; k++) {
+    iov[k].iov_base = buf->base + k * UV__UDP_DGRAM_MAXSIZE;
+    iov[k].iov_len = UV__UDP_DGRAM_MAXSIZE;
+    memset(&msgs[k].msg_hdr, 0, sizeof(msgs[k].msg_hdr));
+    msgs[k].msg_hdr.msg_iov = iov + k;
+    msgs[k].msg_hdr.msg_iovlen = 1;
+    msgs[k].msg_hdr.msg_name = peers + k;
+    msgs[k].msg_hdr.msg_namelen = sizeof(peers[0]);
+    uv__udp_ctrl_prep(handle, &msgs[k].msg_hdr, ctrl + k);
+  }
+
+  do
+    nread = uv__recvmmsg(handle->io_watcher.fd, msgs, chunks, 0, NULL);
+  while (nread == -1 && errno == EINTR);
+
+  if (nread == -1)
+    return UV__ERR(errno);
+
+  /* The callback may stop the handle, hold on to it so the buffer can still
+   * be handed back.
+   */
+  recv_cb = handle->recv_cb;
+
+  for (k = 0; k < (size_t) nread && handle->recv_cb != NULL; k++) {
+    flags = UV_UDP_MMSG_CHUNK | uv__udp_gro_flags(&msgs[k].msg_hdr);
+    if (msgs[k].msg_hdr.msg_flags & MSG_TRUNC)
+      flags |= UV_UDP_PARTIAL;
+
+    chunk_buf = uv_buf_init(iov[k].iov_base, msgs[k].msg_len);
+    uv__udp_recv_deliver(handle,
+                         msgs[k].msg_len,
+                         &chunk_buf,
+                         msgs[k].msg_hdr.msg_namelen == 0 ?
+                             NULL : (const struct sockaddr*) (peers + k),
+                         flags,
+                         &msgs[k].msg_hdr);
+  }
+
+  /* Release the buffer. */
+  recv_cb(handle, 0, buf, NULL, 0);
+
+  return nread;
+}
+#endif
+
+
 static void uv__udp_recvmsg(uv_udp_t* handle) {
   struct sockaddr_storage peer;
+  union uv__udp_ctrl ctrl;
   struct msghdr h;
   ssize_t nread;
   uv_buf_t buf;
-  int flags;
+  unsigned int flags;
   int count;
 
   assert(handle->recv_cb != NULL);
@@ -169,16 +423,49 @@ static void uv__udp_recvmsg(uv_udp_t* handle) {
 
   do {
     buf = uv_buf_init(NULL, 0);
-    handle->alloc_cb((uv_handle_t*) handle, 64 * 1024, &buf);
+    handle->alloc_cb((uv_handle_t*) handle,
+                     (handle->flags & UV_HANDLE_UDP_RECVMMSG) ?
+                         UV__MMSG_MAXWIDTH * UV__UDP_DGRAM_MAXSIZE :
+                         UV__UDP_DGRAM_MAXSIZE,
+                     &buf);
     if (buf.base == NULL || buf.len == 0) {
       handle->recv_cb(handle, UV_ENOBUFS, &buf, NULL, 0);
       return;
     }
     assert(buf.base != NULL);
 
+#if defined(__linux__)
+    /* A buffer with room for a single datagram takes the regular path. */
+    if ((handle->flags & UV_HANDLE_UDP_RECVMMSG) &&
+        buf.len >= 2 * UV__UDP_DGRAM_MAXSIZE) {
+      nread = uv__udp_recvmmsg(handle, &buf);
+      if (nread == UV_ENOSYS) {
+        handle->flags &= ~UV_HANDLE_UDP_RECVMMSG;
+      } else {
+        if (nread == UV_EAGAIN)
+          handle->recv_cb(handle, 0, &buf, NULL, 0);
+        else if (nread < 0)
+          handle->recv_cb(handle, nread, &buf, NULL, 0);
+
+        /* A short batch means the socket has been drained, don't spend
+         * another system call finding that out.
+         */
+        if (nread <= 0 ||
+            ((size_t) nread < buf.len / UV__UDP_DGRAM_MAXSIZE &&
+             nread < UV__MMSG_MAXWIDTH)) {
+          return;
+        }
+
+        count -= nread - 1;
+        continue;
+      }
+    }
+#endif
+
     h.msg_namelen = sizeof(peer);
     h.msg_iov = (void*) &buf;
     h.msg_iovlen = 1;
+    uv__udp_ctrl_prep(handle, &h, &ctrl);
 
     do {
       nread = recvmsg(handle->io_watcher.fd, &h, 0);
@@ -198,11 +485,11 @@ static void uv__udp_recvmsg(uv_udp_t* handle) {
       else
         addr = (const struct sockaddr*) &peer;
 
-      flags = 0;
+      flags = uv__udp_gro_flags(&h);
       if (h.msg_flags & MSG_TRUNC)
         flags |= UV_UDP_PARTIAL;
 
-      handle->recv_cb(handle, nread, &buf, addr, flags);
+      uv__udp_recv_deliver(handle, nread, &buf, addr, flags, &h);
     }
   }
   /* recv_cb callback may decide to pause or close the handle */
@@ -213,11 +500,324 @@ static void uv__udp_recvmsg(uv_udp_t* handle) {
 }
 
 
+/* Whether the kernel splits UDP_SEGMENT sends, Linux 4.18 and newer. Older
+ * kernels ignore the control message and send one big datagram instead.
+ */
+static int uv__udp_gso_supported(int fd) {
+#if defined(__linux__)
+  static int supported = -1;
+  socklen_t len;
+  int val;
+
+  if (supported == -1) {
+    len = sizeof(val);
+    supported = (0 == getsockopt(fd, SOL_UDP, UDP_SEGMENT, &val, &len));
+  }
+
+  return supported;
+#else
+  return 0;
+#endif
+}
+
+
+static void uv__udp_set_msg_name(uv_udp_send_t* req, struct msghdr* h) {
+  /* A request queued on a connected handle carries no address. */
+  if (req->addr.ss_family == AF_UNSPEC) {
+    h->msg_name = NULL;
+    h->msg_namelen = 0;
+    return;
+  }
+
+  h->msg_name = &req->addr;
+  h->msg_namelen = (req->addr.ss_family == AF_INET6 ?
+    sizeof(struct sockaddr_in6) : sizeof(struct sockaddr_in));
+}
+
+
+/* Writes the IP_PKTINFO or IPV6_PKTINFO control message that selects the
+ * source address of a uv_udp_send_from() request. Returns its size.
+ */
+static size_t uv__udp_put_pktinfo(uv__udp_send_internal_fields_t* fields,
+                                  struct cmsghdr* cmsg) {
+#if defined(IP_PKTINFO)
+  struct in_pktinfo pi;
+#endif
+#if defined(IPV6_PKTINFO)
+  struct in6_pktinfo pi6;
+#endif
+
+#if defined(IPV6_PKTINFO)
+  if (fields->src_addr.sin6_family == AF_INET6) {
+    memset(&pi6, 0, sizeof(pi6));
+    pi6.ipi6_addr = fields->src_addr.sin6_addr;
+    pi6.ipi6_ifindex = fields->src_ifindex;
+    cmsg->cmsg_level = IPPROTO_IPV6;
+    cmsg->cmsg_type = IPV6_PKTINFO;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(pi6));
+    memcpy(CMSG_DATA(cmsg), &pi6, sizeof(pi6));
+    return CMSG_SPACE(sizeof(pi6));
+  }
+#endif
+#if defined(IP_PKTINFO)
+  if (fields->src_addr.sin6_family == AF_INET) {
+    memset(&pi, 0, sizeof(pi));
+    pi.ipi_spec_dst = ((struct sockaddr_in*) &fields->src_addr)->sin_addr;
+    pi.ipi_ifindex = fields->src_ifindex;
+    cmsg->cmsg_level = IPPROTO_IP;
+    cmsg->cmsg_type = IP_PKTINFO;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(pi));
+    memcpy(CMSG_DATA(cmsg), &pi, sizeof(pi));
+    return CMSG_SPACE(sizeof(pi));
+  }
+#endif
+
+  return 0;
+}
+
+
+static unsigned int uv__udp_send_gso_size(uv_udp_send_t* req) {
+  uv__udp_send_internal_fields_t* fields;
+
+  fields = uv__udp_send_internal_fields(req);
+  return fields != NULL ? fields->gso_size : 0;
+}
+
+
+static void uv__udp_prep_msg(uv_udp_send_t* req,
+                             struct msghdr* h,
+                             union uv__udp_ctrl* ctrl) {
+  uv__udp_send_internal_fields_t* fields;
+  struct cmsghdr* cmsg;
+  size_t len;
+#if defined(__linux__)
+  uint16_t segment_size;
+#endif
+
+  memset(h, 0, sizeof(*h));
+  uv__udp_set_msg_name(req, h);
+  h->msg_iov = (struct iovec*) req->bufs;
+  h->msg_iovlen = req->nbufs;
+
+  fields = uv__udp_send_internal_fields(req);
+  if (fields == NULL)
+    return;
+
+  memset(ctrl, 0, sizeof(*ctrl));
+  h->msg_control = ctrl->buf;
+  h->msg_controllen = sizeof(ctrl->buf);
+  cmsg = CMSG_FIRSTHDR(h);
+  len = 0;
+
+#if defined(__linux__)
+  if (fields->gso_size != 0) {
+    cmsg->cmsg_level = SOL_UDP;
+    cmsg->cmsg_type = UDP_SEGMENT;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(segment_size));
+    segment_size = fields->gso_size;
+    memcpy(CMSG_DATA(cmsg), &segment_size, sizeof(segment_size));
+    len += CMSG_SPACE(sizeof(segment_size));
+    cmsg = CMSG_NXTHDR(h, cmsg);
+  }
+#endif
+
+  if (fields->src_addr.sin6_family != AF_UNSPEC)
+    len += uv__udp_put_pktinfo(fields, cmsg);
+
+  h->msg_controllen = len;
+  if (len == 0)
+    h->msg_control = NULL;
+}
+
+
+/* Sending a datagram is an atomic operation: either all data is written or
+ * nothing is (and EMSGSIZE is raised). That is why we don't handle partial
+ * writes. Just pop the request off the write queue and onto the completed
+ * queue, done.
+ */
+static void uv__udp_complete(uv_udp_t* handle,
+                             uv_udp_send_t* req,
+                             ssize_t status) {
+  req->status = status;
+  QUEUE_REMOVE(&req->queue);
+  QUEUE_INSERT_TAIL(&handle->write_completed_queue, &req->queue);
+  uv__io_feed(handle->loop, &handle->io_watcher);
+}
+
+
+/* Sends a uv_udp_send_gso() request as separate datagrams when the kernel
+ * can't segment it. Returns UV_EAGAIN when the socket buffer is full, the
+ * request remembers how far it got.
+ */
+static int uv__udp_send_segmented(uv_udp_t* handle, uv_udp_send_t* req) {
+  uv__udp_send_internal_fields_t* fields;
+  struct iovec iovsml[8];
+  struct iovec* iov;
+  struct msghdr h;
+  unsigned int i;
+  unsigned int n;
+  ssize_t size;
+  size_t total;
+  size_t skip;
+  size_t take;
+  size_t seg;
+  int err;
+
+  iov = iovsml;
+  if (req->nbufs > ARRAY_SIZE(iovsml)) {
+    iov = uv__malloc(req->nbufs * sizeof(*iov));
+    if (iov == NULL) {
+      uv__udp_complete(handle, req, UV_ENOMEM);
+      return 0;
+    }
+  }
+
+  fields = uv__udp_send_internal_fields(req);
+  total = uv__count_bufs(req->bufs, req->nbufs);
+  err = 0;
+
+  while (fields->gso_offset < total) {
+    seg = total - fields->gso_offset;
+    if (seg > fields->gso_size)
+      seg = fields->gso_size;
+
+    /* Collect the parts of the buffers that make up the segment. */
+    skip = fields->gso_offset;
+    take = seg;
+    n = 0;
+    for (i = 0; i < req->nbufs && take > 0; i++) {
+      if (skip >= req->bufs[i].len) {
+        skip -= req->bufs[i].len;
+        continue;
+      }
+
+      iov[n].iov_base = req->bufs[i].base + skip;
+      iov[n].iov_len = req->bufs[i].len - skip;
+      if (iov[n].iov_len > take)
+        iov[n].iov_len = take;
+      take -= iov[n].iov_len;
+      skip = 0;
+      n++;
+    }
+
+    memset(&h, 0, sizeof(h));
+    uv__udp_set_msg_name(req, &h);
+    h.msg_iov = iov;
+    h.msg_iovlen = n;
+
+    do
+      size = sendmsg(handle->io_watcher.fd, &h, 0);
+    while (size == -1 && errno == EINTR);
+
+    if (size == -1) {
+      if (errno == EAGAIN || errno == EWOULDBLOCK || errno == ENOBUFS)
+        err = UV_EAGAIN;
+      else
+        err = UV__ERR(errno);
+      break;
+    }
+
+    fields->gso_offset += seg;
+  }
+
+  if (iov != iovsml)
+    uv__free(iov);
+
+  if (err == UV_EAGAIN)
+    return err;
+
+  uv__udp_complete(handle, req, err != 0 ? err : (ssize_t) total);
+  return 0;
+}
+
+
+#if defined(__linux__)
+/* Sends up to UV__MMSG_MAXWIDTH queued datagrams per system call. Returns
+ * UV_ENOSYS if the kernel doesn't support sendmmsg().
+ */
+static int uv__udp_sendmmsg(uv_udp_t* handle) {
+  struct uv__mmsghdr h[UV__MMSG_MAXWIDTH];
+  union uv__udp_ctrl ctrl[UV__MMSG_MAXWIDTH];
+  uv_udp_send_t* req;
+  QUEUE* q;
+  int npkts;
+  int pkts;
+  int gso;
+  int i;
+
+  gso = uv__udp_gso_supported(handle->io_watcher.fd);
+
+  while (!QUEUE_EMPTY(&handle->write_queue)) {
+    pkts = 0;
+    q = QUEUE_HEAD(&handle->write_queue);
+    while (pkts < UV__MMSG_MAXWIDTH && q != &handle->write_queue) {
+      req = QUEUE_DATA(q, uv_udp_send_t, queue);
+      if (uv__udp_send_gso_size(req) != 0 && !gso)
+        break;
+
+      uv__udp_prep_msg(req, &h[pkts].msg_hdr, ctrl + pkts);
+      h[pkts].msg_len = 0;
+      pkts++;
+      q = QUEUE_NEXT(q);
+    }
+
+    if (pkts == 0) {
+      req = QUEUE_DATA(q, uv_udp_send_t, queue);
+      if (uv__udp_send_segmented(handle, req) == UV_EAGAIN)
+        return 0;
+      continue;
+    }
+
+    do
+      npkts = uv__sendmmsg(handle->io_watcher.fd, h, pkts, 0);
+    while (npkts == -1 && errno == EINTR);
+
+    if (npkts == -1) {
+      if (errno == ENOSYS)
+        return UV_ENOSYS;
+      if (errno == EAGAIN || errno == EWOULDBLOCK || errno == ENOBUFS)
+        return 0;
+
+      /* The error is about the first datagram, the others weren't tried. */
+      q = QUEUE_HEAD(&handle->write_queue);
+      req = QUEUE_DATA(q, uv_udp_send_t, queue);
+      uv__udp_complete(handle, req, UV__ERR(errno));
+      continue;
+    }
+
+    /* Datagrams are sent in order, a short count means the next one would
+     * block or failed. Leave it queued, the next call finds out which.
+     */
+    for (i = 0; i < npkts; i++) {
+      q = QUEUE_HEAD(&handle->write_queue);
+      req = QUEUE_DATA(q, uv_udp_send_t, queue);
+      uv__udp_complete(handle, req, h[i].msg_len);
+    }
+  }
+
+  return 0;
+}
+#endif
+
+
 static void uv__udp_sendmsg(uv_udp_t* handle) {
+  union uv__udp_ctrl ctrl;
   uv_udp_send_t* req;
   QUEUE* q;
   struct msghdr h;
   ssize_t size;
+#if defined(__linux__)
+  static int no_sendmmsg;
+
+  /* Not worth it for a single datagram. */
+  if (!no_sendmmsg &&
+      !QUEUE_EMPTY(&handle->write_queue) &&
+      QUEUE_NEXT(QUEUE_HEAD(&handle->write_queue)) != &handle->write_queue) {
+    if (uv__udp_sendmmsg(handle) != UV_ENOSYS)
+      return;
+    no_sendmmsg = 1;
+  }
+#endif
 
   while (!QUEUE_EMPTY(&handle->write_queue)) {
     q = QUEUE_HEAD(&handle->write_queue);
@@ -226,12 +826,14 @@ static void uv__udp_sendmsg(uv_udp_t* handle) {
     req = QUEUE_DATA(q, uv_udp_send_t, queue);
     assert(req != NULL);
 
-    memset(&h, 0, sizeof h);
-    h.msg_name = &req->addr;
-    h.msg_namelen = (req->addr.ss_family == AF_INET6 ?
-      sizeof(struct sockaddr_in6) : sizeof(struct sockaddr_in));
-    h.msg_iov = (struct iovec*) req->bufs;
-    h.msg_iovlen = req->nbufs;
+    if (uv__udp_send_gso_size(req) != 0 &&
+        !uv__udp_gso_supported(handle->io_watcher.fd)) {
+      if (uv__udp_send_segmented(handle, req) == UV_EAGAIN)
+        break;
+      continue;
+    }
+
+    uv__udp_prep_msg(req, &h, &ctrl);
 
     do {
       size = sendmsg(handle->io_watcher.fd, &h, 0);
@@ -242,16 +844,7 @@ static void uv__udp_sendmsg(uv_udp_t* handle) {
         break;
     }
 
-    req->status = (size == -1 ? UV__ERR(errno) : size);
-
-    /* Sending a datagram is an atomic operation: either all data
-     * is written or nothing is (and EMSGSIZE is raised). That is
-     * why we don't handle partial writes. Just pop the request
-     * off the write queue and onto the completed queue, done.
-     */
-    QUEUE_REMOVE(&req->queue);
-    QUEUE_INSERT_TAIL(&handle->write_completed_queue, &req->queue);
-    uv__io_feed(handle->loop, &handle->io_watcher);
+    uv__udp_complete(handle, req, size == -1 ? UV__ERR(errno) : size);
   }
 }
 
@@ -262,7 +855,8 @@ static void uv__udp_sendmsg(uv_udp_t* handle) {
  * Linux as of 3.9 has a SO_REUSEPORT socket option but with semantics that
  * are different from the BSDs: it _shares_ the port rather than steal it
  * from the current listener.  While useful, it's not something we can emulate
- * on other platforms so we don't enable it.
+ * on other platforms so we don't enable it here; UV_UDP_REUSEPORT asks for
+ * the sharing behavior explicitly.
  */
 static int uv__set_reuse(int fd) {
   int yes;
@@ -290,7 +884,7 @@ int uv__udp_bind(uv_udp_t* handle,
   int fd;
 
   /* Check for bad flags. */
-  if (flags & ~(UV_UDP_IPV6ONLY | UV_UDP_REUSEADDR))
+  if (flags & ~(UV_UDP_IPV6ONLY | UV_UDP_REUSEADDR | UV_UDP_REUSEPORT))
     return UV_EINVAL;
 
   /* Cannot set IPv6-only mode on non-IPv6 socket. */
@@ -312,6 +906,12 @@ int uv__udp_bind(uv_udp_t* handle,
       return err;
   }
 
+  if (flags & UV_UDP_REUSEPORT) {
+    err = uv__sock_reuseport(fd);
+    if (err)
+      return err;
+  }
+
   if (flags & UV_UDP_IPV6ONLY) {
 #ifdef IPV6_V6ONLY
     yes = 1;
@@ -383,22 +983,78 @@ static int uv__udp_maybe_deferred_bind(uv_udp_t* handle,
 }
 
 
-int uv__udp_send(uv_udp_send_t* req,
-                 uv_udp_t* handle,
-                 const uv_buf_t bufs[],
-                 unsigned int nbufs,
-                 const struct sockaddr* addr,
-                 unsigned int addrlen,
-                 uv_udp_send_cb send_cb) {
+int uv__udp_connect(uv_udp_t* handle,
+                    const struct sockaddr* addr,
+                    unsigned int addrlen) {
   int err;
-  int empty_queue;
-
-  assert(nbufs > 0);
 
   err = uv__udp_maybe_deferred_bind(handle, addr->sa_family, 0);
   if (err)
     return err;
 
+  do {
+    errno = 0;
+    err = connect(handle->io_watcher.fd, addr, addrlen);
+  } while (err == -1 && errno == EINTR);
+
+  if (err)
+    return UV__ERR(errno);
+
+  handle->flags |= UV_HANDLE_UDP_CONNECTED;
+
+  return 0;
+}
+
+
+int uv__udp_disconnect(uv_udp_t* handle) {
+  int r;
+  struct sockaddr addr;
+
+  memset(&addr, 0, sizeof(addr));
+
+  addr.sa_family = AF_UNSPEC;
+
+  do {
+    errno = 0;
+    r = connect(handle->io_watcher.fd, &addr, sizeof(addr));
+  } while (r == -1 && errno == EINTR);
+
+  /* Linux and the BSDs report EAFNOSUPPORT for AF_UNSPEC even though the
+   * association was dissolved.
+   */
+  if (r == -1 && errno != EAFNOSUPPORT)
+    return UV__ERR(errno);
+
+  handle->flags &= ~UV_HANDLE_UDP_CONNECTED;
+  return 0;
+}
+
+
+/* Queues a request. `fields` holds the segment size and source address of
+ * uv_udp_send_gso() and uv_udp_send_from() requests, it's NULL for plain
+ * ones. The request takes ownership of it, also on error.
+ */
+static int uv__udp_queue_send(uv_udp_send_t* req,
+                              uv_udp_t* handle,
+                              const uv_buf_t bufs[],
+                              unsigned int nbufs,
+                              const struct sockaddr* addr,
+                              unsigned int addrlen,
+                              uv__udp_send_internal_fields_t* fields,
+                              uv_udp_send_cb send_cb) {
+  int err;
+  int empty_queue;
+
+  assert(nbufs > 0);
+
+  if (addr) {
+    err = uv__udp_maybe_deferred_bind(handle, addr->sa_family, 0);
+    if (err) {
+      uv__free(fields);
+      return err;
+    }
+  }
+
   /* It's legal for send_queue_count > 0 even when the write_queue is empty;
    * it means there are error-state requests in the write_completed_queue that
    * will touch up send_queue_size/count later.
@@ -407,7 +1063,10 @@ int uv__udp_send(uv_udp_send_t* req,
 
   uv__req_init(handle->loop, req, UV_UDP_SEND);
   assert(addrlen <= sizeof(req->addr));
-  memcpy(&req->addr, addr, addrlen);
+  if (addr == NULL)
+    req->addr.ss_family = AF_UNSPEC;
+  else
+    memcpy(&req->addr, addr, addrlen);
   req->send_cb = send_cb;
   req->handle = handle;
   req->nbufs = nbufs;
@@ -418,9 +1077,12 @@ int uv__udp_send(uv_udp_send_t* req,
 
   if (req->bufs == NULL) {
     uv__req_unregister(handle->loop, req);
+    uv__free(fields);
     return UV_ENOMEM;
   }
 
+  uv__req_internal_fields(req) = fields;
+
   memcpy(req->bufs, bufs, nbufs * sizeof(bufs[0]));
   handle->send_queue_size += uv__count_bufs(req->bufs, req->nbufs);
   handle->send_queue_count++;
@@ -444,6 +1106,93 @@ int uv__udp_send(uv_udp_send_t* req,
 }
 
 
+int uv__udp_send(uv_udp_send_t* req,
+                 uv_udp_t* handle,
+                 const uv_buf_t bufs[],
+                 unsigned int nbufs,
+                 const struct sockaddr* addr,
+                 unsigned int addrlen,
+                 uv_udp_send_cb send_cb) {
+  return uv__udp_queue_send(req,
+                            handle,
+                            bufs,
+                            nbufs,
+                            addr,
+                            addrlen,
+                            NULL,
+                            send_cb);
+}
+
+
+int uv__udp_send_gso(uv_udp_send_t* req,
+                     uv_udp_t* handle,
+                     const uv_buf_t bufs[],
+                     unsigned int nbufs,
+                     const struct sockaddr* addr,
+                     unsigned int addrlen,
+                     unsigned int segment_size,
+                     uv_udp_send_cb send_cb) {
+  uv__udp_send_internal_fields_t* fields;
+
+  fields = uv__calloc(1, sizeof(*fields));
+  if (fields == NULL)
+    return UV_ENOMEM;
+
+  fields->gso_size = segment_size;
+  fields->src_addr.sin6_family = AF_UNSPEC;
+
+  return uv__udp_queue_send(req,
+                            handle,
+                            bufs,
+                            nbufs,
+                            addr,
+                            addrlen,
+                            fields,
+                            send_cb);
+}
+
+
+int uv__udp_send_from(uv_udp_send_t* req,
+                      uv_udp_t* handle,
+                      const uv_buf_t bufs[],
+                      unsigned int nbufs,
+                      const struct sockaddr* addr,
+                      unsigned int addrlen,
+                      const struct sockaddr* src_addr,
+                      unsigned int ifindex,
+                      uv_udp_send_cb send_cb) {
+  uv__udp_send_internal_fields_t* fields;
+
+#if !defined(IP_PKTINFO)
+  if (src_addr->sa_family == AF_INET)
+    return UV_ENOTSUP;
+#endif
+#if !defined(IPV6_PKTINFO)
+  if (src_addr->sa_family == AF_INET6)
+    return UV_ENOTSUP;
+#endif
+
+  fields = uv__calloc(1, sizeof(*fields));
+  if (fields == NULL)
+    return UV_ENOMEM;
+
+  if (src_addr->sa_family == AF_INET6)
+    memcpy(&fields->src_addr, src_addr, sizeof(struct sockaddr_in6));
+  else
+    memcpy(&fields->src_addr, src_addr, sizeof(struct sockaddr_in));
+  fields->src_ifindex = ifindex;
+
+  return uv__udp_queue_send(req,
+                            handle,
+                            bufs,
+                            nbufs,
+                            addr,
+                            addrlen,
+                            fields,
+                            send_cb);
+}
+
+
 int uv__udp_try_send(uv_udp_t* handle,
                      const uv_buf_t bufs[],
                      unsigned int nbufs,
@@ -459,9 +1208,16 @@ int uv__udp_try_send(uv_udp_t* handle,
   if (handle->send_queue_count != 0)
     return UV_EAGAIN;
 
-  err = uv__udp_maybe_deferred_bind(handle, addr->sa_family, 0);
-  if (err)
-    return err;
+  /* A connected handle is bound already and needs no address; this is a
+   * plain write() on the socket.
+   */
+  if (addr) {
+    err = uv__udp_maybe_deferred_bind(handle, addr->sa_family, 0);
+    if (err)
+      return err;
+  } else {
+    assert(handle->flags & UV_HANDLE_UDP_CONNECTED);
+  }
 
   memset(&h, 0, sizeof h);
   h.msg_name = (struct sockaddr*) addr;
@@ -588,7 +1344,7 @@ int uv_udp_init_ex(uv_loop_t* loop, uv_udp_t* handle, unsigned int flags) {
   if (domain != AF_INET && domain != AF_INET6 && domain != AF_UNSPEC)
     return UV_EINVAL;
 
-  if (flags & ~0xFF)
+  if (flags & ~0xFF & ~UV_UDP_RECVMMSG)
     return UV_EINVAL;
 
   if (domain != AF_UNSPEC) {
@@ -601,6 +1357,10 @@ int uv_udp_init_ex(uv_loop_t* loop, uv_udp_t* handle, unsigned int flags) {
   }
 
   uv__handle_init(loop, (uv_handle_t*)handle, UV_UDP);
+#if defined(__linux__)
+  if (flags & UV_UDP_RECVMMSG)
+    handle->flags |= UV_HANDLE_UDP_RECVMMSG;
+#endif
   handle->alloc_cb = NULL;
   handle->recv_cb = NULL;
   handle->send_queue_size = 0;
@@ -636,6 +1396,9 @@ int uv_udp_open(uv_udp_t* handle, uv_os_sock_t sock) {
     return err;
 
   handle->io_watcher.fd = sock;
+  if (uv__udp_is_connected(handle))
+    handle->flags |= UV_HANDLE_UDP_CONNECTED;
+
   return 0;
 }
 
@@ -720,6 +1483,23 @@ int uv_udp_set_broadcast(uv_udp_t* handle, int on) {
 }
 
 
+int uv_udp_set_gro(uv_udp_t* handle, int on) {
+#if defined(__linux__)
+  if (setsockopt(handle->io_watcher.fd, SOL_UDP, UDP_GRO, &on, sizeof(on)))
+    return UV__ERR(errno);
+
+  if (on)
+    handle->flags |= UV_HANDLE_UDP_GRO;
+  else
+    handle->flags &= ~UV_HANDLE_UDP_GRO;
+
+  return 0;
+#else
+  return UV_ENOTSUP;
+#endif
+}
+
+
 int uv_udp_set_ttl(uv_udp_t* handle, int ttl) {
   if (ttl < 1 || ttl > 255)
     return UV_EINVAL;
@@ -852,6 +1632,25 @@ int uv_udp_set_multicast_interface(uv_udp_t* handle, const char* interface_addr)
 }
 
 
+int uv_udp_getpeername(const uv_udp_t* handle,
+                       struct sockaddr* name,
+                       int* namelen) {
+  socklen_t socklen;
+
+  if (handle->io_watcher.fd == -1)
+    return UV_EINVAL;
+
+  /* sizeof(socklen_t) != sizeof(int) on some systems. */
+  socklen = (socklen_t) *namelen;
+
+  if (getpeername(handle->io_watcher.fd, name, &socklen))
+    return UV__ERR(errno);
+
+  *namelen = (int) socklen;
+  return 0;
+}
+
+
 int uv_udp_getsockname(const uv_udp_t* handle,
                        struct sockaddr* name,
                        int* namelen) {
@@ -896,6 +1695,69 @@ int uv__udp_recv_start(uv_udp_t* handle,
 }
 
 
+int uv__udp_recv_info_start(uv_udp_t* handle, unsigned int flags) {
+  struct sockaddr_storage ss;
+  socklen_t len;
+  int err;
+  int yes;
+  int fd;
+
+  if (flags == 0) {
+    handle->flags &= ~UV_HANDLE_UDP_RECV_INFO;
+    return 0;
+  }
+
+  err = uv__udp_maybe_deferred_bind(handle, AF_INET, 0);
+  if (err)
+    return err;
+
+  fd = handle->io_watcher.fd;
+  yes = 1;
+
+  if (flags & UV_UDP_RECV_TIMESTAMP) {
+#if defined(SO_TIMESTAMPNS)
+    if (setsockopt(fd, SOL_SOCKET, SO_TIMESTAMPNS, &yes, sizeof(yes)))
+      return UV__ERR(errno);
+#elif defined(SO_TIMESTAMP)
+    if (setsockopt(fd, SOL_SOCKET, SO_TIMESTAMP, &yes, sizeof(yes)))
+      return UV__ERR(errno);
+#else
+    return UV_ENOTSUP;
+#endif
+  }
+
+  if (flags & UV_UDP_RECV_PKTINFO) {
+    len = sizeof(ss);
+    if (getsockname(fd, (struct sockaddr*) &ss, &len))
+      return UV__ERR(errno);
+
+    if (ss.ss_family == AF_INET6) {
+#if defined(IPV6_RECVPKTINFO)
+      if (setsockopt(fd, IPPROTO_IPV6, IPV6_RECVPKTINFO, &yes, sizeof(yes)))
+        return UV__ERR(errno);
+#else
+      return UV_ENOTSUP;
+#endif
+    }
+
+    /* Dual-stack IPv6 sockets report IPv4 traffic with IP_PKTINFO, where the
+     * platform allows it on IPv6 sockets at all.
+     */
+#if defined(IP_PKTINFO)
+    if (setsockopt(fd, IPPROTO_IP, IP_PKTINFO, &yes, sizeof(yes)))
+      if (ss.ss_family == AF_INET)
+        return UV__ERR(errno);
+#else
+    if (ss.ss_family == AF_INET)
+      return UV_ENOTSUP;
+#endif
+  }
+
+  handle->flags |= UV_HANDLE_UDP_RECV_INFO;
+  return 0;
+}
+
+
 int uv__udp_recv_stop(uv_udp_t* handle) {
   uv__io_stop(handle->loop, &handle->io_watcher, POLLIN);
 
@@ -904,6 +1766,7 @@ int uv__udp_recv_stop(uv_udp_t* handle) {
 
   handle->alloc_cb = NULL;
   handle->recv_cb = NULL;
+  handle->flags &= ~UV_HANDLE_UDP_RECV_INFO;
 
   return 0;
 }
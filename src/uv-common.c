@@ -317,15 +317,17 @@ int uv_tcp_connect(uv_connect_t* req,
 }
 
 
-int uv_udp_send(uv_udp_send_t* req,
-                uv_udp_t* handle,
-                const uv_buf_t bufs[],
-                unsigned int nbufs,
-                const struct sockaddr* addr,
-                uv_udp_send_cb send_cb) {
+int uv_tcp_connect_fastopen(uv_connect_t* req,
+                            uv_tcp_t* handle,
+                            const struct sockaddr* addr,
+                            uv_write_t* write_req,
+                            const uv_buf_t bufs[],
+                            unsigned int nbufs,
+                            uv_connect_cb cb,
+                            uv_write_cb write_cb) {
   unsigned int addrlen;
 
-  if (handle->type != UV_UDP)
+  if (handle->type != UV_TCP || nbufs == 0)
     return UV_EINVAL;
 
   if (addr->sa_family == AF_INET)
@@ -335,19 +337,76 @@ int uv_udp_send(uv_udp_send_t* req,
   else
     return UV_EINVAL;
 
-  return uv__udp_send(req, handle, bufs, nbufs, addr, addrlen, send_cb);
+  return uv__tcp_connect_fastopen(req,
+                                  handle,
+                                  addr,
+                                  addrlen,
+                                  write_req,
+                                  bufs,
+                                  nbufs,
+                                  cb,
+                                  write_cb);
 }
 
 
-int uv_udp_try_send(uv_udp_t* handle,
-                    const uv_buf_t bufs[],
-                    unsigned int nbufs,
-                    const struct sockaddr* addr) {
+/* Detects sockets that were connected before being handed to uv_udp_open(). */
+int uv__udp_is_connected(uv_udp_t* handle) {
+  struct sockaddr_storage addr;
+  int addrlen;
+
+  if (handle->type != UV_UDP)
+    return 0;
+
+  addrlen = sizeof(addr);
+  if (uv_udp_getpeername(handle, (struct sockaddr*) &addr, &addrlen) != 0)
+    return 0;
+
+  return addrlen > 0;
+}
+
+
+static int uv__udp_check_before_send(uv_udp_t* handle,
+                                     const struct sockaddr* addr) {
+  int addrlen;
+
+  if (handle->type != UV_UDP)
+    return UV_EINVAL;
+
+  if (addr != NULL && (handle->flags & UV_HANDLE_UDP_CONNECTED))
+    return UV_EISCONN;
+
+  if (addr == NULL && !(handle->flags & UV_HANDLE_UDP_CONNECTED))
+    return UV_EDESTADDRREQ;
+
+  if (addr != NULL) {
+    if (addr->sa_family == AF_INET)
+      addrlen = sizeof(struct sockaddr_in);
+    else if (addr->sa_family == AF_INET6)
+      addrlen = sizeof(struct sockaddr_in6);
+    else
+      return UV_EINVAL;
+  } else {
+    addrlen = 0;
+  }
+
+  return addrlen;
+}
+
+
+int uv_udp_connect(uv_udp_t* handle, const struct sockaddr* addr) {
   unsigned int addrlen;
 
   if (handle->type != UV_UDP)
     return UV_EINVAL;
 
+  /* Disconnect the handle */
+  if (addr == NULL) {
+    if (!(handle->flags & UV_HANDLE_UDP_CONNECTED))
+      return UV_ENOTCONN;
+
+    return uv__udp_disconnect(handle);
+  }
+
   if (addr->sa_family == AF_INET)
     addrlen = sizeof(struct sockaddr_in);
   else if (addr->sa_family == AF_INET6)
@@ -355,6 +414,101 @@ int uv_udp_try_send(uv_udp_t* handle,
   else
     return UV_EINVAL;
 
+  if (handle->flags & UV_HANDLE_UDP_CONNECTED)
+    return UV_EISCONN;
+
+  return uv__udp_connect(handle, addr, addrlen);
+}
+
+
+int uv_udp_send(uv_udp_send_t* req,
+                uv_udp_t* handle,
+                const uv_buf_t bufs[],
+                unsigned int nbufs,
+                const struct sockaddr* addr,
+                uv_udp_send_cb send_cb) {
+  int addrlen;
+
+  addrlen = uv__udp_check_before_send(handle, addr);
+  if (addrlen < 0)
+    return addrlen;
+
+  return uv__udp_send(req, handle, bufs, nbufs, addr, addrlen, send_cb);
+}
+
+
+int uv_udp_send_gso(uv_udp_send_t* req,
+                    uv_udp_t* handle,
+                    const uv_buf_t bufs[],
+                    unsigned int nbufs,
+                    const struct sockaddr* addr,
+                    unsigned int segment_size,
+                    uv_udp_send_cb send_cb) {
+  int addrlen;
+
+  addrlen = uv__udp_check_before_send(handle, addr);
+  if (addrlen < 0)
+    return addrlen;
+
+  if (segment_size == 0 || segment_size > 0xFFFF)
+    return UV_EINVAL;
+
+  return uv__udp_send_gso(req,
+                          handle,
+                          bufs,
+                          nbufs,
+                          addr,
+                          addrlen,
+                          segment_size,
+                          send_cb);
+}
+
+
+int uv_udp_send_from(uv_udp_send_t* req,
+                     uv_udp_t* handle,
+                     const uv_buf_t bufs[],
+                     unsigned int nbufs,
+                     const struct sockaddr* addr,
+                     const struct sockaddr* src_addr,
+                     unsigned int ifindex,
+                     uv_udp_send_cb send_cb) {
+  int addrlen;
+
+  addrlen = uv__udp_check_before_send(handle, addr);
+  if (addrlen < 0)
+    return addrlen;
+
+  if (src_addr == NULL)
+    return UV_EINVAL;
+
+  if (src_addr->sa_family != AF_INET && src_addr->sa_family != AF_INET6)
+    return UV_EINVAL;
+
+  if (addr != NULL && src_addr->sa_family != addr->sa_family)
+    return UV_EINVAL;
+
+  return uv__udp_send_from(req,
+                           handle,
+                           bufs,
+                           nbufs,
+                           addr,
+                           addrlen,
+                           src_addr,
+                           ifindex,
+                           send_cb);
+}
+
+
+int uv_udp_try_send(uv_udp_t* handle,
+                    const uv_buf_t bufs[],
+                    unsigned int nbufs,
+                    const struct sockaddr* addr) {
+  int addrlen;
+
+  addrlen = uv__udp_check_before_send(handle, addr);
+  if (addrlen < 0)
+    return addrlen;
+
   return uv__udp_try_send(handle, bufs, nbufs, addr, addrlen);
 }
 
@@ -369,6 +523,53 @@ int uv_udp_recv_start(uv_udp_t* handle,
 }
 
 
+/* Adapts the plain receive callback for handles started with
+ * uv_udp_recv_start_ex(). The platform code bypasses it to deliver datagrams
+ * that carry ancillary data.
+ */
+static void uv__udp_recv_ex_thunk(uv_udp_t* handle,
+                                  ssize_t nread,
+                                  const uv_buf_t* buf,
+                                  const struct sockaddr* addr,
+                                  unsigned flags) {
+  uv_udp_recv_info_t info;
+
+  memset(&info, 0, sizeof(info));
+  info.addr = addr;
+  uv__udp_internal_fields(handle)->recv_ex_cb(handle, nread, buf, &info, flags);
+}
+
+
+int uv_udp_recv_start_ex(uv_udp_t* handle,
+                         uv_alloc_cb alloc_cb,
+                         uv_udp_recv_ex_cb recv_cb,
+                         unsigned int flags) {
+  uv__udp_internal_fields_t* fields;
+  int err;
+
+  if (handle->type != UV_UDP || alloc_cb == NULL || recv_cb == NULL)
+    return UV_EINVAL;
+
+  if (flags & ~(UV_UDP_RECV_TIMESTAMP | UV_UDP_RECV_PKTINFO))
+    return UV_EINVAL;
+
+  fields = uv__udp_internal_fields(handle);
+  if (fields == NULL) {
+    fields = uv__malloc(sizeof(*fields));
+    if (fields == NULL)
+      return UV_ENOMEM;
+    uv__handle_internal_fields(handle) = fields;
+  }
+
+  err = uv__udp_recv_info_start(handle, flags);
+  if (err)
+    return err;
+
+  fields->recv_ex_cb = recv_cb;
+  return uv__udp_recv_start(handle, alloc_cb, uv__udp_recv_ex_thunk);
+}
+
+
 int uv_udp_recv_stop(uv_udp_t* handle) {
   if (handle->type != UV_UDP)
     return UV_EINVAL;
@@ -608,12 +809,104 @@ int uv_fs_scandir_next(uv_fs_t* req, uv_dirent_t* ent) {
 }
 
 
+/* Pool buffers are carved out of a larger uv__malloc() allocation. The pointer
+ * to free is stashed right before the aligned start of the buffer and free
+ * buffers are chained through their first bytes.
+ */
+int uv_fs_buf_pool_init(uv_fs_buf_pool_t* pool, uv_file file, size_t buf_size) {
+  size_t block_size;
+  int err;
+
+  if (pool == NULL || buf_size == 0)
+    return UV_EINVAL;
+
+  err = uv__fs_get_block_size(file, &block_size);
+  if (err)
+    return err;
+
+  if (block_size < sizeof(void*))
+    block_size = sizeof(void*);
+
+  /* Alignment arithmetic below depends on it. */
+  if (block_size & (block_size - 1))
+    return UV_EINVAL;
+
+  pool->block_size = block_size;
+  pool->buf_size = (buf_size + block_size - 1) & ~(block_size - 1);
+  pool->free_list = NULL;
+  pool->nfree = 0;
+  pool->nused = 0;
+
+  return 0;
+}
+
+
+void uv_fs_buf_pool_destroy(uv_fs_buf_pool_t* pool) {
+  void* base;
+
+  assert(pool->nused == 0);
+
+  while (pool->free_list != NULL) {
+    base = pool->free_list;
+    pool->free_list = *(void**) base;
+    uv__free(((void**) base)[-1]);
+  }
+
+  pool->nfree = 0;
+}
+
+
+int uv_fs_buf_pool_alloc(uv_fs_buf_pool_t* pool, uv_buf_t* buf) {
+  uintptr_t addr;
+  char* mem;
+  char* base;
+
+  if (pool->free_list != NULL) {
+    base = pool->free_list;
+    pool->free_list = *(void**) base;
+    pool->nfree--;
+  } else {
+    mem = uv__malloc(sizeof(void*) + pool->block_size + pool->buf_size);
+    if (mem == NULL)
+      return UV_ENOMEM;
+
+    addr = (uintptr_t) (mem + sizeof(void*));
+    addr = (addr + pool->block_size - 1) & ~(uintptr_t) (pool->block_size - 1);
+    base = (char*) addr;
+    ((void**) base)[-1] = mem;
+  }
+
+  pool->nused++;
+  buf->base = base;
+  buf->len = pool->buf_size;
+
+  return 0;
+}
+
+
+void uv_fs_buf_pool_free(uv_fs_buf_pool_t* pool, uv_buf_t buf) {
+  if (buf.base == NULL)
+    return;
+
+  assert(pool->nused > 0);
+  assert(((uintptr_t) buf.base & (pool->block_size - 1)) == 0);
+
+  *(void**) buf.base = pool->free_list;
+  pool->free_list = buf.base;
+  pool->nfree++;
+  pool->nused--;
+}
+
+
 int uv_loop_configure(uv_loop_t* loop, uv_loop_option option, ...) {
   va_list ap;
   int err;
 
-  va_start(ap, option);
   /* Any platform-agnostic options should be handled here. */
+  if (option == UV_LOOP_FS_POLL_BATCH)
+    return uv__fs_poll_sched_init(loop);
+
+  va_start(ap, option);
   err = uv__loop_configure(loop, option, ap);
   va_end(ap);
 
@@ -669,6 +962,7 @@ int uv_loop_close(uv_loop_t* loop) {
       return UV_EBUSY;
   }
 
+  uv__fs_poll_sched_close(loop);
   uv__loop_close(loop);
 
 #ifndef NDEBUG
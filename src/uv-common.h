@@ -93,6 +93,9 @@ enum {
   /* Used by uv_tcp_t and uv_udp_t handles */
   UV_HANDLE_IPV6                        = 0x00400000,
 
+  /* Only used by streams with write queue limits. */
+  UV_HANDLE_WRITE_QUEUE_FULL            = 0x00800000,
+
   /* Only used by uv_tcp_t handles. */
   UV_HANDLE_TCP_NODELAY                 = 0x01000000,
   UV_HANDLE_TCP_KEEPALIVE               = 0x02000000,
@@ -100,9 +103,14 @@ enum {
   UV_HANDLE_TCP_ACCEPT_STATE_CHANGING   = 0x08000000,
   UV_HANDLE_TCP_SOCKET_CLOSED           = 0x10000000,
   UV_HANDLE_SHARED_TCP_SOCKET           = 0x20000000,
+  UV_HANDLE_TCP_BATCH_WRITES            = 0x40000000,
 
   /* Only used by uv_udp_t handles. */
   UV_HANDLE_UDP_PROCESSING              = 0x01000000,
+  UV_HANDLE_UDP_RECVMMSG                = 0x02000000,
+  UV_HANDLE_UDP_GRO                     = 0x04000000,
+  UV_HANDLE_UDP_CONNECTED               = 0x08000000,
+  UV_HANDLE_UDP_RECV_INFO               = 0x10000000,
 
   /* Only used by uv_pipe_t handles. */
   UV_HANDLE_NON_OVERLAPPED_PIPE         = 0x01000000,
@@ -119,7 +127,10 @@ enum {
   UV_SIGNAL_ONE_SHOT                    = 0x02000000,
 
   /* Only used by uv_poll_t handles. */
-  UV_HANDLE_POLL_SLOW                   = 0x01000000
+  UV_HANDLE_POLL_SLOW                   = 0x01000000,
+
+  /* Only used by uv_fs_event_t handles. */
+  UV_HANDLE_FS_EVENT_RECURSIVE          = 0x01000000
 };
 
 int uv__loop_configure(uv_loop_t* loop, uv_loop_option option, va_list ap);
@@ -137,11 +148,29 @@ int uv__tcp_connect(uv_connect_t* req,
                    unsigned int addrlen,
                    uv_connect_cb cb);
 
+int uv__tcp_connect_fastopen(uv_connect_t* req,
+                             uv_tcp_t* handle,
+                             const struct sockaddr* addr,
+                             unsigned int addrlen,
+                             uv_write_t* write_req,
+                             const uv_buf_t bufs[],
+                             unsigned int nbufs,
+                             uv_connect_cb cb,
+                             uv_write_cb write_cb);
+
 int uv__udp_bind(uv_udp_t* handle,
                  const struct sockaddr* addr,
                  unsigned int  addrlen,
                  unsigned int flags);
 
+int uv__udp_connect(uv_udp_t* handle,
+                    const struct sockaddr* addr,
+                    unsigned int addrlen);
+
+int uv__udp_disconnect(uv_udp_t* handle);
+
+int uv__udp_is_connected(uv_udp_t* handle);
+
 int uv__udp_send(uv_udp_send_t* req,
                  uv_udp_t* handle,
                  const uv_buf_t bufs[],
@@ -150,6 +179,25 @@ int uv__udp_send(uv_udp_send_t* req,
                  unsigned int addrlen,
                  uv_udp_send_cb send_cb);
 
+int uv__udp_send_gso(uv_udp_send_t* req,
+                     uv_udp_t* handle,
+                     const uv_buf_t bufs[],
+                     unsigned int nbufs,
+                     const struct sockaddr* addr,
+                     unsigned int addrlen,
+                     unsigned int segment_size,
+                     uv_udp_send_cb send_cb);
+
+int uv__udp_send_from(uv_udp_send_t* req,
+                      uv_udp_t* handle,
+                      const uv_buf_t bufs[],
+                      unsigned int nbufs,
+                      const struct sockaddr* addr,
+                      unsigned int addrlen,
+                      const struct sockaddr* src_addr,
+                      unsigned int ifindex,
+                      uv_udp_send_cb send_cb);
+
 int uv__udp_try_send(uv_udp_t* handle,
                      const uv_buf_t bufs[],
                      unsigned int nbufs,
@@ -159,10 +207,16 @@ int uv__udp_try_send(uv_udp_t* handle,
 int uv__udp_recv_start(uv_udp_t* handle, uv_alloc_cb alloccb,
                        uv_udp_recv_cb recv_cb);
 
+int uv__udp_recv_info_start(uv_udp_t* handle, unsigned int flags);
+
 int uv__udp_recv_stop(uv_udp_t* handle);
 
 void uv__fs_poll_close(uv_fs_poll_t* handle);
 
+int uv__fs_poll_sched_init(uv_loop_t* loop);
+
+void uv__fs_poll_sched_close(uv_loop_t* loop);
+
 int uv__getaddrinfo_translate_error(int sys_err);    /* EAI_* error. */
 
 enum uv__work_kind {
@@ -185,10 +239,30 @@ int uv__socket_sockopt(uv_handle_t* handle, int optname, int* value);
 
 void uv__fs_scandir_cleanup(uv_fs_t* req);
 
+int uv__fs_get_block_size(uv_file file, size_t* size);
+
 int uv__next_timeout(const uv_loop_t* loop);
 void uv__run_timers(uv_loop_t* loop);
 void uv__timer_close(uv_timer_t* handle);
 
+/* Loop state that was added after uv_loop_t's layout was frozen. It lives
+ * behind uv_loop_t.internal_fields so that the struct keeps its size.
+ */
+typedef struct uv__loop_internal_fields_s uv__loop_internal_fields_t;
+
+struct uv__loop_internal_fields_s {
+  void* fs_poll_sched;  /* See UV_LOOP_FS_POLL_BATCH. */
+#ifndef _WIN32
+  void* fs_sync_groups[2];
+  void* fs_write_queues[2];
+  void* corked_handles[2];
+  void* read_pool;
+#endif
+};
+
+#define uv__get_internal_fields(loop)                                         \
+  ((uv__loop_internal_fields_t*) (loop)->internal_fields)
+
 #define uv__has_active_reqs(loop)                                             \
   ((loop)->active_reqs.count > 0)
 
@@ -269,12 +343,29 @@ void uv__timer_close(uv_timer_t* handle);
 # define uv__handle_platform_init(h) ((h)->next_closing = NULL)
 #endif
 
+/* Handle state that was added after the layout of the handle types was
+ * frozen lives behind this pointer, so that they keep their size. It's the
+ * second of the reserved pointers in uv_handle_t, the first one is shared
+ * with u.fd. What it points to depends on the handle type.
+ */
+#define uv__handle_internal_fields(h)                                         \
+  ((h)->u.reserved[1])
+
+/* The internal fields of a UDP handle, allocated by uv_udp_recv_start_ex(). */
+typedef struct {
+  uv_udp_recv_ex_cb recv_ex_cb;
+} uv__udp_internal_fields_t;
+
+#define uv__udp_internal_fields(h)                                            \
+  ((uv__udp_internal_fields_t*) uv__handle_internal_fields(h))
+
 #define uv__handle_init(loop_, h, type_)                                      \
   do {                                                                        \
     (h)->loop = (loop_);                                                      \
     (h)->type = (type_);                                                      \
     (h)->flags = UV_HANDLE_REF;  /* Ref the loop when active. */              \
     QUEUE_INSERT_TAIL(&(loop_)->handle_queue, &(h)->handle_queue);            \
+    uv__handle_internal_fields(h) = NULL;                                     \
     uv__handle_platform_init(h);                                              \
   }                                                                           \
   while (0)
@@ -297,9 +388,16 @@ void uv__timer_close(uv_timer_t* handle);
   while (0)
 #endif
 
+/* Like uv__handle_internal_fields() but for requests, in the first of the
+ * reserved pointers of uv_req_t.
+ */
+#define uv__req_internal_fields(req)                                          \
+  ((req)->reserved[0])
+
 #define uv__req_init(loop, req, typ)                                          \
   do {                                                                        \
     UV_REQ_INIT(req, typ);                                                    \
+    uv__req_internal_fields(req) = NULL;                                      \
     uv__req_register(loop, req);                                              \
   }                                                                           \
   while (0)
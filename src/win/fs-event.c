@@ -161,6 +161,10 @@ int uv_fs_event_start(uv_fs_event_t* handle,
   if (uv__is_active(handle))
     return UV_EINVAL;
 
+  /* There is no file system wide change feed, watch the tree instead. */
+  if (flags & UV_FS_EVENT_MOUNT)
+    flags |= UV_FS_EVENT_RECURSIVE;
+
   handle->cb = cb;
   handle->path = uv__strdup(path);
   if (!handle->path) {
@@ -385,6 +389,11 @@ int uv_fs_event_stop(uv_fs_event_t* handle) {
 }
 
 
+int uv_fs_event_set_coalesce(uv_fs_event_t* handle, unsigned int window) {
+  return UV_ENOSYS;
+}
+
+
 static int file_info_cmp(WCHAR* str, WCHAR* file_name, size_t file_name_len) {
   size_t str_len;
 
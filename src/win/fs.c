@@ -690,6 +690,137 @@ void fs__read(uv_fs_t* req) {
 }
 
 
+/* The pool and the offsets to read from are stashed in
+ * req->fs.info.bufsml[1], see uv_fs_read_aligned().
+ */
+static void fs__read_aligned(uv_fs_t* req) {
+  size_t skip;
+  size_t len;
+
+  skip = req->fs.info.bufsml[1].len;
+  len = req->fs.info.bufsml[2].len;
+
+  fs__read(req);
+  if (req->result < 0)
+    return;
+
+  req->ptr = req->fs.info.bufsml[0].base + skip;
+
+  if ((size_t) req->result <= skip) {
+    req->result = 0;
+    return;
+  }
+
+  req->result -= skip;
+  if ((size_t) req->result > len)
+    req->result = len;
+}
+
+
+/* The ranges are stashed in req->fs.info.bufsml[0], see uv_fs_read_multi().
+ */
+static void fs__read_multi(uv_fs_t* req) {
+  int fd = req->file.fd;
+  uv_fs_read_range_t* range;
+  unsigned int nranges;
+  unsigned int i;
+  HANDLE handle;
+  OVERLAPPED overlapped;
+  LARGE_INTEGER offset_;
+  LARGE_INTEGER original_position;
+  LARGE_INTEGER zero_offset;
+  int restore_position;
+  DWORD bytes;
+  DWORD error;
+  ssize_t total;
+
+  VERIFY_FD(fd, req);
+
+  handle = uv__get_osfhandle(fd);
+  if (handle == INVALID_HANDLE_VALUE) {
+    SET_REQ_WIN32_ERROR(req, ERROR_INVALID_HANDLE);
+    return;
+  }
+
+  zero_offset.QuadPart = 0;
+  restore_position = SetFilePointerEx(handle,
+                                      zero_offset,
+                                      &original_position,
+                                      FILE_CURRENT);
+
+  range = (uv_fs_read_range_t*) req->fs.info.bufsml[0].base;
+  nranges = req->fs.info.bufsml[0].len;
+  total = 0;
+
+  for (i = 0; i < nranges; i++, range++) {
+    memset(&overlapped, 0, sizeof overlapped);
+    offset_.QuadPart = range->offset;
+    overlapped.Offset = offset_.LowPart;
+    overlapped.OffsetHigh = offset_.HighPart;
+
+    if (ReadFile(handle,
+                 range->buf.base,
+                 range->buf.len,
+                 &bytes,
+                 &overlapped)) {
+      range->result = bytes;
+      total += bytes;
+    } else {
+      error = GetLastError();
+      if (error == ERROR_HANDLE_EOF)
+        range->result = 0;
+      else
+        range->result = uv_translate_sys_error(error);
+    }
+  }
+
+  if (restore_position)
+    SetFilePointerEx(handle, original_position, NULL, FILE_BEGIN);
+
+  SET_REQ_RESULT(req, total);
+}
+
+
+int uv__fs_get_block_size(uv_file file, size_t* size) {
+  FILE_FS_SIZE_INFORMATION size_info;
+  FILE_ALIGNMENT_INFORMATION align_info;
+  IO_STATUS_BLOCK io_status;
+  NTSTATUS nt_status;
+  HANDLE handle;
+  size_t block_size;
+
+  handle = uv__get_osfhandle(file);
+  if (handle == INVALID_HANDLE_VALUE)
+    return UV_EBADF;
+
+  nt_status = pNtQueryVolumeInformationFile(handle,
+                                            &io_status,
+                                            &size_info,
+                                            sizeof size_info,
+                                            FileFsSizeInformation);
+  if (NT_ERROR(nt_status))
+    return uv_translate_sys_error(pRtlNtStatusToDosError(nt_status));
+
+  block_size = size_info.BytesPerSector;
+
+  /* Unbuffered I/O may require a stricter buffer alignment than the
+   * sector size, e.g. for some storage controllers.
+   */
+  nt_status = pNtQueryInformationFile(handle,
+                                      &io_status,
+                                      &align_info,
+                                      sizeof align_info,
+                                      FileAlignmentInformation);
+  if (NT_SUCCESS(nt_status) &&
+      align_info.AlignmentRequirement + 1 > block_size) {
+    block_size = align_info.AlignmentRequirement + 1;
+  }
+
+  *size = block_size > 0 ? block_size : 512;
+  return 0;
+}
+
+
 void fs__write(uv_fs_t* req) {
   int fd = req->file.fd;
   int64_t offset = req->fs.info.offset;
@@ -1419,6 +1550,78 @@ static void fs__ftruncate(uv_fs_t* req) {
 }
 
 
+static void fs__fadvise(uv_fs_t* req) {
+  SET_REQ_UV_ERROR(req, UV_ENOSYS, ERROR_NOT_SUPPORTED);
+}
+
+
+static void fs__readahead(uv_fs_t* req) {
+  SET_REQ_UV_ERROR(req, UV_ENOSYS, ERROR_NOT_SUPPORTED);
+}
+
+
+static void fs__fallocate(uv_fs_t* req) {
+  int fd = req->file.fd;
+  HANDLE handle;
+  NTSTATUS status;
+  IO_STATUS_BLOCK io_status;
+  FILE_STANDARD_INFORMATION std_info;
+  FILE_ALLOCATION_INFORMATION alloc_info;
+  FILE_END_OF_FILE_INFORMATION eof_info;
+  int64_t end;
+
+  VERIFY_FD(fd, req);
+
+  if (req->fs.info.file_flags & UV_FS_FALLOCATE_PUNCH_HOLE) {
+    SET_REQ_UV_ERROR(req, UV_ENOSYS, ERROR_NOT_SUPPORTED);
+    return;
+  }
+
+  handle = uv__get_osfhandle(fd);
+  end = req->fs.info.offset + req->fs.info.bufsml[0].len;
+
+  status = pNtQueryInformationFile(handle,
+                                   &io_status,
+                                   &std_info,
+                                   sizeof std_info,
+                                   FileStandardInformation);
+  if (!NT_SUCCESS(status)) {
+    SET_REQ_WIN32_ERROR(req, pRtlNtStatusToDosError(status));
+    return;
+  }
+
+  /* Shrinking the allocation size truncates the file, only ever grow it. */
+  if (end > std_info.AllocationSize.QuadPart) {
+    alloc_info.AllocationSize.QuadPart = end;
+    status = pNtSetInformationFile(handle,
+                                   &io_status,
+                                   &alloc_info,
+                                   sizeof alloc_info,
+                                   FileAllocationInformation);
+    if (!NT_SUCCESS(status)) {
+      SET_REQ_WIN32_ERROR(req, pRtlNtStatusToDosError(status));
+      return;
+    }
+  }
+
+  if (!(req->fs.info.file_flags & UV_FS_FALLOCATE_KEEP_SIZE) &&
+      end > std_info.EndOfFile.QuadPart) {
+    eof_info.EndOfFile.QuadPart = end;
+    status = pNtSetInformationFile(handle,
+                                   &io_status,
+                                   &eof_info,
+                                   sizeof eof_info,
+                                   FileEndOfFileInformation);
+    if (!NT_SUCCESS(status)) {
+      SET_REQ_WIN32_ERROR(req, pRtlNtStatusToDosError(status));
+      return;
+    }
+  }
+
+  SET_REQ_RESULT(req, 0);
+}
+
+
 static void fs__copyfile(uv_fs_t* req) {
   int flags;
   int overwrite;
@@ -2019,6 +2222,8 @@ static void uv__fs_work(struct uv__work* w) {
     XX(OPEN, open)
     XX(CLOSE, close)
     XX(READ, read)
+    XX(READ_ALIGNED, read_aligned)
+    XX(READ_MULTI, read_multi)
     XX(WRITE, write)
     XX(COPYFILE, copyfile)
     XX(SENDFILE, sendfile)
@@ -2026,6 +2231,9 @@ static void uv__fs_work(struct uv__work* w) {
     XX(LSTAT, lstat)
     XX(FSTAT, fstat)
     XX(FTRUNCATE, ftruncate)
+    XX(FADVISE, fadvise)
+    XX(READAHEAD, readahead)
+    XX(FALLOCATE, fallocate)
     XX(UTIME, utime)
     XX(FUTIME, futime)
     XX(ACCESS, access)
@@ -2084,6 +2292,14 @@ void uv_fs_req_cleanup(uv_fs_t* req) {
       uv__free(req->ptr);
   }
 
+  /* req->ptr points into the pool buffer. */
+  if (req->fs_type == UV_FS_READ_ALIGNED &&
+      req->fs.info.bufsml[0].base != NULL) {
+    uv_fs_buf_pool_free((uv_fs_buf_pool_t*) req->fs.info.bufsml[1].base,
+                        req->fs.info.bufsml[0]);
+    req->fs.info.bufsml[0].base = NULL;
+  }
+
   if (req->fs.info.bufs != req->fs.info.bufsml)
     uv__free(req->fs.info.bufs);
 
@@ -2149,6 +2365,73 @@ int uv_fs_read(uv_loop_t* loop,
 }
 
 
+int uv_fs_read_aligned(uv_loop_t* loop,
+                       uv_fs_t* req,
+                       uv_fs_buf_pool_t* pool,
+                       uv_file fd,
+                       int64_t offset,
+                       size_t length,
+                       uv_fs_cb cb) {
+  uint64_t start;
+  uint64_t end;
+  uv_buf_t buf;
+  int err;
+
+  INIT(UV_FS_READ_ALIGNED);
+
+  if (pool == NULL || offset < 0 || length == 0)
+    return UV_EINVAL;
+
+  start = offset & ~(uint64_t) (pool->block_size - 1);
+  end = ((uint64_t) offset + length + pool->block_size - 1) &
+        ~(uint64_t) (pool->block_size - 1);
+
+  if (end - start > pool->buf_size)
+    return UV_EINVAL;
+
+  err = uv_fs_buf_pool_alloc(pool, &buf);
+  if (err)
+    return err;
+
+  req->file.fd = fd;
+  req->fs.info.offset = start;
+  req->fs.info.bufsml[0].base = buf.base;
+  req->fs.info.bufsml[0].len = (ULONG) (end - start);
+  req->fs.info.bufsml[1].base = (char*) pool;  /* hack */
+  req->fs.info.bufsml[1].len = (ULONG) (offset - start);
+  req->fs.info.bufsml[2].len = (ULONG) length;
+  req->fs.info.bufs = req->fs.info.bufsml;
+  req->fs.info.nbufs = 1;
+  POST;
+}
+
+
+int uv_fs_read_multi(uv_loop_t* loop,
+                     uv_fs_t* req,
+                     uv_file fd,
+                     uv_fs_read_range_t ranges[],
+                     unsigned int nranges,
+                     uv_fs_cb cb) {
+  unsigned int i;
+
+  INIT(UV_FS_READ_MULTI);
+
+  if (ranges == NULL || nranges == 0)
+    return UV_EINVAL;
+
+  for (i = 0; i < nranges; i++) {
+    if (ranges[i].offset < 0)
+      return UV_EINVAL;
+    ranges[i].result = 0;
+  }
+
+  req->file.fd = fd;
+  req->fs.info.bufsml[0].base = (char*) ranges;  /* hack */
+  req->fs.info.bufsml[0].len = nranges;
+  POST;
+}
+
+
 int uv_fs_write(uv_loop_t* loop,
                 uv_fs_t* req,
                 uv_file fd,
@@ -2414,6 +2697,56 @@ int uv_fs_ftruncate(uv_loop_t* loop, uv_fs_t* req, uv_file fd,
 }
 
 
+int uv_fs_fadvise(uv_loop_t* loop, uv_fs_t* req, uv_file fd,
+    int64_t offset, int64_t length, int advice, uv_fs_cb cb) {
+  INIT(UV_FS_FADVISE);
+
+  if (advice < UV_FS_FADV_NORMAL || advice > UV_FS_FADV_NOREUSE)
+    return UV_EINVAL;
+
+  if (offset < 0 || length < 0 || (uint64_t) length > (size_t) -1)
+    return UV_EINVAL;
+
+  req->file.fd = fd;
+  req->fs.info.offset = offset;
+  req->fs.info.bufsml[0].len = (size_t) length;
+  req->fs.info.file_flags = advice;
+  POST;
+}
+
+
+int uv_fs_readahead(uv_loop_t* loop, uv_fs_t* req, uv_file fd,
+    int64_t offset, size_t length, uv_fs_cb cb) {
+  INIT(UV_FS_READAHEAD);
+
+  if (offset < 0)
+    return UV_EINVAL;
+
+  req->file.fd = fd;
+  req->fs.info.offset = offset;
+  req->fs.info.bufsml[0].len = length;
+  POST;
+}
+
+
+int uv_fs_fallocate(uv_loop_t* loop, uv_fs_t* req, uv_file fd, int mode,
+    int64_t offset, int64_t length, uv_fs_cb cb) {
+  INIT(UV_FS_FALLOCATE);
+
+  if (mode & ~(UV_FS_FALLOCATE_KEEP_SIZE | UV_FS_FALLOCATE_PUNCH_HOLE))
+    return UV_EINVAL;
+
+  if (offset < 0 || length <= 0 || (uint64_t) length > (size_t) -1)
+    return UV_EINVAL;
+
+  req->file.fd = fd;
+  req->fs.info.offset = offset;
+  req->fs.info.bufsml[0].len = (size_t) length;
+  req->fs.info.file_flags = mode;
+  POST;
+}
+
+
 int uv_fs_copyfile(uv_loop_t* loop,
                    uv_fs_t* req,
                    const char* path,
@@ -46,6 +46,18 @@ int uv_listen(uv_stream_t* stream, int backlog, uv_connection_cb cb) {
 }
 
 
+int uv_listen_batch(uv_stream_t* stream,
+                    int backlog,
+                    uv_connection_batch_cb cb) {
+  return UV_ENOSYS;
+}
+
+
+int uv_stream_set_accept_budget(uv_stream_t* stream, unsigned int budget) {
+  return UV_ENOSYS;
+}
+
+
 int uv_accept(uv_stream_t* server, uv_stream_t* client) {
   int err;
 
@@ -96,6 +108,12 @@ int uv_read_start(uv_stream_t* handle, uv_alloc_cb alloc_cb,
 }
 
 
+int uv_read_start_pooled(uv_stream_t* handle, uv_read_cb read_cb) {
+  /* Non-zero reads stay pending with their buffer, they can't share one. */
+  return UV_ENOTSUP;
+}
+
+
 int uv_read_stop(uv_stream_t* handle) {
   int err;
 
@@ -173,6 +191,34 @@ int uv_write2(uv_write_t* req,
 }
 
 
+int uv_write_zerocopy(uv_write_t* req,
+                      uv_stream_t* handle,
+                      const uv_buf_t bufs[],
+                      unsigned int nbufs,
+                      uv_write_cb cb) {
+  /* There is no MSG_ZEROCOPY equivalent, do a regular write. */
+  return uv_write(req, handle, bufs, nbufs, cb);
+}
+
+
+int uv_stream_sendfile(uv_write_t* req,
+                       uv_stream_t* handle,
+                       uv_file file,
+                       int64_t offset,
+                       size_t length,
+                       uv_write_cb cb) {
+  return UV_ENOSYS;
+}
+
+
+int uv_stream_pipe_to(uv_stream_pipe_t* req,
+                      uv_stream_t* src,
+                      uv_stream_t* dst,
+                      uv_stream_pipe_cb cb) {
+  return UV_ENOSYS;
+}
+
+
 int uv_try_write(uv_stream_t* stream,
                  const uv_buf_t bufs[],
                  unsigned int nbufs) {
@@ -227,6 +273,14 @@ int uv_is_writable(const uv_stream_t* handle) {
 }
 
 
+int uv_stream_set_write_queue_limits(uv_stream_t* stream,
+                                     size_t high,
+                                     size_t low,
+                                     uv_write_queue_cb cb) {
+  return UV_ENOSYS;
+}
+
+
 int uv_stream_set_blocking(uv_stream_t* handle, int blocking) {
   if (handle->type != UV_NAMED_PIPE)
     return UV_EINVAL;
@@ -1285,6 +1285,27 @@ int uv_tcp_nodelay(uv_tcp_t* handle, int enable) {
 }
 
 
+int uv_tcp_enable_stats(uv_tcp_t* handle) {
+  return UV_ENOTSUP;
+}
+
+
+int uv_tcp_get_info(const uv_tcp_t* handle, uv_tcp_info_t* info) {
+  memset(info, 0, sizeof(*info));
+  return UV_ENOTSUP;
+}
+
+
+int uv_tcp_fastopen(uv_tcp_t* handle, int queue_len) {
+  return UV_ENOTSUP;
+}
+
+
+int uv_tcp_batch_writes(uv_tcp_t* handle, int enable) {
+  return UV_ENOTSUP;
+}
+
+
 int uv_tcp_keepalive(uv_tcp_t* handle, int enable, unsigned int delay) {
   int err;
 
@@ -1499,6 +1520,10 @@ int uv__tcp_bind(uv_tcp_t* handle,
                  unsigned int flags) {
   int err;
 
+  /* Windows has no load-balanced port sharing for TCP. */
+  if (flags & UV_TCP_REUSEPORT)
+    return UV_ENOTSUP;
+
   err = uv_tcp_try_bind(handle, addr, addrlen, flags);
   if (err)
     return uv_translate_sys_error(err);
@@ -1523,3 +1548,16 @@ int uv__tcp_connect(uv_connect_t* req,
 
   return 0;
 }
+
+
+int uv__tcp_connect_fastopen(uv_connect_t* req,
+                             uv_tcp_t* handle,
+                             const struct sockaddr* addr,
+                             unsigned int addrlen,
+                             uv_write_t* write_req,
+                             const uv_buf_t bufs[],
+                             unsigned int nbufs,
+                             uv_connect_cb cb,
+                             uv_write_cb write_cb) {
+  return UV_ENOSYS;
+}
@@ -0,0 +1,191 @@
+/* Copyright libuv project contributors. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include "task.h"
+#include "uv.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define FILE_NAME   "fs_read_bench_file"
+#define FILE_SIZE   (64 * 1024 * 1024)
+#define CHUNK_SIZE  (64 * 1024)
+#define NUM_ROUNDS  4
+
+static uv_loop_t* loop;
+static uv_fs_t read_req;
+static uv_buf_t read_buf;
+static uv_file file;
+static int64_t read_pos;
+
+
+static void create_file(void) {
+  uv_fs_t req;
+  uv_buf_t buf;
+  int64_t pos;
+  int r;
+
+  r = uv_fs_open(NULL,
+                 &req,
+                 FILE_NAME,
+                 UV_FS_O_RDWR | UV_FS_O_CREAT | UV_FS_O_TRUNC,
+                 0644,
+                 NULL);
+  ASSERT(r >= 0);
+  file = r;
+  uv_fs_req_cleanup(&req);
+
+  buf = uv_buf_init(malloc(CHUNK_SIZE), CHUNK_SIZE);
+  ASSERT(buf.base != NULL);
+  memset(buf.base, 'x', buf.len);
+
+  for (pos = 0; pos < FILE_SIZE; pos += CHUNK_SIZE) {
+    r = uv_fs_write(NULL, &req, file, &buf, 1, pos, NULL);
+    ASSERT(r == CHUNK_SIZE);
+    uv_fs_req_cleanup(&req);
+  }
+
+  /* Clean pages can be evicted with UV_FS_FADV_DONTNEED. */
+  r = uv_fs_fdatasync(NULL, &req, file, NULL);
+  ASSERT(r == 0);
+  uv_fs_req_cleanup(&req);
+
+  free(buf.base);
+}
+
+
+static void drop_cache(void) {
+  uv_fs_t req;
+  int r;
+
+  r = uv_fs_fadvise(NULL,
+                    &req,
+                    file,
+                    0,
+                    0,
+                    UV_FS_FADV_DONTNEED,
+                    NULL);
+  ASSERT(r == 0 || r == UV_ENOSYS);
+  uv_fs_req_cleanup(&req);
+}
+
+
+static void read_cb(uv_fs_t* req) {
+  int r;
+
+  ASSERT(req->result > 0);
+  read_pos += req->result;
+  uv_fs_req_cleanup(req);
+
+  if (read_pos >= FILE_SIZE)
+    return;
+
+  r = uv_fs_read(loop, &read_req, file, &read_buf, 1, read_pos, read_cb);
+  ASSERT(r == 0);
+}
+
+
+static double read_file(int hinted) {
+  uint64_t before;
+  uint64_t after;
+  uv_fs_t req;
+  int r;
+
+  drop_cache();
+  read_pos = 0;
+
+  before = uv_hrtime();
+
+  if (hinted) {
+    r = uv_fs_fadvise(NULL,
+                      &req,
+                      file,
+                      0,
+                      0,
+                      UV_FS_FADV_SEQUENTIAL,
+                      NULL);
+    ASSERT(r == 0 || r == UV_ENOSYS);
+    uv_fs_req_cleanup(&req);
+
+    r = uv_fs_readahead(loop, &req, file, 0, FILE_SIZE, uv_fs_req_cleanup);
+    ASSERT(r == 0);
+  }
+
+  r = uv_fs_read(loop, &read_req, file, &read_buf, 1, 0, read_cb);
+  ASSERT(r == 0);
+  uv_run(loop, UV_RUN_DEFAULT);
+
+  after = uv_hrtime();
+
+  if (hinted) {
+    /* Restore the default read-ahead window for the next round. */
+    r = uv_fs_fadvise(NULL, &req, file, 0, 0, UV_FS_FADV_NORMAL, NULL);
+    ASSERT(r == 0 || r == UV_ENOSYS);
+    uv_fs_req_cleanup(&req);
+  }
+
+  return (after - before) / 1e9;
+}
+
+
+/* This benchmark measures sequential read throughput from a cold page cache,
+ * once with plain reads and once after telling the kernel about the access
+ * pattern with uv_fs_fadvise() and uv_fs_readahead().
+ */
+BENCHMARK_IMPL(fs_read_sequential) {
+  double plain;
+  double hinted;
+  uv_fs_t req;
+  int i;
+
+  loop = uv_default_loop();
+  read_buf = uv_buf_init(malloc(CHUNK_SIZE), CHUNK_SIZE);
+  ASSERT(read_buf.base != NULL);
+
+  create_file();
+
+  plain = 0;
+  hinted = 0;
+  for (i = 0; i < NUM_ROUNDS; i++) {
+    plain += read_file(0);
+    hinted += read_file(1);
+  }
+
+  printf("%s bytes sequential (no hints): %.2fs (%s/s)\n",
+         fmt(1.0 * FILE_SIZE * NUM_ROUNDS),
+         plain,
+         fmt(FILE_SIZE * NUM_ROUNDS / plain));
+  printf("%s bytes sequential (fadvise + readahead): %.2fs (%s/s)\n",
+         fmt(1.0 * FILE_SIZE * NUM_ROUNDS),
+         hinted,
+         fmt(FILE_SIZE * NUM_ROUNDS / hinted));
+  fflush(stdout);
+
+  uv_fs_close(NULL, &req, file, NULL);
+  uv_fs_req_cleanup(&req);
+  uv_fs_unlink(NULL, &req, FILE_NAME, NULL);
+  uv_fs_req_cleanup(&req);
+  free(read_buf.base);
+
+  MAKE_VALGRIND_HAPPY();
+  return 0;
+}
@@ -24,6 +24,12 @@ BENCHMARK_DECLARE (loop_count)
 BENCHMARK_DECLARE (loop_count_timed)
 BENCHMARK_DECLARE (ping_pongs)
 BENCHMARK_DECLARE (tcp_write_batch)
+BENCHMARK_DECLARE (tcp_write_batch_queued)
+BENCHMARK_DECLARE (tcp_proxy_copy)
+BENCHMARK_DECLARE (tcp_proxy_splice)
+BENCHMARK_DECLARE (tcp_accept_unlimited)
+BENCHMARK_DECLARE (tcp_accept_budget)
+BENCHMARK_DECLARE (tcp_accept_batch)
 BENCHMARK_DECLARE (tcp4_pound_100)
 BENCHMARK_DECLARE (tcp4_pound_1000)
 BENCHMARK_DECLARE (pipe_pound_100)
@@ -36,6 +42,9 @@ BENCHMARK_DECLARE (pipe_pump1_client)
 BENCHMARK_DECLARE (tcp_multi_accept2)
 BENCHMARK_DECLARE (tcp_multi_accept4)
 BENCHMARK_DECLARE (tcp_multi_accept8)
+BENCHMARK_DECLARE (tcp_reuseport_accept2)
+BENCHMARK_DECLARE (tcp_reuseport_accept4)
+BENCHMARK_DECLARE (tcp_reuseport_accept8)
 
 /* Run until X packets have been sent/received. */
 BENCHMARK_DECLARE (udp_pummel_1v1)
@@ -60,9 +69,14 @@ BENCHMARK_DECLARE (udp_timed_pummel_10v1000)
 BENCHMARK_DECLARE (udp_timed_pummel_100v100)
 BENCHMARK_DECLARE (udp_timed_pummel_100v1000)
 BENCHMARK_DECLARE (udp_timed_pummel_1000v1000)
+BENCHMARK_DECLARE (udp_timed_pummel_100v10)
+BENCHMARK_DECLARE (udp_timed_pummel_mmsg_1v1)
+BENCHMARK_DECLARE (udp_timed_pummel_mmsg_100v10)
+BENCHMARK_DECLARE (udp_timed_pummel_mmsg_1000v1000)
 
 BENCHMARK_DECLARE (getaddrinfo)
 BENCHMARK_DECLARE (fs_stat)
+BENCHMARK_DECLARE (fs_read_sequential)
 BENCHMARK_DECLARE (async1)
 BENCHMARK_DECLARE (async2)
 BENCHMARK_DECLARE (async4)
@@ -92,6 +106,15 @@ TASK_LIST_START
 
   BENCHMARK_ENTRY  (tcp_write_batch)
   BENCHMARK_HELPER (tcp_write_batch, tcp4_blackhole_server)
+  BENCHMARK_ENTRY  (tcp_write_batch_queued)
+  BENCHMARK_HELPER (tcp_write_batch_queued, tcp4_blackhole_server)
+
+  BENCHMARK_ENTRY  (tcp_proxy_copy)
+  BENCHMARK_ENTRY  (tcp_proxy_splice)
+
+  BENCHMARK_ENTRY  (tcp_accept_unlimited)
+  BENCHMARK_ENTRY  (tcp_accept_budget)
+  BENCHMARK_ENTRY  (tcp_accept_batch)
 
   BENCHMARK_ENTRY  (tcp_pump100_client)
   BENCHMARK_HELPER (tcp_pump100_client, tcp_pump_server)
@@ -120,6 +143,9 @@ TASK_LIST_START
   BENCHMARK_ENTRY  (tcp_multi_accept2)
   BENCHMARK_ENTRY  (tcp_multi_accept4)
   BENCHMARK_ENTRY  (tcp_multi_accept8)
+  BENCHMARK_ENTRY  (tcp_reuseport_accept2)
+  BENCHMARK_ENTRY  (tcp_reuseport_accept4)
+  BENCHMARK_ENTRY  (tcp_reuseport_accept8)
 
   BENCHMARK_ENTRY  (udp_pummel_1v1)
   BENCHMARK_ENTRY  (udp_pummel_1v10)
@@ -142,10 +168,15 @@ TASK_LIST_START
   BENCHMARK_ENTRY  (udp_timed_pummel_100v100)
   BENCHMARK_ENTRY  (udp_timed_pummel_100v1000)
   BENCHMARK_ENTRY  (udp_timed_pummel_1000v1000)
+  BENCHMARK_ENTRY  (udp_timed_pummel_100v10)
+  BENCHMARK_ENTRY  (udp_timed_pummel_mmsg_1v1)
+  BENCHMARK_ENTRY  (udp_timed_pummel_mmsg_100v10)
+  BENCHMARK_ENTRY  (udp_timed_pummel_mmsg_1000v1000)
 
   BENCHMARK_ENTRY  (getaddrinfo)
 
   BENCHMARK_ENTRY  (fs_stat)
+  BENCHMARK_ENTRY  (fs_read_sequential)
 
   BENCHMARK_ENTRY  (async1)
   BENCHMARK_ENTRY  (async2)
@@ -63,6 +63,10 @@ struct ipc_client_ctx {
   char scratch[16];
 };
 
+/* With UV_TCP_REUSEPORT none of the above is needed: every worker binds its
+ * own listen socket and the kernel spreads incoming connections over them.
+ */
+
 /* Used in the actual benchmark. */
 struct server_ctx {
   handle_storage_t server_handle;
@@ -102,6 +106,7 @@ static void cl_idle_cb(uv_idle_t* handle);
 static void cl_close_cb(uv_handle_t* handle);
 
 static struct sockaddr_in listen_addr;
+static int use_reuseport;
 
 
 static void ipc_connection_cb(uv_stream_t* ipc_pipe, int status) {
@@ -260,15 +265,29 @@ static void server_cb(void *arg) {
   ASSERT(0 == uv_async_init(&loop, &ctx->async_handle, sv_async_cb));
   uv_unref((uv_handle_t*) &ctx->async_handle);
 
-  /* Wait until the main thread is ready. */
-  uv_sem_wait(&ctx->semaphore);
-  get_listen_handle(&loop, (uv_stream_t*) &ctx->server_handle);
-  uv_sem_post(&ctx->semaphore);
-
-  /* Now start the actual benchmark. */
-  ASSERT(0 == uv_listen((uv_stream_t*) &ctx->server_handle,
-                        128,
-                        sv_connection_cb));
+  if (use_reuseport) {
+    /* Start listening before the main thread starts connecting, otherwise
+     * the first worker to bind would get all of the early connections.
+     */
+    ASSERT(0 == uv_tcp_init(&loop, (uv_tcp_t*) &ctx->server_handle));
+    ASSERT(0 == uv_tcp_bind((uv_tcp_t*) &ctx->server_handle,
+                            (const struct sockaddr*) &listen_addr,
+                            UV_TCP_REUSEPORT));
+    ASSERT(0 == uv_listen((uv_stream_t*) &ctx->server_handle,
+                          128,
+                          sv_connection_cb));
+    uv_sem_post(&ctx->semaphore);
+  } else {
+    /* Wait until the main thread is ready. */
+    uv_sem_wait(&ctx->semaphore);
+    get_listen_handle(&loop, (uv_stream_t*) &ctx->server_handle);
+    uv_sem_post(&ctx->semaphore);
+
+    /* Now start the actual benchmark. */
+    ASSERT(0 == uv_listen((uv_stream_t*) &ctx->server_handle,
+                          128,
+                          sv_connection_cb));
+  }
   ASSERT(0 == uv_run(&loop, UV_RUN_DEFAULT));
 
   uv_loop_close(&loop);
@@ -355,7 +374,28 @@ static void cl_close_cb(uv_handle_t* handle) {
 }
 
 
-static int test_tcp(unsigned int num_servers, unsigned int num_clients) {
+static int reuseport_supported(void) {
+  uv_tcp_t handle;
+  int r;
+
+  ASSERT(0 == uv_tcp_init(uv_default_loop(), &handle));
+  r = uv_tcp_bind(&handle,
+                  (const struct sockaddr*) &listen_addr,
+                  UV_TCP_REUSEPORT);
+  uv_close((uv_handle_t*) &handle, NULL);
+  ASSERT(0 == uv_run(uv_default_loop(), UV_RUN_DEFAULT));
+
+  if (r == UV_ENOTSUP)
+    return 0;
+
+  ASSERT(r == 0);
+  return 1;
+}
+
+
+static int test_tcp(unsigned int num_servers,
+                    unsigned int num_clients,
+                    int reuseport) {
   struct server_ctx* servers;
   struct client_ctx* clients;
   uv_loop_t* loop;
@@ -366,6 +406,14 @@ static int test_tcp(unsigned int num_servers, unsigned int num_clients) {
   ASSERT(0 == uv_ip4_addr("127.0.0.1", TEST_PORT, &listen_addr));
   loop = uv_default_loop();
 
+  use_reuseport = reuseport;
+  if (use_reuseport && !reuseport_supported()) {
+    fprintf(stderr, "UV_TCP_REUSEPORT is not supported, skipping.\n");
+    fflush(stderr);
+    MAKE_VALGRIND_HAPPY();
+    return 0;
+  }
+
   servers = calloc(num_servers, sizeof(servers[0]));
   clients = calloc(num_clients, sizeof(clients[0]));
   ASSERT(servers != NULL);
@@ -381,7 +429,12 @@ static int test_tcp(unsigned int num_servers, unsigned int num_clients) {
     ASSERT(0 == uv_thread_create(&ctx->thread_id, server_cb, ctx));
   }
 
-  send_listen_handles(UV_TCP, num_servers, servers);
+  if (use_reuseport) {
+    for (i = 0; i < num_servers; i++)
+      uv_sem_wait(&servers[i].semaphore);
+  } else {
+    send_listen_handles(UV_TCP, num_servers, servers);
+  }
 
   for (i = 0; i < num_clients; i++) {
     struct client_ctx* ctx = clients + i;
@@ -410,8 +463,9 @@ static int test_tcp(unsigned int num_servers, unsigned int num_clients) {
     uv_sem_destroy(&ctx->semaphore);
   }
 
-  printf("accept%u: %.0f accepts/sec (%u total)\n",
+  printf("accept%u%s: %.0f accepts/sec (%u total)\n",
          num_servers,
+         use_reuseport ? " (reuseport)" : "",
          NUM_CONNECTS / time,
          NUM_CONNECTS);
 
@@ -433,15 +487,30 @@ static int test_tcp(unsigned int num_servers, unsigned int num_clients) {
 
 
 BENCHMARK_IMPL(tcp_multi_accept2) {
-  return test_tcp(2, 40);
+  return test_tcp(2, 40, 0);
 }
 
 
 BENCHMARK_IMPL(tcp_multi_accept4) {
-  return test_tcp(4, 40);
+  return test_tcp(4, 40, 0);
 }
 
 
 BENCHMARK_IMPL(tcp_multi_accept8) {
-  return test_tcp(8, 40);
+  return test_tcp(8, 40, 0);
+}
+
+
+BENCHMARK_IMPL(tcp_reuseport_accept2) {
+  return test_tcp(2, 40, 1);
+}
+
+
+BENCHMARK_IMPL(tcp_reuseport_accept4) {
+  return test_tcp(4, 40, 1);
+}
+
+
+BENCHMARK_IMPL(tcp_reuseport_accept8) {
+  return test_tcp(8, 40, 1);
 }
@@ -0,0 +1,340 @@
+/* Copyright libuv project contributors. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include "uv.h"
+#include "task.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/* Threads open and close connections to the server as fast as they can,
+ * while a connection that was established beforehand plays ping-pong with
+ * the server on the server's loop. The accept rate shows how fast the storm
+ * is absorbed, the ping rate how much the established connection suffers.
+ */
+#define NUM_CONNECTS    40000
+#define NUM_THREADS     4
+#define CONCURRENCY     64  /* Connections in flight per thread. */
+#define BUDGET          16
+
+struct storm_ctx {
+  uv_loop_t loop;
+  uv_thread_t thread;
+  uv_tcp_t clients[CONCURRENCY];
+  uv_connect_t connect_reqs[CONCURRENCY];
+  unsigned int started;
+  unsigned int finished;
+};
+
+typedef enum {
+  MODE_UNLIMITED,
+  MODE_BUDGET,
+  MODE_BATCH
+} accept_mode_t;
+
+static uv_loop_t* loop;
+static uv_tcp_t server;
+static uv_tcp_t ping_listener;
+static uv_tcp_t ping_client;
+static uv_tcp_t ping_server;
+static uv_connect_t ping_connect_req;
+static uv_write_t ping_write_req;
+static uv_write_t pong_write_req;
+static uv_async_t done_async;
+static struct storm_ctx storms[NUM_THREADS];
+static uv_mutex_t storms_mutex;
+static int storms_finished;
+static struct sockaddr_in addr;
+static struct sockaddr_in ping_addr;
+
+static char ping_byte = 'p';
+static unsigned int accepted;
+static unsigned int pings;
+static int ping_connected;
+static int storms_done;
+static int storming;
+static uint64_t start_time;
+static uint64_t end_time;
+
+
+static void storm_connect(struct storm_ctx* ctx, int i);
+
+
+static void alloc_cb(uv_handle_t* handle, size_t size, uv_buf_t* buf) {
+  static char slab[64];
+  buf->base = slab;
+  buf->len = sizeof(slab);
+}
+
+
+static void free_close_cb(uv_handle_t* handle) {
+  free(handle);
+}
+
+
+static void storm_close_cb(uv_handle_t* handle) {
+  struct storm_ctx* ctx;
+  int i;
+
+  ctx = handle->loop->data;
+  i = (uv_tcp_t*) handle - ctx->clients;
+  if (ctx->started < NUM_CONNECTS / NUM_THREADS)
+    storm_connect(ctx, i);
+  else if (++ctx->finished == CONCURRENCY) {
+    uv_mutex_lock(&storms_mutex);
+    storms_finished++;
+    uv_mutex_unlock(&storms_mutex);
+    uv_async_send(&done_async);
+  }
+}
+
+
+static void storm_connect_cb(uv_connect_t* req, int status) {
+  ASSERT(status == 0);
+  uv_close((uv_handle_t*) req->handle, storm_close_cb);
+}
+
+
+static void storm_connect(struct storm_ctx* ctx, int i) {
+  ctx->started++;
+  ASSERT(0 == uv_tcp_init(&ctx->loop, &ctx->clients[i]));
+  ASSERT(0 == uv_tcp_connect(&ctx->connect_reqs[i],
+                             &ctx->clients[i],
+                             (const struct sockaddr*) &addr,
+                             storm_connect_cb));
+}
+
+
+static void storm_thread_cb(void* arg) {
+  struct storm_ctx* ctx;
+  int i;
+
+  ctx = arg;
+  ctx->started = 0;
+  ctx->finished = 0;
+  ASSERT(0 == uv_loop_init(&ctx->loop));
+  ctx->loop.data = ctx;
+
+  for (i = 0; i < CONCURRENCY; i++)
+    storm_connect(ctx, i);
+
+  ASSERT(0 == uv_run(&ctx->loop, UV_RUN_DEFAULT));
+  ASSERT(0 == uv_loop_close(&ctx->loop));
+}
+
+
+/* A storm thread is done when its connections are, the server may still
+ * have some of them in the backlog.
+ */
+static void maybe_finish(void) {
+  if (storms_done < NUM_THREADS || accepted < NUM_CONNECTS)
+    return;
+
+  end_time = uv_hrtime();
+  storming = 0;
+  uv_close((uv_handle_t*) &done_async, NULL);
+  uv_close((uv_handle_t*) &server, NULL);
+  uv_close((uv_handle_t*) &ping_listener, NULL);
+  uv_close((uv_handle_t*) &ping_client, NULL);
+  uv_close((uv_handle_t*) &ping_server, NULL);
+}
+
+
+static void done_async_cb(uv_async_t* handle) {
+  /* Sends from several threads can coalesce into one callback. */
+  uv_mutex_lock(&storms_mutex);
+  storms_done = storms_finished;
+  uv_mutex_unlock(&storms_mutex);
+
+  maybe_finish();
+}
+
+
+static void close_accepted(uv_tcp_t* conn) {
+  uv_close((uv_handle_t*) conn, free_close_cb);
+}
+
+
+static void connection_cb(uv_stream_t* stream, int status) {
+  uv_tcp_t* conn;
+
+  ASSERT(status == 0);
+  conn = malloc(sizeof(*conn));
+  ASSERT(conn != NULL);
+  ASSERT(0 == uv_tcp_init(loop, conn));
+  ASSERT(0 == uv_accept(stream, (uv_stream_t*) conn));
+  close_accepted(conn);
+  accepted++;
+  maybe_finish();
+}
+
+
+static void batch_cb(uv_stream_t* stream,
+                     const uv_os_fd_t fds[],
+                     unsigned int nfds,
+                     int status) {
+  unsigned int i;
+  uv_tcp_t* conn;
+
+  ASSERT(status == 0);
+  for (i = 0; i < nfds; i++) {
+    conn = malloc(sizeof(*conn));
+    ASSERT(conn != NULL);
+    ASSERT(0 == uv_tcp_init(loop, conn));
+    ASSERT(0 == uv_tcp_open(conn, fds[i]));
+    close_accepted(conn);
+  }
+  accepted += nfds;
+  maybe_finish();
+}
+
+
+static void write_cb(uv_write_t* req, int status) {
+  ASSERT(status == 0 || status == UV_ECANCELED);
+}
+
+
+static void ping(uv_tcp_t* from, uv_write_t* req) {
+  uv_buf_t buf;
+
+  buf = uv_buf_init(&ping_byte, 1);
+  ASSERT(0 == uv_write(req, (uv_stream_t*) from, &buf, 1, write_cb));
+}
+
+
+static void ping_read_cb(uv_stream_t* stream,
+                         ssize_t nread,
+                         const uv_buf_t* buf) {
+  if (nread <= 0 || !storming)
+    return;
+
+  if (stream == (uv_stream_t*) &ping_server) {
+    ping(&ping_server, &pong_write_req);
+  } else {
+    pings++;
+    ping(&ping_client, &ping_write_req);
+  }
+}
+
+
+static void ping_connection_cb(uv_stream_t* stream, int status) {
+  ASSERT(status == 0);
+  ASSERT(0 == uv_tcp_init(loop, &ping_server));
+  ASSERT(0 == uv_accept(stream, (uv_stream_t*) &ping_server));
+  ASSERT(0 == uv_read_start((uv_stream_t*) &ping_server,
+                            alloc_cb,
+                            ping_read_cb));
+  ping_connected++;
+}
+
+
+static void ping_connect_cb(uv_connect_t* req, int status) {
+  ASSERT(status == 0);
+  ASSERT(0 == uv_read_start((uv_stream_t*) &ping_client,
+                            alloc_cb,
+                            ping_read_cb));
+  ping_connected++;
+}
+
+
+static int run_benchmark(accept_mode_t mode, const char* name) {
+  double secs;
+  int i;
+
+  loop = uv_default_loop();
+  accepted = 0;
+  pings = 0;
+  ping_connected = 0;
+  storms_done = 0;
+  storms_finished = 0;
+  ASSERT(0 == uv_mutex_init(&storms_mutex));
+
+  ASSERT(0 == uv_ip4_addr("127.0.0.1", TEST_PORT, &addr));
+  ASSERT(0 == uv_ip4_addr("127.0.0.1", TEST_PORT_2, &ping_addr));
+
+  /* Establish the ping-pong connection before the storm starts. */
+  ASSERT(0 == uv_tcp_init(loop, &ping_listener));
+  ASSERT(0 == uv_tcp_bind(&ping_listener,
+                          (const struct sockaddr*) &ping_addr,
+                          0));
+  ASSERT(0 == uv_listen((uv_stream_t*) &ping_listener,
+                        1,
+                        ping_connection_cb));
+  ASSERT(0 == uv_tcp_init(loop, &ping_client));
+  ASSERT(0 == uv_tcp_connect(&ping_connect_req,
+                             &ping_client,
+                             (const struct sockaddr*) &ping_addr,
+                             ping_connect_cb));
+  while (ping_connected < 2)
+    uv_run(loop, UV_RUN_ONCE);
+
+  ASSERT(0 == uv_tcp_init(loop, &server));
+  ASSERT(0 == uv_tcp_bind(&server, (const struct sockaddr*) &addr, 0));
+  if (mode != MODE_UNLIMITED)
+    ASSERT(0 == uv_stream_set_accept_budget((uv_stream_t*) &server, BUDGET));
+  if (mode == MODE_BATCH)
+    ASSERT(0 == uv_listen_batch((uv_stream_t*) &server, 511, batch_cb));
+  else
+    ASSERT(0 == uv_listen((uv_stream_t*) &server, 511, connection_cb));
+
+  ASSERT(0 == uv_async_init(loop, &done_async, done_async_cb));
+
+  storming = 1;
+  start_time = uv_hrtime();
+  ping(&ping_client, &ping_write_req);
+  for (i = 0; i < NUM_THREADS; i++)
+    ASSERT(0 == uv_thread_create(&storms[i].thread,
+                                 storm_thread_cb,
+                                 &storms[i]));
+
+  ASSERT(0 == uv_run(loop, UV_RUN_DEFAULT));
+
+  for (i = 0; i < NUM_THREADS; i++)
+    ASSERT(0 == uv_thread_join(&storms[i].thread));
+  uv_mutex_destroy(&storms_mutex);
+
+  ASSERT(accepted == NUM_CONNECTS);
+  secs = (end_time - start_time) / 1e9;
+
+  printf("%s: %.0f accepts/s, %.0f pings/s during the storm\n",
+         name,
+         accepted / secs,
+         pings / secs);
+  fflush(stdout);
+
+  MAKE_VALGRIND_HAPPY();
+  return 0;
+}
+
+
+BENCHMARK_IMPL(tcp_accept_unlimited) {
+  return run_benchmark(MODE_UNLIMITED, "tcp_accept_unlimited");
+}
+
+
+BENCHMARK_IMPL(tcp_accept_budget) {
+  return run_benchmark(MODE_BUDGET, "tcp_accept_budget");
+}
+
+
+BENCHMARK_IMPL(tcp_accept_batch) {
+  return run_benchmark(MODE_BATCH, "tcp_accept_batch");
+}
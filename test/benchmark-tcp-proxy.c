@@ -0,0 +1,302 @@
+/* Copyright libuv project contributors. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include "uv.h"
+#include "task.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Data flows from the producer through a proxy to the sink:
+ *
+ *   producer -> front (TEST_PORT) -> proxy_in | proxy_out -> back (TEST_PORT_2)
+ *
+ * The proxy either copies every chunk through a read callback and a write
+ * request, or has the kernel forward it with uv_stream_pipe_to().
+ */
+#define TOTAL_BYTES     (1024 * 1024 * 1024)
+#define CHUNK_SIZE      (64 * 1024)
+#define WRITES_IN_FLIGHT 4
+#define HIGH_WATER      (1024 * 1024)
+#define LOW_WATER       (256 * 1024)
+
+typedef struct {
+  uv_write_t req;
+  char data[CHUNK_SIZE];
+} proxy_write_t;
+
+static uv_loop_t* loop;
+static uv_tcp_t front;
+static uv_tcp_t back;
+static uv_tcp_t producer;
+static uv_tcp_t proxy_in;
+static uv_tcp_t proxy_out;
+static uv_tcp_t sink;
+static uv_connect_t producer_connect_req;
+static uv_connect_t proxy_connect_req;
+static uv_write_t producer_write_reqs[WRITES_IN_FLIGHT];
+static uv_shutdown_t producer_shutdown_req;
+static uv_shutdown_t proxy_shutdown_req;
+static uv_stream_pipe_t pipe_req;
+
+static char chunk[CHUNK_SIZE];
+static int use_splice;
+static int proxy_reading;
+static size_t bytes_sent;
+static size_t bytes_received;
+static uint64_t start_time;
+static uint64_t end_time;
+
+
+static void producer_write(uv_write_t* req);
+
+
+static void close_all(void) {
+  uv_close((uv_handle_t*) &front, NULL);
+  uv_close((uv_handle_t*) &back, NULL);
+  uv_close((uv_handle_t*) &producer, NULL);
+  uv_close((uv_handle_t*) &proxy_in, NULL);
+  uv_close((uv_handle_t*) &proxy_out, NULL);
+  uv_close((uv_handle_t*) &sink, NULL);
+}
+
+
+static void sink_read_cb(uv_stream_t* stream,
+                         ssize_t nread,
+                         const uv_buf_t* buf) {
+  if (nread > 0) {
+    bytes_received += nread;
+    return;
+  }
+
+  if (nread == UV_EOF) {
+    end_time = uv_hrtime();
+    close_all();
+  }
+}
+
+
+static void producer_shutdown_cb(uv_shutdown_t* req, int status) {
+  ASSERT(status == 0);
+}
+
+
+static void producer_write_cb(uv_write_t* req, int status) {
+  ASSERT(status == 0);
+
+  if (bytes_sent < TOTAL_BYTES)
+    producer_write(req);
+}
+
+
+static void producer_write(uv_write_t* req) {
+  uv_buf_t buf;
+
+  buf = uv_buf_init(chunk, CHUNK_SIZE);
+  ASSERT(0 == uv_write(req, (uv_stream_t*) &producer, &buf, 1,
+                       producer_write_cb));
+  bytes_sent += CHUNK_SIZE;
+
+  if (bytes_sent == TOTAL_BYTES)
+    ASSERT(0 == uv_shutdown(&producer_shutdown_req,
+                            (uv_stream_t*) &producer,
+                            producer_shutdown_cb));
+}
+
+
+static void proxy_alloc_cb(uv_handle_t* handle,
+                           size_t suggested_size,
+                           uv_buf_t* buf) {
+  proxy_write_t* w;
+
+  w = malloc(sizeof(*w));
+  ASSERT(w != NULL);
+  *buf = uv_buf_init(w->data, sizeof(w->data));
+}
+
+
+static void proxy_read_cb(uv_stream_t* stream,
+                          ssize_t nread,
+                          const uv_buf_t* buf);
+
+
+static void proxy_write_cb(uv_write_t* req, int status) {
+  ASSERT(status == 0);
+  free(container_of(req, proxy_write_t, req));
+
+  if (!proxy_reading && proxy_out.write_queue_size < LOW_WATER) {
+    ASSERT(0 == uv_read_start((uv_stream_t*) &proxy_in,
+                              proxy_alloc_cb,
+                              proxy_read_cb));
+    proxy_reading = 1;
+  }
+}
+
+
+static void proxy_read_cb(uv_stream_t* stream,
+                          ssize_t nread,
+                          const uv_buf_t* buf) {
+  proxy_write_t* w;
+  uv_buf_t out;
+
+  w = container_of(buf->base, proxy_write_t, data);
+
+  if (nread <= 0) {
+    free(w);
+    if (nread == UV_EOF)
+      ASSERT(0 == uv_shutdown(&proxy_shutdown_req,
+                              (uv_stream_t*) &proxy_out,
+                              NULL));
+    return;
+  }
+
+  out = uv_buf_init(w->data, nread);
+  ASSERT(0 == uv_write(&w->req, (uv_stream_t*) &proxy_out, &out, 1,
+                       proxy_write_cb));
+
+  if (proxy_out.write_queue_size > HIGH_WATER) {
+    ASSERT(0 == uv_read_stop((uv_stream_t*) &proxy_in));
+    proxy_reading = 0;
+  }
+}
+
+
+static void pipe_cb(uv_stream_pipe_t* req, int status) {
+  ASSERT(status == 0);
+  ASSERT(req->nbytes == TOTAL_BYTES);
+}
+
+
+static void proxy_connect_cb(uv_connect_t* req, int status) {
+  int i;
+
+  ASSERT(status == 0);
+
+  if (use_splice) {
+    ASSERT(0 == uv_stream_pipe_to(&pipe_req,
+                                  (uv_stream_t*) &proxy_in,
+                                  (uv_stream_t*) &proxy_out,
+                                  pipe_cb));
+  } else {
+    ASSERT(0 == uv_read_start((uv_stream_t*) &proxy_in,
+                              proxy_alloc_cb,
+                              proxy_read_cb));
+    proxy_reading = 1;
+  }
+
+  start_time = uv_hrtime();
+  for (i = 0; i < WRITES_IN_FLIGHT; i++)
+    producer_write(&producer_write_reqs[i]);
+}
+
+
+static void front_connection_cb(uv_stream_t* server, int status) {
+  struct sockaddr_in addr;
+
+  ASSERT(status == 0);
+  ASSERT(0 == uv_tcp_init(loop, &proxy_in));
+  ASSERT(0 == uv_accept(server, (uv_stream_t*) &proxy_in));
+
+  ASSERT(0 == uv_ip4_addr("127.0.0.1", TEST_PORT_2, &addr));
+  ASSERT(0 == uv_tcp_init(loop, &proxy_out));
+  ASSERT(0 == uv_tcp_connect(&proxy_connect_req,
+                             &proxy_out,
+                             (const struct sockaddr*) &addr,
+                             proxy_connect_cb));
+}
+
+
+static void back_connection_cb(uv_stream_t* server, int status) {
+  ASSERT(status == 0);
+  ASSERT(0 == uv_tcp_init(loop, &sink));
+  ASSERT(0 == uv_accept(server, (uv_stream_t*) &sink));
+  ASSERT(0 == uv_read_start_pooled((uv_stream_t*) &sink, sink_read_cb));
+}
+
+
+static void producer_connect_cb(uv_connect_t* req, int status) {
+  ASSERT(status == 0);
+}
+
+
+static void listen_on(uv_tcp_t* server, int port, uv_connection_cb cb) {
+  struct sockaddr_in addr;
+
+  ASSERT(0 == uv_ip4_addr("127.0.0.1", port, &addr));
+  ASSERT(0 == uv_tcp_init(loop, server));
+  ASSERT(0 == uv_tcp_bind(server, (const struct sockaddr*) &addr, 0));
+  ASSERT(0 == uv_listen((uv_stream_t*) server, 128, cb));
+}
+
+
+static int run_benchmark(const char* name, int splice) {
+  struct sockaddr_in addr;
+  double secs;
+
+  loop = uv_default_loop();
+  use_splice = splice;
+  memset(chunk, 'x', sizeof(chunk));
+
+  listen_on(&front, TEST_PORT, front_connection_cb);
+  listen_on(&back, TEST_PORT_2, back_connection_cb);
+
+  ASSERT(0 == uv_ip4_addr("127.0.0.1", TEST_PORT, &addr));
+  ASSERT(0 == uv_tcp_init(loop, &producer));
+  ASSERT(0 == uv_tcp_connect(&producer_connect_req,
+                             &producer,
+                             (const struct sockaddr*) &addr,
+                             producer_connect_cb));
+
+  ASSERT(0 == uv_run(loop, UV_RUN_DEFAULT));
+
+  ASSERT(bytes_sent == TOTAL_BYTES);
+  ASSERT(bytes_received == TOTAL_BYTES);
+
+  secs = (end_time - start_time) / 1e9;
+  printf("%s: %s bytes in %.2fs (%s/s)\n",
+         name,
+         fmt(TOTAL_BYTES),
+         secs,
+         fmt(TOTAL_BYTES / secs));
+  fflush(stdout);
+
+  MAKE_VALGRIND_HAPPY();
+  return 0;
+}
+
+
+BENCHMARK_IMPL(tcp_proxy_copy) {
+  return run_benchmark("tcp_proxy_copy", 0);
+}
+
+
+BENCHMARK_IMPL(tcp_proxy_splice) {
+  uv_stream_pipe_t req;
+
+  /* Bail out early where there is no splice(). */
+  if (uv_stream_pipe_to(&req, NULL, NULL, NULL) == UV_ENOSYS) {
+    fprintf(stderr, "tcp_proxy_splice: not supported\n");
+    return 0;
+  }
+
+  return run_benchmark("tcp_proxy_splice", 1);
+}
@@ -24,9 +24,11 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #define WRITE_REQ_DATA  "Hello, world."
 #define NUM_WRITE_REQS  (1000 * 1000)
+#define BACKLOG_SIZE    (16 * 1024 * 1024)
 
 typedef struct {
   uv_write_t req;
@@ -38,6 +40,8 @@ static write_req* write_reqs;
 static uv_tcp_t tcp_client;
 static uv_connect_t connect_req;
 static uv_shutdown_t shutdown_req;
+static uv_write_t backlog_req;
+static char* backlog;
 
 static int shutdown_cb_called = 0;
 static int connect_cb_called = 0;
@@ -57,6 +61,15 @@ static void connect_cb(uv_connect_t* req, int status) {
 
   ASSERT(req->handle == (uv_stream_t*)&tcp_client);
 
+  /* A write that doesn't fit in the socket buffer makes the small writes
+   * queue up behind it, like they do on a busy connection.
+   */
+  if (backlog != NULL) {
+    uv_buf_t buf = uv_buf_init(backlog, BACKLOG_SIZE);
+    r = uv_write(&backlog_req, req->handle, &buf, 1, write_cb);
+    ASSERT(r == 0);
+  }
+
   for (i = 0; i < NUM_WRITE_REQS; i++) {
     w = &write_reqs[i];
     r = uv_write(&w->req, req->handle, &w->buf, 1, write_cb);
@@ -83,6 +96,7 @@ static void shutdown_cb(uv_shutdown_t* req, int status) {
 
   uv_close((uv_handle_t*)req->handle, close_cb);
   free(write_reqs);
+  free(backlog);
 
   shutdown_cb_called++;
 }
@@ -94,7 +108,7 @@ static void close_cb(uv_handle_t* handle) {
 }
 
 
-BENCHMARK_IMPL(tcp_write_batch) {
+static int run_benchmark(int queued) {
   struct sockaddr_in addr;
   uv_loop_t* loop;
   uint64_t start;
@@ -105,6 +119,13 @@ BENCHMARK_IMPL(tcp_write_batch) {
   write_reqs = malloc(sizeof(*write_reqs) * NUM_WRITE_REQS);
   ASSERT(write_reqs != NULL);
 
+  backlog = NULL;
+  if (queued) {
+    backlog = malloc(BACKLOG_SIZE);
+    ASSERT(backlog != NULL);
+    memset(backlog, 'x', BACKLOG_SIZE);
+  }
+
   /* Prepare the data to write out. */
   for (i = 0; i < NUM_WRITE_REQS; i++) {
     write_reqs[i].buf = uv_buf_init(WRITE_REQ_DATA,
@@ -131,14 +152,25 @@ BENCHMARK_IMPL(tcp_write_batch) {
   stop = uv_hrtime();
 
   ASSERT(connect_cb_called == 1);
-  ASSERT(write_cb_called == NUM_WRITE_REQS);
+  ASSERT(write_cb_called == NUM_WRITE_REQS + (queued ? 1 : 0));
   ASSERT(shutdown_cb_called == 1);
   ASSERT(close_cb_called == 1);
 
-  printf("%ld write requests in %.2fs.\n",
+  printf("%ld write requests%s in %.2fs.\n",
          (long)NUM_WRITE_REQS,
+         queued ? " (queued)" : "",
          (stop - start) / 1e9);
 
   MAKE_VALGRIND_HAPPY();
   return 0;
 }
+
+
+BENCHMARK_IMPL(tcp_write_batch) {
+  return run_benchmark(0);
+}
+
+
+BENCHMARK_IMPL(tcp_write_batch_queued) {
+  return run_benchmark(1);
+}
@@ -57,12 +57,14 @@ static unsigned int recv_cb_called;
 static unsigned int close_cb_called;
 static int timed;
 static int exiting;
+static int mmsg;
 
 
 static void alloc_cb(uv_handle_t* handle,
                      size_t suggested_size,
                      uv_buf_t* buf) {
-  static char slab[65536];
+  /* Room for a full recvmmsg() batch in mmsg mode. */
+  static char slab[20 * 65536];
   ASSERT(suggested_size <= sizeof(slab));
   buf->base = slab;
   buf->len = sizeof(slab);
@@ -147,7 +149,8 @@ static void timeout_cb(uv_timer_t* timer) {
 
 static int pummel(unsigned int n_senders,
                   unsigned int n_receivers,
-                  unsigned long timeout) {
+                  unsigned long timeout,
+                  int use_mmsg) {
   uv_timer_t timer_handle;
   uint64_t duration;
   uv_loop_t* loop;
@@ -160,6 +163,7 @@ static int pummel(unsigned int n_senders,
 
   n_senders_ = n_senders;
   n_receivers_ = n_receivers;
+  mmsg = use_mmsg;
 
   if (timeout) {
     ASSERT(0 == uv_timer_init(loop, &timer_handle));
@@ -173,7 +177,9 @@ static int pummel(unsigned int n_senders,
     struct receiver_state* s = receivers + i;
     struct sockaddr_in addr;
     ASSERT(0 == uv_ip4_addr("0.0.0.0", BASE_PORT + i, &addr));
-    ASSERT(0 == uv_udp_init(loop, &s->udp_handle));
+    ASSERT(0 == uv_udp_init_ex(loop,
+                               &s->udp_handle,
+                               AF_UNSPEC | (mmsg ? UV_UDP_RECVMMSG : 0)));
     ASSERT(0 == uv_udp_bind(&s->udp_handle, (const struct sockaddr*) &addr, 0));
     ASSERT(0 == uv_udp_recv_start(&s->udp_handle, alloc_cb, recv_cb));
     uv_unref((uv_handle_t*)&s->udp_handle);
@@ -205,8 +211,9 @@ static int pummel(unsigned int n_senders,
   /* convert from nanoseconds to milliseconds */
   duration = duration / (uint64_t) 1e6;
 
-  printf("udp_pummel_%dv%d: %.0f/s received, %.0f/s sent. "
+  printf("udp_pummel_%s%dv%d: %.0f/s received, %.0f/s sent. "
          "%u received, %u sent in %.1f seconds.\n",
+         mmsg ? "mmsg_" : "",
          n_receivers,
          n_senders,
          recv_cb_called / (duration / 1000.0),
@@ -222,10 +229,13 @@ static int pummel(unsigned int n_senders,
 
 #define X(a, b)                                                               \
   BENCHMARK_IMPL(udp_pummel_##a##v##b) {                                      \
-    return pummel(a, b, 0);                                                   \
+    return pummel(a, b, 0, 0);                                                \
   }                                                                           \
   BENCHMARK_IMPL(udp_timed_pummel_##a##v##b) {                                \
-    return pummel(a, b, TEST_DURATION);                                       \
+    return pummel(a, b, TEST_DURATION, 0);                                    \
+  }                                                                           \
+  BENCHMARK_IMPL(udp_timed_pummel_mmsg_##a##v##b) {                           \
+    return pummel(a, b, TEST_DURATION, 1);                                    \
   }
 
 X(1, 1)
@@ -45,7 +45,7 @@
 static uv_fs_event_t fs_event;
 static const char file_prefix[] = "fsevent-";
 static const int fs_event_file_count = 16;
-#if defined(__APPLE__) || defined(_WIN32)
+#if defined(__APPLE__) || defined(_WIN32) || defined(__linux__)
 static const char file_prefix_in_subdir[] = "subdir";
 #endif
 static uv_timer_t timer;
@@ -217,7 +217,7 @@ static void fs_event_cb_dir_multi_file(uv_fs_event_t* handle,
   }
 }
 
-#if defined(__APPLE__) || defined(_WIN32)
+#if defined(__APPLE__) || defined(_WIN32) || defined(__linux__)
 static const char* fs_event_get_filename_in_subdir(int i) {
   snprintf(fs_event_filename,
            sizeof(fs_event_filename),
@@ -435,7 +435,7 @@ TEST_IMPL(fs_event_watch_dir) {
 }
 
 TEST_IMPL(fs_event_watch_dir_recursive) {
-#if defined(__APPLE__) || defined(_WIN32)
+#if defined(__APPLE__) || defined(_WIN32) || defined(__linux__)
   uv_loop_t* loop;
   int r;
 
@@ -477,6 +477,274 @@ TEST_IMPL(fs_event_watch_dir_recursive) {
 #endif
 }
 
+#if defined(__linux__)
+static int new_subdir_step;
+
+static void fs_event_cb_new_subdir(uv_fs_event_t* handle,
+                                   const char* filename,
+                                   int events,
+                                   int status) {
+  ASSERT(handle == &fs_event);
+  ASSERT(status == 0);
+  ASSERT(filename != NULL);
+
+  /* Watches for new directories are in place before the callback runs, so
+   * it can populate them right away.
+   */
+  switch (new_subdir_step++) {
+    case 0:
+      ASSERT(events == UV_RENAME);
+      ASSERT(strcmp(filename, "subdir") == 0);
+      create_dir("watch_dir/subdir/nested");
+      break;
+    case 1:
+      ASSERT(events == UV_RENAME);
+      ASSERT(strcmp(filename, "subdir/nested") == 0);
+      create_file("watch_dir/subdir/nested/file1");
+      break;
+    case 2:
+      ASSERT(events == UV_RENAME);
+      ASSERT(strcmp(filename, "subdir/nested/file1") == 0);
+      ASSERT(0 == remove("watch_dir/subdir/nested/file1"));
+      ASSERT(0 == remove("watch_dir/subdir/nested"));
+      break;
+    case 3:
+      ASSERT(events == UV_RENAME);
+      ASSERT(strcmp(filename, "subdir/nested/file1") == 0);
+      break;
+    case 4:
+      /* The removed directory is reported by its parent only. */
+      ASSERT(events == UV_RENAME);
+      ASSERT(strcmp(filename, "subdir/nested") == 0);
+      uv_close((uv_handle_t*) handle, close_cb);
+      break;
+    default:
+      ASSERT(0 && "should never be called");
+  }
+}
+
+static void timer_cb_new_subdir(uv_timer_t* handle) {
+  create_dir("watch_dir/subdir");
+  uv_close((uv_handle_t*) handle, close_cb);
+}
+#endif
+
+TEST_IMPL(fs_event_watch_dir_recursive_new_subdir) {
+#if defined(__linux__)
+  uv_loop_t* loop;
+  int r;
+
+  /* Setup */
+  loop = uv_default_loop();
+  remove("watch_dir/subdir/nested/file1");
+  remove("watch_dir/subdir/nested");
+  remove("watch_dir/subdir");
+  remove("watch_dir/");
+  create_dir("watch_dir");
+
+  r = uv_fs_event_init(loop, &fs_event);
+  ASSERT(r == 0);
+  r = uv_fs_event_start(&fs_event,
+                        fs_event_cb_new_subdir,
+                        "watch_dir",
+                        UV_FS_EVENT_RECURSIVE);
+  ASSERT(r == 0);
+  r = uv_timer_init(loop, &timer);
+  ASSERT(r == 0);
+  r = uv_timer_start(&timer, timer_cb_new_subdir, 100, 0);
+  ASSERT(r == 0);
+
+  uv_run(loop, UV_RUN_DEFAULT);
+
+  ASSERT(new_subdir_step == 5);
+  ASSERT(close_cb_called == 2);
+
+  /* Cleanup */
+  remove("watch_dir/subdir");
+  remove("watch_dir/");
+
+  MAKE_VALGRIND_HAPPY();
+  return 0;
+#else
+  RETURN_SKIP("Recursive directory watching is tested on Linux only.");
+#endif
+}
+
+#if defined(__linux__)
+static int mount_cb_called;
+
+static void fs_event_cb_mount(uv_fs_event_t* handle,
+                              const char* filename,
+                              int events,
+                              int status) {
+  ASSERT(handle == &fs_event);
+  ASSERT(status == 0);
+
+  /* Other activity on the file system is filtered out but an overflow of
+   * the fanotify queue is reported without a filename.
+   */
+  if (filename == NULL || strcmp(filename, "subdir/file1") != 0)
+    return;
+
+  ASSERT(events & UV_RENAME);
+  if (mount_cb_called++ == 0)
+    uv_close((uv_handle_t*) handle, close_cb);
+}
+
+static void timer_cb_mount(uv_timer_t* handle) {
+  create_file("watch_dir/subdir/file1");
+  uv_close((uv_handle_t*) handle, close_cb);
+}
+#endif
+
+TEST_IMPL(fs_event_watch_mount) {
+#if defined(__linux__)
+  uv_loop_t* loop;
+  char buf[64];
+  size_t len;
+  int r;
+
+  /* Setup */
+  loop = uv_default_loop();
+  remove("watch_dir/subdir/file1");
+  remove("watch_dir/subdir");
+  remove("watch_dir/");
+  create_dir("watch_dir");
+  create_dir("watch_dir/subdir");
+
+  /* Works with and without the privileges that fanotify needs. */
+  r = uv_fs_event_init(loop, &fs_event);
+  ASSERT(r == 0);
+  r = uv_fs_event_start(&fs_event,
+                        fs_event_cb_mount,
+                        "watch_dir",
+                        UV_FS_EVENT_MOUNT);
+  ASSERT(r == 0);
+  len = sizeof(buf);
+  ASSERT(0 == uv_fs_event_getpath(&fs_event, buf, &len));
+  ASSERT(len == 9);
+  ASSERT(0 == memcmp(buf, "watch_dir", len));
+  r = uv_timer_init(loop, &timer);
+  ASSERT(r == 0);
+  r = uv_timer_start(&timer, timer_cb_mount, 100, 0);
+  ASSERT(r == 0);
+
+  uv_run(loop, UV_RUN_DEFAULT);
+
+  ASSERT(mount_cb_called == 1);
+  ASSERT(close_cb_called == 2);
+
+  /* Cleanup */
+  remove("watch_dir/subdir/file1");
+  remove("watch_dir/subdir");
+  remove("watch_dir/");
+
+  MAKE_VALGRIND_HAPPY();
+  return 0;
+#else
+  RETURN_SKIP("Whole mount watching is tested on Linux only.");
+#endif
+}
+
+#if defined(__linux__)
+/* More than the 16384 events that a fanotify queue holds by default. */
+#define OVERFLOW_FILES 17000
+
+static int overflow_cb_called;
+static int overflow_files_seen;
+
+static void overflow_path(char* buf, size_t size, int i) {
+  snprintf(buf, size, "watch_dir/file%d", i);
+}
+
+static void fs_event_cb_overflow(uv_fs_event_t* handle,
+                                 const char* filename,
+                                 int events,
+                                 int status) {
+  ASSERT(handle == &fs_event);
+  ASSERT(status == 0);
+
+  if (filename != NULL) {
+    if (strncmp(filename, "file", 4) == 0)
+      overflow_files_seen++;
+    return;
+  }
+
+  /* The events that were held back come first. */
+  ASSERT(events == UV_RENAME);
+  ASSERT(overflow_files_seen > 0);
+  overflow_cb_called++;
+  uv_close((uv_handle_t*) handle, close_cb);
+  uv_close((uv_handle_t*) &timer, close_cb);
+}
+
+static void timer_cb_overflow(uv_timer_t* handle) {
+  uv_close((uv_handle_t*) &fs_event, close_cb);
+  uv_close((uv_handle_t*) handle, close_cb);
+}
+#endif
+
+TEST_IMPL(fs_event_watch_mount_overflow) {
+#if defined(__linux__)
+  uv_loop_t* loop;
+  char path[64];
+  int i;
+  int r;
+
+  /* Setup */
+  loop = uv_default_loop();
+  for (i = 0; i < OVERFLOW_FILES; i++) {
+    overflow_path(path, sizeof(path), i);
+    remove(path);
+  }
+  remove("watch_dir/");
+  create_dir("watch_dir");
+
+  r = uv_fs_event_init(loop, &fs_event);
+  ASSERT(r == 0);
+  /* Nothing is delivered before the overflow, except by flushing. */
+  r = uv_fs_event_set_coalesce(&fs_event, 60 * 1000);
+  ASSERT(r == 0);
+  r = uv_fs_event_start(&fs_event,
+                        fs_event_cb_overflow,
+                        "watch_dir",
+                        UV_FS_EVENT_MOUNT);
+  ASSERT(r == 0);
+
+  for (i = 0; i < OVERFLOW_FILES; i++) {
+    overflow_path(path, sizeof(path), i);
+    create_file(path);
+  }
+
+  r = uv_timer_init(loop, &timer);
+  ASSERT(r == 0);
+  r = uv_timer_start(&timer, timer_cb_overflow, 2000, 0);
+  ASSERT(r == 0);
+
+  uv_run(loop, UV_RUN_DEFAULT);
+
+  ASSERT(close_cb_called == 2);
+
+  /* Cleanup */
+  for (i = 0; i < OVERFLOW_FILES; i++) {
+    overflow_path(path, sizeof(path), i);
+    remove(path);
+  }
+  remove("watch_dir/");
+
+  MAKE_VALGRIND_HAPPY();
+
+  /* The recursive inotify fallback doesn't report overflows. */
+  if (overflow_cb_called == 0)
+    RETURN_SKIP("fanotify is not available.");
+
+  ASSERT(overflow_cb_called == 1);
+  return 0;
+#else
+  RETURN_SKIP("Whole mount watching is tested on Linux only.");
+#endif
+}
+
 #ifdef _WIN32
 TEST_IMPL(fs_event_watch_dir_short_path) {
   uv_loop_t* loop;
@@ -567,6 +835,92 @@ TEST_IMPL(fs_event_watch_file) {
   return 0;
 }
 
+static int coalesce_file1_events;
+static int coalesce_file2_events;
+
+static void fs_event_cb_coalesce(uv_fs_event_t* handle,
+                                 const char* filename,
+                                 int events,
+                                 int status) {
+  ASSERT(handle == &fs_event);
+  ASSERT(status == 0);
+  ASSERT(filename != NULL);
+  fs_event_cb_called++;
+
+  /* One callback per path with the union of the events seen. */
+  if (strcmp(filename, "file1") == 0) {
+    ASSERT(coalesce_file1_events == 0);
+    coalesce_file1_events = events;
+  } else if (strcmp(filename, "file2") == 0) {
+    ASSERT(coalesce_file2_events == 0);
+    coalesce_file2_events = events;
+  } else {
+    ASSERT(0 && "unexpected path");
+  }
+
+  if (coalesce_file1_events != 0 && coalesce_file2_events != 0)
+    uv_close((uv_handle_t*) handle, close_cb);
+}
+
+static void timer_cb_coalesce(uv_timer_t* handle) {
+  int i;
+
+  create_file("watch_dir/file1");
+  for (i = 0; i < 10; i++) {
+    touch_file("watch_dir/file1");
+    touch_file("watch_dir/file2");
+  }
+
+  uv_close((uv_handle_t*) handle, close_cb);
+}
+
+TEST_IMPL(fs_event_watch_dir_coalesce) {
+#if defined(NO_FS_EVENTS)
+  RETURN_SKIP(NO_FS_EVENTS);
+#endif
+
+  uv_loop_t* loop = uv_default_loop();
+  int r;
+
+  /* Setup */
+  remove("watch_dir/file2");
+  remove("watch_dir/file1");
+  remove("watch_dir/");
+  create_dir("watch_dir");
+  create_file("watch_dir/file2");
+
+  r = uv_fs_event_init(loop, &fs_event);
+  ASSERT(r == 0);
+  r = uv_fs_event_set_coalesce(&fs_event, 200);
+  if (r == UV_ENOSYS) {
+    uv_close((uv_handle_t*) &fs_event, NULL);
+    uv_run(loop, UV_RUN_DEFAULT);
+    RETURN_SKIP("Event coalescing is not supported on this platform.");
+  }
+  ASSERT(r == 0);
+  r = uv_fs_event_start(&fs_event, fs_event_cb_coalesce, "watch_dir", 0);
+  ASSERT(r == 0);
+  r = uv_timer_init(loop, &timer);
+  ASSERT(r == 0);
+  r = uv_timer_start(&timer, timer_cb_coalesce, 100, 0);
+  ASSERT(r == 0);
+
+  uv_run(loop, UV_RUN_DEFAULT);
+
+  ASSERT(fs_event_cb_called == 2);
+  ASSERT(coalesce_file1_events == (UV_RENAME | UV_CHANGE));
+  ASSERT(coalesce_file2_events == UV_CHANGE);
+  ASSERT(close_cb_called == 2);
+
+  /* Cleanup */
+  remove("watch_dir/file2");
+  remove("watch_dir/file1");
+  remove("watch_dir/");
+
+  MAKE_VALGRIND_HAPPY();
+  return 0;
+}
+
 TEST_IMPL(fs_event_watch_file_exact_path) {
   /*
     This test watches a file named "file.jsx" and modifies a file named
@@ -46,6 +46,9 @@ static int poll_cb_called;
 static int timer_cb_called;
 static int close_cb_called;
 
+static uv_fs_poll_t batch_handles[150];
+static int batch_cb_called;
+
 
 static void touch_file(const char* path) {
   static int count;
@@ -132,6 +135,11 @@ static void poll_cb(uv_fs_poll_t* handle,
     ASSERT(0 != memcmp(prev, &zero_statbuf, sizeof(zero_statbuf)));
     ASSERT(0 == memcmp(curr, &zero_statbuf, sizeof(zero_statbuf)));
     uv_close((uv_handle_t*)handle, close_cb);
+    if (batch_cb_called > 0) {
+      unsigned int i;
+      for (i = 0; i < ARRAY_SIZE(batch_handles); i++)
+        uv_close((uv_handle_t*) &batch_handles[i], close_cb);
+    }
     break;
 
   default:
@@ -159,6 +167,49 @@ TEST_IMPL(fs_poll) {
 }
 
 
+static void batch_poll_cb(uv_fs_poll_t* handle,
+                          int status,
+                          const uv_stat_t* prev,
+                          const uv_stat_t* curr) {
+  /* The paths don't exist, only the initial stat is reported. */
+  ASSERT(status == UV_ENOENT);
+  batch_cb_called++;
+}
+
+
+TEST_IMPL(fs_poll_batch) {
+  char path[64];
+  unsigned int i;
+
+  loop = uv_default_loop();
+  ASSERT(0 == uv_loop_configure(loop, UV_LOOP_FS_POLL_BATCH));
+  /* Idempotent. */
+  ASSERT(0 == uv_loop_configure(loop, UV_LOOP_FS_POLL_BATCH));
+
+  remove(FIXTURE);
+
+  /* More handles than fit in one batch. */
+  for (i = 0; i < ARRAY_SIZE(batch_handles); i++) {
+    snprintf(path, sizeof(path), "fs_poll_batch_%u_nonexistent", i);
+    ASSERT(0 == uv_fs_poll_init(loop, &batch_handles[i]));
+    ASSERT(0 == uv_fs_poll_start(&batch_handles[i], batch_poll_cb, path, 50));
+  }
+
+  ASSERT(0 == uv_timer_init(loop, &timer_handle));
+  ASSERT(0 == uv_fs_poll_init(loop, &poll_handle));
+  ASSERT(0 == uv_fs_poll_start(&poll_handle, poll_cb, FIXTURE, 100));
+  ASSERT(0 == uv_run(loop, UV_RUN_DEFAULT));
+
+  ASSERT(poll_cb_called == 5);
+  ASSERT(timer_cb_called == 2);
+  ASSERT(batch_cb_called == ARRAY_SIZE(batch_handles));
+  ASSERT(close_cb_called == 1 + ARRAY_SIZE(batch_handles));
+
+  MAKE_VALGRIND_HAPPY();
+  return 0;
+}
+
+
 TEST_IMPL(fs_poll_getpath) {
   char buf[1024];
   size_t len;
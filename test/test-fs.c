@@ -78,6 +78,9 @@ static int rename_cb_count;
 static int fsync_cb_count;
 static int fdatasync_cb_count;
 static int ftruncate_cb_count;
+static int fadvise_cb_count;
+static int fallocate_cb_count;
+static int fallocate_cb_result;
 static int sendfile_cb_count;
 static int fstat_cb_count;
 static int access_cb_count;
@@ -111,6 +114,8 @@ static uv_fs_t rename_req;
 static uv_fs_t fsync_req;
 static uv_fs_t fdatasync_req;
 static uv_fs_t ftruncate_req;
+static uv_fs_t fadvise_req;
+static uv_fs_t fallocate_req;
 static uv_fs_t sendfile_req;
 static uv_fs_t utime_req;
 static uv_fs_t futime_req;
@@ -3456,6 +3461,686 @@ TEST_IMPL(fs_file_pos_after_op_with_offset) {
   return 0;
 }
 
+static void fadvise_cb(uv_fs_t* req) {
+  ASSERT(req == &fadvise_req);
+  ASSERT(req->fs_type == UV_FS_READAHEAD);
+#ifdef _WIN32
+  ASSERT(req->result == UV_ENOSYS);
+#else
+  ASSERT(req->result == 0);
+#endif
+  fadvise_cb_count++;
+  uv_fs_req_cleanup(req);
+}
+
+
+TEST_IMPL(fs_fadvise) {
+  int r;
+
+  /* Setup. */
+  unlink("test_file");
+  loop = uv_default_loop();
+
+  r = uv_fs_open(NULL,
+                 &open_req1,
+                 "test_file",
+                 O_RDWR | O_CREAT,
+                 S_IWUSR | S_IRUSR,
+                 NULL);
+  ASSERT(r >= 0);
+  uv_fs_req_cleanup(&open_req1);
+
+  iov = uv_buf_init(test_buf, sizeof(test_buf));
+  r = uv_fs_write(NULL, &write_req, open_req1.result, &iov, 1, 0, NULL);
+  ASSERT(r == sizeof(test_buf));
+  uv_fs_req_cleanup(&write_req);
+
+  r = uv_fs_fadvise(NULL,
+                    &fadvise_req,
+                    open_req1.result,
+                    0,
+                    0,
+                    UV_FS_FADV_SEQUENTIAL,
+                    NULL);
+#ifdef _WIN32
+  ASSERT(r == UV_ENOSYS);
+#else
+  ASSERT(r == 0);
+#endif
+  ASSERT(fadvise_req.fs_type == UV_FS_FADVISE);
+  uv_fs_req_cleanup(&fadvise_req);
+
+  r = uv_fs_fadvise(NULL, &fadvise_req, open_req1.result, 0, 0, 42, NULL);
+  ASSERT(r == UV_EINVAL);
+  uv_fs_req_cleanup(&fadvise_req);
+
+  r = uv_fs_fadvise(NULL,
+                    &fadvise_req,
+                    open_req1.result,
+                    -1,
+                    0,
+                    UV_FS_FADV_NORMAL,
+                    NULL);
+  ASSERT(r == UV_EINVAL);
+  uv_fs_req_cleanup(&fadvise_req);
+
+  r = uv_fs_readahead(loop,
+                      &fadvise_req,
+                      open_req1.result,
+                      0,
+                      sizeof(test_buf),
+                      fadvise_cb);
+  ASSERT(r == 0);
+  uv_run(loop, UV_RUN_DEFAULT);
+  ASSERT(fadvise_cb_count == 1);
+
+  r = uv_fs_close(NULL, &close_req, open_req1.result, NULL);
+  ASSERT(r == 0);
+  uv_fs_req_cleanup(&close_req);
+
+  /* Cleanup */
+  unlink("test_file");
+
+  MAKE_VALGRIND_HAPPY();
+  return 0;
+}
+
+
+static void fallocate_cb(uv_fs_t* req) {
+  ASSERT(req == &fallocate_req);
+  ASSERT(req->fs_type == UV_FS_FALLOCATE);
+  /* The BSDs, Solaris and AIX don't support UV_FS_FALLOCATE_KEEP_SIZE. */
+  ASSERT(req->result == 0 || req->result == UV_ENOSYS);
+  fallocate_cb_result = req->result;
+  fallocate_cb_count++;
+  uv_fs_req_cleanup(req);
+}
+
+
+TEST_IMPL(fs_fallocate) {
+  uv_file file;
+  int r;
+
+  /* Setup. */
+  unlink("test_file");
+  loop = uv_default_loop();
+
+  r = uv_fs_open(NULL,
+                 &open_req1,
+                 "test_file",
+                 O_RDWR | O_CREAT,
+                 S_IWUSR | S_IRUSR,
+                 NULL);
+  ASSERT(r >= 0);
+  file = open_req1.result;
+  uv_fs_req_cleanup(&open_req1);
+
+  r = uv_fs_fallocate(NULL, &fallocate_req, file, 0, 0, 4096, NULL);
+  if (r == UV_ENOSYS || r == UV_ENOTSUP) {
+    uv_fs_req_cleanup(&fallocate_req);
+    uv_fs_close(NULL, &close_req, file, NULL);
+    uv_fs_req_cleanup(&close_req);
+    unlink("test_file");
+    RETURN_SKIP("fallocate is not supported by this file system");
+  }
+  ASSERT(r == 0);
+  uv_fs_req_cleanup(&fallocate_req);
+
+  r = uv_fs_fstat(NULL, &stat_req, file, NULL);
+  ASSERT(r == 0);
+  ASSERT(stat_req.statbuf.st_size == 4096);
+  uv_fs_req_cleanup(&stat_req);
+
+  r = uv_fs_fallocate(NULL, &fallocate_req, file, 42, 0, 4096, NULL);
+  ASSERT(r == UV_EINVAL);
+  uv_fs_req_cleanup(&fallocate_req);
+
+  r = uv_fs_fallocate(NULL, &fallocate_req, file, 0, 0, 0, NULL);
+  ASSERT(r == UV_EINVAL);
+  uv_fs_req_cleanup(&fallocate_req);
+
+  r = uv_fs_fallocate(loop,
+                      &fallocate_req,
+                      file,
+                      UV_FS_FALLOCATE_KEEP_SIZE,
+                      4096,
+                      65536,
+                      fallocate_cb);
+  ASSERT(r == 0);
+  uv_run(loop, UV_RUN_DEFAULT);
+  ASSERT(fallocate_cb_count == 1);
+
+  if (fallocate_cb_result == 0) {
+    r = uv_fs_fstat(NULL, &stat_req, file, NULL);
+    ASSERT(r == 0);
+    ASSERT(stat_req.statbuf.st_size == 4096);
+    uv_fs_req_cleanup(&stat_req);
+  }
+
+#if defined(__linux__)
+  iov = uv_buf_init(test_buf, sizeof(test_buf));
+  r = uv_fs_write(NULL, &write_req, file, &iov, 1, 0, NULL);
+  ASSERT(r == sizeof(test_buf));
+  uv_fs_req_cleanup(&write_req);
+
+  r = uv_fs_fallocate(NULL,
+                      &fallocate_req,
+                      file,
+                      UV_FS_FALLOCATE_PUNCH_HOLE,
+                      0,
+                      4096,
+                      NULL);
+  ASSERT(r == 0 || r == UV_ENOTSUP);
+  uv_fs_req_cleanup(&fallocate_req);
+
+  if (r == 0) {
+    memset(buf, 'x', sizeof(buf));
+    iov = uv_buf_init(buf, sizeof(test_buf));
+    r = uv_fs_read(NULL, &read_req, file, &iov, 1, 0, NULL);
+    ASSERT(r == sizeof(test_buf));
+    ASSERT(buf[0] == '\0');
+    ASSERT(buf[sizeof(test_buf) - 1] == '\0');
+    uv_fs_req_cleanup(&read_req);
+
+    r = uv_fs_fstat(NULL, &stat_req, file, NULL);
+    ASSERT(r == 0);
+    ASSERT(stat_req.statbuf.st_size == 4096);
+    uv_fs_req_cleanup(&stat_req);
+  }
+#endif
+
+  r = uv_fs_close(NULL, &close_req, file, NULL);
+  ASSERT(r == 0);
+  uv_fs_req_cleanup(&close_req);
+
+  /* Cleanup */
+  unlink("test_file");
+
+  MAKE_VALGRIND_HAPPY();
+  return 0;
+}
+
+
+static void read_aligned_cb(uv_fs_t* req) {
+  const char* data;
+  int i;
+
+  ASSERT(req == &read_req);
+  ASSERT(req->fs_type == UV_FS_READ_ALIGNED);
+  ASSERT(req->result == 100);
+
+  data = uv_fs_get_ptr(req);
+  for (i = 0; i < 100; i++)
+    ASSERT(data[i] == (char) ((5000 + i) % 251));
+
+  read_cb_count++;
+  uv_fs_req_cleanup(req);
+}
+
+
+TEST_IMPL(fs_read_aligned) {
+  uv_fs_buf_pool_t pool;
+  uv_fs_t fresh_req;
+  uv_buf_t bufs[2];
+  char data[10000];
+  uv_file file;
+  int r;
+  int i;
+
+  /* Setup. */
+  unlink("test_file");
+  loop = uv_default_loop();
+
+  for (i = 0; i < (int) sizeof(data); i++)
+    data[i] = (char) (i % 251);
+
+  r = uv_fs_open(NULL,
+                 &open_req1,
+                 "test_file",
+                 O_WRONLY | O_CREAT,
+                 S_IWUSR | S_IRUSR,
+                 NULL);
+  ASSERT(r >= 0);
+  file = open_req1.result;
+  uv_fs_req_cleanup(&open_req1);
+
+  iov = uv_buf_init(data, sizeof(data));
+  r = uv_fs_write(NULL, &write_req, file, &iov, 1, 0, NULL);
+  ASSERT(r == sizeof(data));
+  uv_fs_req_cleanup(&write_req);
+
+  r = uv_fs_close(NULL, &close_req, file, NULL);
+  ASSERT(r == 0);
+  uv_fs_req_cleanup(&close_req);
+
+  /* Not every file system supports direct I/O, tmpfs for one doesn't. */
+  r = uv_fs_open(NULL,
+                 &open_req1,
+                 "test_file",
+                 O_RDONLY | UV_FS_O_DIRECT,
+                 0,
+                 NULL);
+  if (r < 0) {
+    uv_fs_req_cleanup(&open_req1);
+    r = uv_fs_open(NULL, &open_req1, "test_file", O_RDONLY, 0, NULL);
+  }
+  ASSERT(r >= 0);
+  file = open_req1.result;
+  uv_fs_req_cleanup(&open_req1);
+
+  r = uv_fs_buf_pool_init(&pool, file, 1000);
+  ASSERT(r == 0);
+  ASSERT(pool.block_size > 0);
+  ASSERT((pool.block_size & (pool.block_size - 1)) == 0);
+  ASSERT(pool.buf_size >= 1000);
+  ASSERT(pool.buf_size % pool.block_size == 0);
+
+  /* Buffers are aligned and get recycled. */
+  r = uv_fs_buf_pool_alloc(&pool, &bufs[0]);
+  ASSERT(r == 0);
+  r = uv_fs_buf_pool_alloc(&pool, &bufs[1]);
+  ASSERT(r == 0);
+  ASSERT(bufs[0].len == pool.buf_size);
+  ASSERT(((uintptr_t) bufs[0].base & (pool.block_size - 1)) == 0);
+  ASSERT(((uintptr_t) bufs[1].base & (pool.block_size - 1)) == 0);
+  uv_fs_buf_pool_free(&pool, bufs[1]);
+  iov = bufs[1];
+  r = uv_fs_buf_pool_alloc(&pool, &bufs[1]);
+  ASSERT(r == 0);
+  ASSERT(bufs[1].base == iov.base);
+
+  r = uv_fs_read(NULL, &read_req, file, &bufs[0], 1, pool.block_size, NULL);
+  ASSERT(r >= 0);
+  uv_fs_req_cleanup(&read_req);
+  uv_fs_buf_pool_free(&pool, bufs[0]);
+  uv_fs_buf_pool_free(&pool, bufs[1]);
+
+  /* Unaligned reads are rounded out to the block size. */
+  r = uv_fs_read_aligned(loop, &read_req, &pool, file, 5000, 100,
+                         read_aligned_cb);
+  ASSERT(r == 0);
+  uv_run(loop, UV_RUN_DEFAULT);
+  ASSERT(read_cb_count == 1);
+
+  /* Reads past the end of the file are truncated. */
+  r = uv_fs_read_aligned(NULL,
+                         &read_req,
+                         &pool,
+                         file,
+                         sizeof(data) - 10,
+                         20,
+                         NULL);
+  ASSERT(r == 10);
+  ASSERT(memcmp(uv_fs_get_ptr(&read_req), data + sizeof(data) - 10, 10) == 0);
+  uv_fs_req_cleanup(&read_req);
+
+  r = uv_fs_read_aligned(NULL, &read_req, &pool, file, 0, 0, NULL);
+  ASSERT(r == UV_EINVAL);
+  uv_fs_req_cleanup(&read_req);
+
+  r = uv_fs_read_aligned(NULL,
+                         &read_req,
+                         &pool,
+                         file,
+                         0,
+                         pool.buf_size + 1,
+                         NULL);
+  ASSERT(r == UV_EINVAL);
+  uv_fs_req_cleanup(&read_req);
+
+  /* A request that fails validation holds no buffer, whatever its memory
+   * contained before.
+   */
+  memset(&fresh_req, 0x5a, sizeof(fresh_req));
+  r = uv_fs_read_aligned(NULL, &fresh_req, &pool, file, -1, 100, NULL);
+  ASSERT(r == UV_EINVAL);
+  uv_fs_req_cleanup(&fresh_req);
+
+  ASSERT(pool.nused == 0);
+  uv_fs_buf_pool_destroy(&pool);
+
+  r = uv_fs_close(NULL, &close_req, file, NULL);
+  ASSERT(r == 0);
+  uv_fs_req_cleanup(&close_req);
+
+  /* Cleanup */
+  unlink("test_file");
+
+  MAKE_VALGRIND_HAPPY();
+  return 0;
+}
+
+
+#define GROUP_COMMIT_REQS 16
+
+static uv_fs_t group_commit_reqs[GROUP_COMMIT_REQS];
+static uv_fs_t group_commit_extra_req;
+static int group_commit_cb_count;
+
+
+static void group_commit_extra_cb(uv_fs_t* req) {
+  ASSERT(req == &group_commit_extra_req);
+  ASSERT(req->fs_type == UV_FS_FDATASYNC);
+  ASSERT(req->result == 0);
+  ASSERT(group_commit_cb_count == GROUP_COMMIT_REQS);
+  group_commit_cb_count++;
+  uv_fs_req_cleanup(req);
+}
+
+
+static void group_commit_cb(uv_fs_t* req) {
+  int r;
+
+  ASSERT(req->result == 0);
+  ASSERT(req->fs_type == UV_FS_FSYNC || req->fs_type == UV_FS_FDATASYNC);
+
+  /* Syncs that arrive while one is in flight may not jump ahead of it. */
+  if (group_commit_cb_count == 0)
+    ASSERT(req == &group_commit_reqs[0]);
+
+  group_commit_cb_count++;
+  uv_fs_req_cleanup(req);
+
+  if (req == &group_commit_reqs[0]) {
+    r = uv_fs_fdatasync(req->loop,
+                        &group_commit_extra_req,
+                        open_req1.result,
+                        group_commit_extra_cb);
+    ASSERT(r == 0);
+  }
+}
+
+
+TEST_IMPL(fs_fsync_group_commit) {
+  uv_loop_t group_loop;
+  int r;
+  int i;
+
+#ifdef _WIN32
+  RETURN_SKIP("group commit is not supported on Windows");
+#endif
+
+  /* Setup. */
+  unlink("test_file");
+
+  ASSERT(0 == uv_loop_init(&group_loop));
+  ASSERT(0 == uv_loop_configure(&group_loop, UV_LOOP_FS_GROUP_COMMIT));
+
+  r = uv_fs_open(NULL,
+                 &open_req1,
+                 "test_file",
+                 O_WRONLY | O_CREAT,
+                 S_IWUSR | S_IRUSR,
+                 NULL);
+  ASSERT(r >= 0);
+  uv_fs_req_cleanup(&open_req1);
+
+  iov = uv_buf_init(test_buf, sizeof(test_buf));
+  r = uv_fs_write(NULL, &write_req, open_req1.result, &iov, 1, 0, NULL);
+  ASSERT(r == sizeof(test_buf));
+  uv_fs_req_cleanup(&write_req);
+
+  for (i = 0; i < GROUP_COMMIT_REQS; i++) {
+    if (i % 4 == 3)
+      r = uv_fs_fsync(&group_loop,
+                      &group_commit_reqs[i],
+                      open_req1.result,
+                      group_commit_cb);
+    else
+      r = uv_fs_fdatasync(&group_loop,
+                          &group_commit_reqs[i],
+                          open_req1.result,
+                          group_commit_cb);
+    ASSERT(r == 0);
+  }
+
+  /* Parked requests are not in the thread pool and can't be cancelled. */
+  ASSERT(UV_EBUSY == uv_cancel((uv_req_t*) &group_commit_reqs[1]));
+
+  ASSERT(0 == uv_run(&group_loop, UV_RUN_DEFAULT));
+  ASSERT(group_commit_cb_count == GROUP_COMMIT_REQS + 1);
+
+  r = uv_fs_close(NULL, &close_req, open_req1.result, NULL);
+  ASSERT(r == 0);
+  uv_fs_req_cleanup(&close_req);
+
+  ASSERT(0 == uv_loop_close(&group_loop));
+
+  /* Cleanup */
+  unlink("test_file");
+
+  MAKE_VALGRIND_HAPPY();
+  return 0;
+}
+
+
+#define COALESCE_WRITE_REQS 64
+#define COALESCE_WRITE_SIZE 16
+
+static uv_fs_t coalesce_write_reqs[COALESCE_WRITE_REQS];
+static char coalesce_write_data[COALESCE_WRITE_REQS][COALESCE_WRITE_SIZE];
+static uv_fs_t coalesce_tail_req;
+static int coalesce_write_cb_count;
+
+
+/* The first half of the writes goes forward through the file, the second
+ * half backwards, so some writes are not contiguous with the previous one.
+ */
+static int64_t coalesce_write_off(int i) {
+  if (i >= COALESCE_WRITE_REQS / 2)
+    i = 3 * COALESCE_WRITE_REQS / 2 - i - 1;
+  return i * COALESCE_WRITE_SIZE;
+}
+
+
+static void coalesce_tail_cb(uv_fs_t* req) {
+  ASSERT(req == &coalesce_tail_req);
+  ASSERT(req->result == 4);
+  ASSERT(coalesce_write_cb_count == COALESCE_WRITE_REQS);
+  coalesce_write_cb_count++;
+  uv_fs_req_cleanup(req);
+}
+
+
+static void coalesce_write_cb(uv_fs_t* req) {
+  uv_buf_t buf;
+  int r;
+
+  ASSERT(req->fs_type == UV_FS_WRITE);
+  ASSERT(req->result == COALESCE_WRITE_SIZE);
+  ASSERT(req == &coalesce_write_reqs[coalesce_write_cb_count]);
+  coalesce_write_cb_count++;
+  uv_fs_req_cleanup(req);
+
+  if (req == &coalesce_write_reqs[0]) {
+    buf = uv_buf_init("tail", 4);
+    r = uv_fs_write(req->loop,
+                    &coalesce_tail_req,
+                    open_req1.result,
+                    &buf,
+                    1,
+                    COALESCE_WRITE_REQS * COALESCE_WRITE_SIZE,
+                    coalesce_tail_cb);
+    ASSERT(r == 0);
+  }
+}
+
+
+TEST_IMPL(fs_write_coalesce) {
+  char expected[COALESCE_WRITE_REQS * COALESCE_WRITE_SIZE + 4];
+  char actual[sizeof(expected) + 1];
+  uv_loop_t write_loop;
+  uv_buf_t bufs[2];
+  int r;
+  int i;
+
+#ifdef _WIN32
+  RETURN_SKIP("write coalescing is not supported on Windows");
+#endif
+
+  /* Setup. */
+  unlink("test_file");
+
+  ASSERT(0 == uv_loop_init(&write_loop));
+  ASSERT(0 == uv_loop_configure(&write_loop, UV_LOOP_FS_COALESCE_WRITES));
+
+  r = uv_fs_open(NULL,
+                 &open_req1,
+                 "test_file",
+                 O_RDWR | O_CREAT,
+                 S_IWUSR | S_IRUSR,
+                 NULL);
+  ASSERT(r >= 0);
+  uv_fs_req_cleanup(&open_req1);
+
+  for (i = 0; i < COALESCE_WRITE_REQS; i++) {
+    memset(coalesce_write_data[i], 'A' + i % 26, COALESCE_WRITE_SIZE);
+    bufs[0] = uv_buf_init(coalesce_write_data[i], COALESCE_WRITE_SIZE / 2);
+    bufs[1] = uv_buf_init(coalesce_write_data[i] + COALESCE_WRITE_SIZE / 2,
+                          COALESCE_WRITE_SIZE / 2);
+    r = uv_fs_write(&write_loop,
+                    &coalesce_write_reqs[i],
+                    open_req1.result,
+                    bufs,
+                    2,
+                    coalesce_write_off(i),
+                    coalesce_write_cb);
+    ASSERT(r == 0);
+  }
+
+  /* Queued requests are not in the thread pool and can't be cancelled. */
+  ASSERT(UV_EBUSY == uv_cancel((uv_req_t*) &coalesce_write_reqs[1]));
+
+  ASSERT(0 == uv_run(&write_loop, UV_RUN_DEFAULT));
+  ASSERT(coalesce_write_cb_count == COALESCE_WRITE_REQS + 1);
+
+  for (i = 0; i < COALESCE_WRITE_REQS; i++)
+    memset(expected + coalesce_write_off(i), 'A' + i % 26, COALESCE_WRITE_SIZE);
+  memcpy(expected + COALESCE_WRITE_REQS * COALESCE_WRITE_SIZE, "tail", 4);
+
+  iov = uv_buf_init(actual, sizeof(actual));
+  r = uv_fs_read(NULL, &read_req, open_req1.result, &iov, 1, 0, NULL);
+  ASSERT(r == sizeof(expected));
+  ASSERT(0 == memcmp(actual, expected, sizeof(expected)));
+  uv_fs_req_cleanup(&read_req);
+
+  r = uv_fs_close(NULL, &close_req, open_req1.result, NULL);
+  ASSERT(r == 0);
+  uv_fs_req_cleanup(&close_req);
+
+  ASSERT(0 == uv_loop_close(&write_loop));
+
+  /* Cleanup */
+  unlink("test_file");
+
+  MAKE_VALGRIND_HAPPY();
+  return 0;
+}
+
+
+static char read_multi_data[8192];
+static int read_multi_cb_count;
+
+
+static void check_read_multi_ranges(uv_fs_read_range_t* ranges) {
+  int i;
+
+  ASSERT(ranges[0].result == 100);
+  ASSERT(ranges[1].result == 16);
+  ASSERT(ranges[2].result == 192);
+  ASSERT(ranges[3].result == 0);
+
+  for (i = 0; i < 3; i++)
+    ASSERT(0 == memcmp(ranges[i].buf.base,
+                       read_multi_data + ranges[i].offset,
+                       ranges[i].result));
+}
+
+
+static void read_multi_cb(uv_fs_t* req) {
+  ASSERT(req->fs_type == UV_FS_READ_MULTI);
+  ASSERT(req->result == 100 + 16 + 192);
+  check_read_multi_ranges(req->data);
+  read_multi_cb_count++;
+  uv_fs_req_cleanup(req);
+}
+
+
+TEST_IMPL(fs_read_multi) {
+  uv_fs_read_range_t ranges[4];
+  char bufs[4][512];
+  uv_fs_t req;
+  int r;
+  int i;
+
+  /* Setup. */
+  unlink("test_file");
+  loop = uv_default_loop();
+
+  for (i = 0; i < (int) sizeof(read_multi_data); i++)
+    read_multi_data[i] = i % 251;
+
+  r = uv_fs_open(NULL,
+                 &open_req1,
+                 "test_file",
+                 O_RDWR | O_CREAT,
+                 S_IWUSR | S_IRUSR,
+                 NULL);
+  ASSERT(r >= 0);
+  uv_fs_req_cleanup(&open_req1);
+
+  iov = uv_buf_init(read_multi_data, sizeof(read_multi_data));
+  r = uv_fs_write(NULL, &write_req, open_req1.result, &iov, 1, 0, NULL);
+  ASSERT(r == sizeof(read_multi_data));
+  uv_fs_req_cleanup(&write_req);
+
+  ranges[0].offset = 4096;
+  ranges[0].buf = uv_buf_init(bufs[0], 100);
+  ranges[1].offset = 0;
+  ranges[1].buf = uv_buf_init(bufs[1], 16);
+  ranges[2].offset = sizeof(read_multi_data) - 192;  /* Short read. */
+  ranges[2].buf = uv_buf_init(bufs[2], sizeof(bufs[2]));
+  ranges[3].offset = 2 * sizeof(read_multi_data);  /* Past EOF. */
+  ranges[3].buf = uv_buf_init(bufs[3], sizeof(bufs[3]));
+
+  r = uv_fs_read_multi(NULL, &req, open_req1.result, ranges, 4, NULL);
+  ASSERT(r == 100 + 16 + 192);
+  ASSERT(req.result == r);
+  check_read_multi_ranges(ranges);
+  uv_fs_req_cleanup(&req);
+
+  memset(bufs, 0, sizeof(bufs));
+  req.data = ranges;
+  r = uv_fs_read_multi(loop,
+                       &req,
+                       open_req1.result,
+                       ranges,
+                       4,
+                       read_multi_cb);
+  ASSERT(r == 0);
+  uv_run(loop, UV_RUN_DEFAULT);
+  ASSERT(read_multi_cb_count == 1);
+
+  ranges[1].offset = -1;
+  r = uv_fs_read_multi(NULL, &req, open_req1.result, ranges, 4, NULL);
+  ASSERT(r == UV_EINVAL);
+  r = uv_fs_read_multi(NULL, &req, open_req1.result, ranges, 0, NULL);
+  ASSERT(r == UV_EINVAL);
+  r = uv_fs_read_multi(NULL, &req, open_req1.result, NULL, 4, NULL);
+  ASSERT(r == UV_EINVAL);
+
+  r = uv_fs_close(NULL, &close_req, open_req1.result, NULL);
+  ASSERT(r == 0);
+  uv_fs_req_cleanup(&close_req);
+
+  /* Cleanup */
+  unlink("test_file");
+
+  MAKE_VALGRIND_HAPPY();
+  return 0;
+}
+
+
 TEST_IMPL(fs_null_req) {
   /* Verify that all fs functions return UV_EINVAL when the request is NULL. */
   int r;
@@ -3526,6 +4211,15 @@ TEST_IMPL(fs_null_req) {
   r = uv_fs_ftruncate(NULL, NULL, 0, 0, NULL);
   ASSERT(r == UV_EINVAL);
 
+  r = uv_fs_fadvise(NULL, NULL, 0, 0, 0, 0, NULL);
+  ASSERT(r == UV_EINVAL);
+
+  r = uv_fs_readahead(NULL, NULL, 0, 0, 0, NULL);
+  ASSERT(r == UV_EINVAL);
+
+  r = uv_fs_fallocate(NULL, NULL, 0, 0, 0, 0, NULL);
+  ASSERT(r == UV_EINVAL);
+
   r = uv_fs_copyfile(NULL, NULL, NULL, NULL, 0, NULL);
   ASSERT(r == UV_EINVAL);
 
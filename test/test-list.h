@@ -92,6 +92,14 @@ TEST_DECLARE   (tcp_writealot)
 TEST_DECLARE   (tcp_write_fail)
 TEST_DECLARE   (tcp_try_write)
 TEST_DECLARE   (tcp_write_queue_order)
+TEST_DECLARE   (tcp_write_zerocopy)
+TEST_DECLARE   (tcp_write_zerocopy_close)
+TEST_DECLARE   (tcp_batch_writes)
+TEST_DECLARE   (tcp_fastopen)
+TEST_DECLARE   (tcp_get_info)
+TEST_DECLARE   (tcp_get_info_pipe_to)
+TEST_DECLARE   (tcp_accept_batch)
+TEST_DECLARE   (tcp_accept_budget)
 TEST_DECLARE   (tcp_open)
 TEST_DECLARE   (tcp_open_twice)
 TEST_DECLARE   (tcp_open_bound)
@@ -106,6 +114,7 @@ TEST_DECLARE   (tcp_bind_error_inval)
 TEST_DECLARE   (tcp_bind_localhost_ok)
 TEST_DECLARE   (tcp_bind_invalid_flags)
 TEST_DECLARE   (tcp_bind_writable_flags)
+TEST_DECLARE   (tcp_bind_reuseport)
 TEST_DECLARE   (tcp_listen_without_bind)
 TEST_DECLARE   (tcp_connect_error_fault)
 TEST_DECLARE   (tcp_connect_timeout)
@@ -123,6 +132,9 @@ TEST_DECLARE   (tcp_flags)
 TEST_DECLARE   (tcp_write_to_half_open_connection)
 TEST_DECLARE   (tcp_unexpected_read)
 TEST_DECLARE   (tcp_read_stop)
+#ifndef _WIN32
+TEST_DECLARE   (tcp_read_pooled)
+#endif
 TEST_DECLARE   (tcp_bind6_error_addrinuse)
 TEST_DECLARE   (tcp_bind6_error_addrnotavail)
 TEST_DECLARE   (tcp_bind6_error_fault)
@@ -132,6 +144,7 @@ TEST_DECLARE   (tcp_write_ready)
 TEST_DECLARE   (udp_alloc_cb_fail)
 TEST_DECLARE   (udp_bind)
 TEST_DECLARE   (udp_bind_reuseaddr)
+TEST_DECLARE   (udp_bind_reuseport)
 TEST_DECLARE   (udp_create_early)
 TEST_DECLARE   (udp_create_early_bad_bind)
 TEST_DECLARE   (udp_create_early_bad_domain)
@@ -153,6 +166,13 @@ TEST_DECLARE   (udp_no_autobind)
 TEST_DECLARE   (udp_open)
 TEST_DECLARE   (udp_open_twice)
 TEST_DECLARE   (udp_try_send)
+TEST_DECLARE   (udp_connect)
+TEST_DECLARE   (udp_recv_info)
+TEST_DECLARE   (udp_recv_info6)
+TEST_DECLARE   (udp_mmsg)
+TEST_DECLARE   (udp_mmsg_send)
+TEST_DECLARE   (udp_send_gso)
+TEST_DECLARE   (udp_recv_gro)
 TEST_DECLARE   (pipe_bind_error_addrinuse)
 TEST_DECLARE   (pipe_bind_error_addrnotavail)
 TEST_DECLARE   (pipe_bind_error_inval)
@@ -173,6 +193,13 @@ TEST_DECLARE   (shutdown_close_tcp)
 TEST_DECLARE   (shutdown_close_pipe)
 TEST_DECLARE   (shutdown_eof)
 TEST_DECLARE   (shutdown_twice)
+TEST_DECLARE   (stream_pipe_to)
+TEST_DECLARE   (stream_pipe_to_close)
+TEST_DECLARE   (stream_sendfile)
+TEST_DECLARE   (stream_sendfile_short)
+TEST_DECLARE   (stream_sendfile_large)
+TEST_DECLARE   (stream_write_gather)
+TEST_DECLARE   (stream_write_queue_limits)
 TEST_DECLARE   (callback_stack)
 TEST_DECLARE   (env_vars)
 TEST_DECLARE   (error_message)
@@ -280,6 +307,7 @@ TEST_DECLARE   (spawn_quoted_path)
 TEST_DECLARE   (spawn_tcp_server)
 TEST_DECLARE   (fs_poll)
 TEST_DECLARE   (fs_poll_getpath)
+TEST_DECLARE   (fs_poll_batch)
 TEST_DECLARE   (kill)
 TEST_DECLARE   (kill_invalid_signum)
 TEST_DECLARE   (fs_file_noent)
@@ -316,10 +344,14 @@ TEST_DECLARE   (fs_stat_missing_path)
 TEST_DECLARE   (fs_read_file_eof)
 TEST_DECLARE   (fs_event_watch_dir)
 TEST_DECLARE   (fs_event_watch_dir_recursive)
+TEST_DECLARE   (fs_event_watch_dir_recursive_new_subdir)
+TEST_DECLARE   (fs_event_watch_mount)
+TEST_DECLARE   (fs_event_watch_mount_overflow)
 #ifdef _WIN32
 TEST_DECLARE   (fs_event_watch_dir_short_path)
 #endif
 TEST_DECLARE   (fs_event_watch_file)
+TEST_DECLARE   (fs_event_watch_dir_coalesce)
 TEST_DECLARE   (fs_event_watch_file_exact_path)
 TEST_DECLARE   (fs_event_watch_file_twice)
 TEST_DECLARE   (fs_event_watch_file_current_dir)
@@ -349,6 +381,12 @@ TEST_DECLARE   (fs_write_alotof_bufs_with_offset)
 TEST_DECLARE   (fs_partial_read)
 TEST_DECLARE   (fs_partial_write)
 TEST_DECLARE   (fs_file_pos_after_op_with_offset)
+TEST_DECLARE   (fs_fadvise)
+TEST_DECLARE   (fs_fallocate)
+TEST_DECLARE   (fs_read_aligned)
+TEST_DECLARE   (fs_fsync_group_commit)
+TEST_DECLARE   (fs_write_coalesce)
+TEST_DECLARE   (fs_read_multi)
 TEST_DECLARE   (fs_null_req)
 TEST_DECLARE   (fs_read_dir)
 #ifdef _WIN32
@@ -569,6 +607,26 @@ TASK_LIST_START
 
   TEST_ENTRY  (tcp_write_queue_order)
 
+  TEST_ENTRY  (tcp_write_zerocopy)
+  TEST_HELPER (tcp_write_zerocopy, tcp4_echo_server)
+
+  TEST_ENTRY  (tcp_write_zerocopy_close)
+  TEST_HELPER (tcp_write_zerocopy_close, tcp4_echo_server)
+
+  TEST_ENTRY  (tcp_batch_writes)
+  TEST_HELPER (tcp_batch_writes, tcp4_echo_server)
+
+  TEST_ENTRY  (tcp_fastopen)
+
+  TEST_ENTRY  (tcp_get_info)
+  TEST_HELPER (tcp_get_info, tcp4_echo_server)
+
+  TEST_ENTRY  (tcp_get_info_pipe_to)
+  TEST_HELPER (tcp_get_info_pipe_to, tcp4_echo_server)
+
+  TEST_ENTRY  (tcp_accept_batch)
+  TEST_ENTRY  (tcp_accept_budget)
+
   TEST_ENTRY  (tcp_open)
   TEST_HELPER (tcp_open, tcp4_echo_server)
   TEST_ENTRY  (tcp_open_twice)
@@ -590,6 +648,7 @@ TASK_LIST_START
   TEST_ENTRY  (tcp_bind_localhost_ok)
   TEST_ENTRY  (tcp_bind_invalid_flags)
   TEST_ENTRY  (tcp_bind_writable_flags)
+  TEST_ENTRY  (tcp_bind_reuseport)
   TEST_ENTRY  (tcp_listen_without_bind)
   TEST_ENTRY  (tcp_connect_error_fault)
   TEST_ENTRY  (tcp_connect_timeout)
@@ -610,6 +669,11 @@ TASK_LIST_START
   TEST_ENTRY  (tcp_read_stop)
   TEST_HELPER (tcp_read_stop, tcp4_echo_server)
 
+#ifndef _WIN32
+  TEST_ENTRY  (tcp_read_pooled)
+  TEST_HELPER (tcp_read_pooled, tcp4_echo_server)
+#endif
+
   TEST_ENTRY  (tcp_bind6_error_addrinuse)
   TEST_ENTRY  (tcp_bind6_error_addrnotavail)
   TEST_ENTRY  (tcp_bind6_error_fault)
@@ -619,6 +683,7 @@ TASK_LIST_START
   TEST_ENTRY  (udp_alloc_cb_fail)
   TEST_ENTRY  (udp_bind)
   TEST_ENTRY  (udp_bind_reuseaddr)
+  TEST_ENTRY  (udp_bind_reuseport)
   TEST_ENTRY  (udp_create_early)
   TEST_ENTRY  (udp_create_early_bad_bind)
   TEST_ENTRY  (udp_create_early_bad_domain)
@@ -638,6 +703,13 @@ TASK_LIST_START
   TEST_ENTRY  (udp_multicast_join6)
   TEST_ENTRY  (udp_multicast_ttl)
   TEST_ENTRY  (udp_try_send)
+  TEST_ENTRY  (udp_connect)
+  TEST_ENTRY  (udp_recv_info)
+  TEST_ENTRY  (udp_recv_info6)
+  TEST_ENTRY  (udp_mmsg)
+  TEST_ENTRY  (udp_mmsg_send)
+  TEST_ENTRY  (udp_send_gso)
+  TEST_ENTRY  (udp_recv_gro)
 
   TEST_ENTRY  (udp_open)
   TEST_HELPER (udp_open, udp4_echo_server)
@@ -668,6 +740,14 @@ TASK_LIST_START
   TEST_ENTRY  (shutdown_twice)
   TEST_HELPER (shutdown_twice, tcp4_echo_server)
 
+  TEST_ENTRY  (stream_pipe_to)
+  TEST_ENTRY  (stream_pipe_to_close)
+  TEST_ENTRY  (stream_sendfile)
+  TEST_ENTRY  (stream_sendfile_short)
+  TEST_ENTRY  (stream_sendfile_large)
+  TEST_ENTRY  (stream_write_gather)
+  TEST_ENTRY  (stream_write_queue_limits)
+
   TEST_ENTRY  (callback_stack)
   TEST_HELPER (callback_stack, tcp4_echo_server)
 
@@ -817,6 +897,7 @@ TASK_LIST_START
   TEST_ENTRY  (spawn_tcp_server)
   TEST_ENTRY  (fs_poll)
   TEST_ENTRY  (fs_poll_getpath)
+  TEST_ENTRY  (fs_poll_batch)
   TEST_ENTRY  (kill)
   TEST_ENTRY  (kill_invalid_signum)
 
@@ -885,10 +966,14 @@ TASK_LIST_START
   TEST_ENTRY  (fs_file_open_append)
   TEST_ENTRY  (fs_event_watch_dir)
   TEST_ENTRY  (fs_event_watch_dir_recursive)
+  TEST_ENTRY  (fs_event_watch_dir_recursive_new_subdir)
+  TEST_ENTRY  (fs_event_watch_mount)
+  TEST_ENTRY  (fs_event_watch_mount_overflow)
 #ifdef _WIN32
   TEST_ENTRY  (fs_event_watch_dir_short_path)
 #endif
   TEST_ENTRY  (fs_event_watch_file)
+  TEST_ENTRY  (fs_event_watch_dir_coalesce)
   TEST_ENTRY  (fs_event_watch_file_exact_path)
   TEST_ENTRY  (fs_event_watch_file_twice)
   TEST_ENTRY  (fs_event_watch_file_current_dir)
@@ -916,6 +1001,12 @@ TASK_LIST_START
   TEST_ENTRY  (fs_partial_write)
   TEST_ENTRY  (fs_read_write_null_arguments)
   TEST_ENTRY  (fs_file_pos_after_op_with_offset)
+  TEST_ENTRY  (fs_fadvise)
+  TEST_ENTRY  (fs_fallocate)
+  TEST_ENTRY  (fs_read_aligned)
+  TEST_ENTRY  (fs_fsync_group_commit)
+  TEST_ENTRY  (fs_write_coalesce)
+  TEST_ENTRY  (fs_read_multi)
   TEST_ENTRY  (fs_null_req)
   TEST_ENTRY  (fs_read_dir)
 #ifdef _WIN32
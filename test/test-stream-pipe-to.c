@@ -0,0 +1,234 @@
+/* Copyright libuv project contributors. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include "uv.h"
+#include "task.h"
+
+#ifdef _WIN32
+
+TEST_IMPL(stream_pipe_to) {
+  RETURN_SKIP("Test not implemented on Windows.");
+}
+
+TEST_IMPL(stream_pipe_to_close) {
+  RETURN_SKIP("Test not implemented on Windows.");
+}
+
+#else  /* !_WIN32 */
+
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+
+#define TOTAL_BYTES (1024 * 1024)
+
+/* Data goes in at a, is spliced from b to c and comes out at d. */
+static uv_pipe_t a;
+static uv_pipe_t b;
+static uv_pipe_t c;
+static uv_pipe_t d;
+
+static uv_stream_pipe_t pipe_req;
+static uv_write_t write_req;
+static uv_shutdown_t shutdown_req;
+
+static char* send_buffer;
+static char* recv_buffer;
+static size_t bytes_received;
+static int close_on_read;
+
+static int pipe_cb_called;
+static int pipe_cb_status;
+static int write_cb_called;
+static int shutdown_cb_called;
+static int close_cb_called;
+
+
+static void close_cb(uv_handle_t* handle) {
+  close_cb_called++;
+}
+
+
+static void alloc_cb(uv_handle_t* handle, size_t size, uv_buf_t* buf) {
+  buf->base = malloc(size);
+  buf->len = size;
+}
+
+
+static void read_cb(uv_stream_t* stream, ssize_t nread, const uv_buf_t* buf) {
+  ASSERT(stream == (uv_stream_t*) &d);
+
+  if (nread > 0) {
+    ASSERT(bytes_received + nread <= TOTAL_BYTES);
+    memcpy(recv_buffer + bytes_received, buf->base, nread);
+    bytes_received += nread;
+
+    if (close_on_read && !uv_is_closing((uv_handle_t*) &b))
+      uv_close((uv_handle_t*) &b, close_cb);
+  } else if (nread < 0) {
+    ASSERT(nread == UV_EOF);
+    uv_close((uv_handle_t*) &d, close_cb);
+  }
+
+  free(buf->base);
+}
+
+
+static void write_cb(uv_write_t* req, int status) {
+  ASSERT(req == &write_req);
+  write_cb_called++;
+}
+
+
+static void shutdown_cb(uv_shutdown_t* req, int status) {
+  ASSERT(req == &shutdown_req);
+  ASSERT(status == 0);
+  shutdown_cb_called++;
+  uv_close((uv_handle_t*) &a, close_cb);
+}
+
+
+static void pipe_cb(uv_stream_pipe_t* req, int status) {
+  ASSERT(req == &pipe_req);
+  ASSERT(req->src == (uv_stream_t*) &b);
+  ASSERT(req->dst == (uv_stream_t*) &c);
+  pipe_cb_called++;
+  pipe_cb_status = status;
+
+  if (!uv_is_closing((uv_handle_t*) &b))
+    uv_close((uv_handle_t*) &b, close_cb);
+  uv_close((uv_handle_t*) &c, close_cb);
+}
+
+
+static void open_pair(uv_loop_t* loop, uv_pipe_t* p0, uv_pipe_t* p1) {
+  int fds[2];
+
+  ASSERT(0 == socketpair(AF_UNIX, SOCK_STREAM, 0, fds));
+  ASSERT(0 == uv_pipe_init(loop, p0, 0));
+  ASSERT(0 == uv_pipe_init(loop, p1, 0));
+  ASSERT(0 == uv_pipe_open(p0, fds[0]));
+  ASSERT(0 == uv_pipe_open(p1, fds[1]));
+}
+
+
+static int start(uv_loop_t* loop) {
+  uv_buf_t buf;
+  int i;
+  int r;
+
+  send_buffer = malloc(TOTAL_BYTES);
+  recv_buffer = malloc(TOTAL_BYTES);
+  ASSERT(send_buffer != NULL);
+  ASSERT(recv_buffer != NULL);
+
+  for (i = 0; i < TOTAL_BYTES; i++)
+    send_buffer[i] = i % 251;
+
+  open_pair(loop, &a, &b);
+  open_pair(loop, &c, &d);
+
+  r = uv_stream_pipe_to(&pipe_req,
+                        (uv_stream_t*) &b,
+                        (uv_stream_t*) &c,
+                        pipe_cb);
+  if (r == UV_ENOSYS)
+    return r;
+  ASSERT(r == 0);
+
+  /* The spliced directions belong to the request. */
+  buf = uv_buf_init(send_buffer, 1);
+  ASSERT(UV_EBUSY == uv_read_start((uv_stream_t*) &b, alloc_cb, read_cb));
+  ASSERT(UV_EBUSY == uv_write(&write_req, (uv_stream_t*) &c, &buf, 1, NULL));
+  ASSERT(UV_EBUSY == uv_stream_pipe_to(&pipe_req,
+                                       (uv_stream_t*) &b,
+                                       (uv_stream_t*) &d,
+                                       pipe_cb));
+
+  buf = uv_buf_init(send_buffer, TOTAL_BYTES);
+  ASSERT(0 == uv_write(&write_req, (uv_stream_t*) &a, &buf, 1, write_cb));
+  ASSERT(0 == uv_read_start((uv_stream_t*) &d, alloc_cb, read_cb));
+
+  return 0;
+}
+
+
+static void cleanup(uv_loop_t* loop) {
+  free(send_buffer);
+  free(recv_buffer);
+}
+
+
+TEST_IMPL(stream_pipe_to) {
+  uv_loop_t* loop;
+
+  loop = uv_default_loop();
+  if (start(loop) == UV_ENOSYS) {
+    cleanup(loop);
+    RETURN_SKIP("splice() not available.");
+  }
+
+  /* EOF on a is passed on from b to c, and shows up on d. */
+  ASSERT(0 == uv_shutdown(&shutdown_req, (uv_stream_t*) &a, shutdown_cb));
+
+  ASSERT(0 == uv_run(loop, UV_RUN_DEFAULT));
+
+  ASSERT(write_cb_called == 1);
+  ASSERT(shutdown_cb_called == 1);
+  ASSERT(pipe_cb_called == 1);
+  ASSERT(pipe_cb_status == 0);
+  ASSERT(pipe_req.nbytes == TOTAL_BYTES);
+  ASSERT(close_cb_called == 4);
+  ASSERT(bytes_received == TOTAL_BYTES);
+  ASSERT(0 == memcmp(send_buffer, recv_buffer, TOTAL_BYTES));
+
+  cleanup(loop);
+  MAKE_VALGRIND_HAPPY();
+  return 0;
+}
+
+
+TEST_IMPL(stream_pipe_to_close) {
+  uv_loop_t* loop;
+
+  loop = uv_default_loop();
+  if (start(loop) == UV_ENOSYS) {
+    cleanup(loop);
+    RETURN_SKIP("splice() not available.");
+  }
+
+  /* Closing the source mid-stream cancels the request. */
+  close_on_read = 1;
+
+  ASSERT(0 == uv_run(loop, UV_RUN_DEFAULT));
+
+  ASSERT(pipe_cb_called == 1);
+  ASSERT(pipe_cb_status == UV_ECANCELED);
+  ASSERT(pipe_req.nbytes > 0);
+  ASSERT(pipe_req.nbytes <= TOTAL_BYTES);
+  ASSERT(bytes_received == pipe_req.nbytes);
+
+  cleanup(loop);
+  MAKE_VALGRIND_HAPPY();
+  return 0;
+}
+
+#endif  /* !_WIN32 */
@@ -0,0 +1,335 @@
+/* Copyright libuv project contributors. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include "uv.h"
+#include "task.h"
+
+#ifdef _WIN32
+
+TEST_IMPL(stream_sendfile) {
+  RETURN_SKIP("Test not implemented on Windows.");
+}
+
+TEST_IMPL(stream_sendfile_short) {
+  RETURN_SKIP("Test not implemented on Windows.");
+}
+
+TEST_IMPL(stream_sendfile_large) {
+  RETURN_SKIP("Test not implemented on Windows.");
+}
+
+#else  /* !_WIN32 */
+
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define FILE_NAME     "test_file_stream_sendfile"
+#define FILE_SIZE     (1024 * 1024)
+#define FILE_OFFSET   1000
+#define SEGMENT_SIZE  (FILE_SIZE - 2 * FILE_OFFSET)
+/* Where the data starts in the sparse file of stream_sendfile_large. */
+#define LARGE_BASE    ((int64_t) 1 << 32)
+
+static const char head[] = "HEAD";
+static const char tail[] = "TAIL";
+
+static uv_pipe_t writer;
+static uv_pipe_t reader;
+static uv_write_t head_req;
+static uv_write_t file_req;
+static uv_write_t tail_req;
+static uv_shutdown_t shutdown_req;
+static uv_file file;
+static int64_t file_base;
+
+static char* file_buffer;
+static char* recv_buffer;
+static size_t bytes_received;
+
+static int write_cb_called;
+static int file_cb_status;
+static int tail_cb_status;
+static int shutdown_cb_called;
+static int shutdown_cb_status;
+static int close_cb_called;
+
+
+static void close_cb(uv_handle_t* handle) {
+  close_cb_called++;
+}
+
+
+static void alloc_cb(uv_handle_t* handle, size_t size, uv_buf_t* buf) {
+  buf->base = malloc(size);
+  buf->len = size;
+}
+
+
+static void read_cb(uv_stream_t* stream, ssize_t nread, const uv_buf_t* buf) {
+  if (nread > 0) {
+    ASSERT(bytes_received + nread <= 2 * FILE_SIZE);
+    memcpy(recv_buffer + bytes_received, buf->base, nread);
+    bytes_received += nread;
+  } else if (nread < 0) {
+    ASSERT(nread == UV_EOF);
+    uv_close((uv_handle_t*) stream, close_cb);
+  }
+
+  free(buf->base);
+}
+
+
+static void write_cb(uv_write_t* req, int status) {
+  /* Completions arrive in queue order. */
+  if (write_cb_called == 0)
+    ASSERT(req == &head_req);
+  else if (write_cb_called == 1)
+    ASSERT(req == &file_req);
+  else
+    ASSERT(req == &tail_req);
+
+  if (req == &head_req)
+    ASSERT(status == 0);
+  else if (req == &file_req)
+    file_cb_status = status;
+  else
+    tail_cb_status = status;
+
+  /* Whatever is queued behind a failed write is cancelled on close. */
+  if (status < 0 && !uv_is_closing((uv_handle_t*) &writer))
+    uv_close((uv_handle_t*) &writer, close_cb);
+
+  write_cb_called++;
+}
+
+
+static void shutdown_cb(uv_shutdown_t* req, int status) {
+  ASSERT(req == &shutdown_req);
+  shutdown_cb_called++;
+  shutdown_cb_status = status;
+
+  if (!uv_is_closing((uv_handle_t*) &writer))
+    uv_close((uv_handle_t*) &writer, close_cb);
+}
+
+
+static void create_file(void) {
+  uv_fs_t req;
+  uv_buf_t buf;
+  int i;
+  int r;
+
+  file_buffer = malloc(FILE_SIZE);
+  recv_buffer = malloc(2 * FILE_SIZE);
+  ASSERT(file_buffer != NULL);
+  ASSERT(recv_buffer != NULL);
+
+  for (i = 0; i < FILE_SIZE; i++)
+    file_buffer[i] = i % 251;
+
+  unlink(FILE_NAME);
+  r = uv_fs_open(NULL,
+                 &req,
+                 FILE_NAME,
+                 UV_FS_O_RDWR | UV_FS_O_CREAT | UV_FS_O_TRUNC,
+                 S_IWUSR | S_IRUSR,
+                 NULL);
+  ASSERT(r >= 0);
+  file = r;
+  uv_fs_req_cleanup(&req);
+
+  buf = uv_buf_init(file_buffer, FILE_SIZE);
+  r = uv_fs_write(NULL, &req, file, &buf, 1, file_base, NULL);
+  ASSERT(r == FILE_SIZE);
+  uv_fs_req_cleanup(&req);
+}
+
+
+static void cleanup(void) {
+  uv_fs_t req;
+
+  uv_fs_close(NULL, &req, file, NULL);
+  uv_fs_req_cleanup(&req);
+  unlink(FILE_NAME);
+  free(file_buffer);
+  free(recv_buffer);
+}
+
+
+static int start(uv_loop_t* loop, int64_t offset, size_t length) {
+  uv_buf_t buf;
+  int fds[2];
+  int r;
+
+  create_file();
+
+  ASSERT(0 == socketpair(AF_UNIX, SOCK_STREAM, 0, fds));
+  ASSERT(0 == uv_pipe_init(loop, &writer, 0));
+  ASSERT(0 == uv_pipe_init(loop, &reader, 0));
+  ASSERT(0 == uv_pipe_open(&writer, fds[0]));
+  ASSERT(0 == uv_pipe_open(&reader, fds[1]));
+
+  ASSERT(UV_EBADF == uv_stream_sendfile(&file_req,
+                                        (uv_stream_t*) &writer,
+                                        -1,
+                                        0,
+                                        1,
+                                        write_cb));
+
+  buf = uv_buf_init((char*) head, sizeof(head) - 1);
+  ASSERT(0 == uv_write(&head_req, (uv_stream_t*) &writer, &buf, 1, write_cb));
+
+  r = uv_stream_sendfile(&file_req,
+                         (uv_stream_t*) &writer,
+                         file,
+                         offset,
+                         length,
+                         write_cb);
+  if (r == UV_ENOSYS)
+    return r;
+  ASSERT(r == 0);
+
+  buf = uv_buf_init((char*) tail, sizeof(tail) - 1);
+  ASSERT(0 == uv_write(&tail_req, (uv_stream_t*) &writer, &buf, 1, write_cb));
+  ASSERT(0 == uv_shutdown(&shutdown_req,
+                          (uv_stream_t*) &writer,
+                          shutdown_cb));
+  ASSERT(0 == uv_read_start((uv_stream_t*) &reader, alloc_cb, read_cb));
+
+  return 0;
+}
+
+
+TEST_IMPL(stream_sendfile) {
+  uv_loop_t* loop;
+  char* p;
+
+  loop = uv_default_loop();
+  if (start(loop, FILE_OFFSET, SEGMENT_SIZE) == UV_ENOSYS) {
+    uv_close((uv_handle_t*) &writer, NULL);
+    uv_close((uv_handle_t*) &reader, NULL);
+    uv_run(loop, UV_RUN_DEFAULT);
+    cleanup();
+    RETURN_SKIP("uv_stream_sendfile() not supported on this platform.");
+  }
+
+  ASSERT(0 == uv_run(loop, UV_RUN_DEFAULT));
+
+  ASSERT(write_cb_called == 3);
+  ASSERT(file_cb_status == 0);
+  ASSERT(tail_cb_status == 0);
+  ASSERT(shutdown_cb_called == 1);
+  ASSERT(shutdown_cb_status == 0);
+  ASSERT(close_cb_called == 2);
+
+  /* The file segment sits between the buffers that were queued around it. */
+  p = recv_buffer;
+  ASSERT(bytes_received == sizeof(head) - 1 + SEGMENT_SIZE + sizeof(tail) - 1);
+  ASSERT(0 == memcmp(p, head, sizeof(head) - 1));
+  p += sizeof(head) - 1;
+  ASSERT(0 == memcmp(p, file_buffer + FILE_OFFSET, SEGMENT_SIZE));
+  p += SEGMENT_SIZE;
+  ASSERT(0 == memcmp(p, tail, sizeof(tail) - 1));
+
+  cleanup();
+
+  MAKE_VALGRIND_HAPPY();
+  return 0;
+}
+
+
+TEST_IMPL(stream_sendfile_short) {
+  uv_loop_t* loop;
+
+  loop = uv_default_loop();
+  if (start(loop, FILE_OFFSET, FILE_SIZE) == UV_ENOSYS) {
+    uv_close((uv_handle_t*) &writer, NULL);
+    uv_close((uv_handle_t*) &reader, NULL);
+    uv_run(loop, UV_RUN_DEFAULT);
+    cleanup();
+    RETURN_SKIP("uv_stream_sendfile() not supported on this platform.");
+  }
+
+  ASSERT(0 == uv_run(loop, UV_RUN_DEFAULT));
+
+  /* The file runs out before the segment does. What was there got sent and
+   * the request fails with UV_EOF.
+   */
+  ASSERT(write_cb_called == 3);
+  ASSERT(file_cb_status == UV_EOF);
+  ASSERT(tail_cb_status == UV_ECANCELED);
+  ASSERT(shutdown_cb_called == 1);
+  ASSERT(shutdown_cb_status == UV_ECANCELED);
+  ASSERT(close_cb_called == 2);
+  ASSERT(bytes_received == sizeof(head) - 1 + FILE_SIZE - FILE_OFFSET);
+
+  cleanup();
+
+  MAKE_VALGRIND_HAPPY();
+  return 0;
+}
+
+
+TEST_IMPL(stream_sendfile_large) {
+  uv_loop_t* loop;
+
+  if (sizeof(size_t) < 8)
+    RETURN_SKIP("Segments of 4 GB and more need a 64 bit size_t.");
+
+  /* The data sits behind a 4 GB hole. The segment is longer than the file by
+   * more than 4 GB too, a length that got truncated to 32 bits would look like
+   * a segment that fits and succeed.
+   */
+  loop = uv_default_loop();
+  file_base = LARGE_BASE;
+  if (start(loop,
+            LARGE_BASE + FILE_OFFSET,
+            (size_t) LARGE_BASE + SEGMENT_SIZE) == UV_ENOSYS) {
+    uv_close((uv_handle_t*) &writer, NULL);
+    uv_close((uv_handle_t*) &reader, NULL);
+    uv_run(loop, UV_RUN_DEFAULT);
+    cleanup();
+    RETURN_SKIP("uv_stream_sendfile() not supported on this platform.");
+  }
+
+  ASSERT(0 == uv_run(loop, UV_RUN_DEFAULT));
+
+  ASSERT(write_cb_called == 3);
+  ASSERT(file_cb_status == UV_EOF);
+  ASSERT(tail_cb_status == UV_ECANCELED);
+  ASSERT(shutdown_cb_called == 1);
+  ASSERT(shutdown_cb_status == UV_ECANCELED);
+  ASSERT(close_cb_called == 2);
+  ASSERT(bytes_received == sizeof(head) - 1 + FILE_SIZE - FILE_OFFSET);
+  ASSERT(0 == memcmp(recv_buffer + sizeof(head) - 1,
+                     file_buffer + FILE_OFFSET,
+                     FILE_SIZE - FILE_OFFSET));
+
+  cleanup();
+
+  MAKE_VALGRIND_HAPPY();
+  return 0;
+}
+
+#endif  /* !_WIN32 */
@@ -0,0 +1,201 @@
+/* Copyright libuv project contributors. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include "uv.h"
+#include "task.h"
+
+#if !defined(__linux__)
+
+TEST_IMPL(stream_write_gather) {
+  RETURN_SKIP("Needs F_SETPIPE_SZ, Linux only.");
+}
+
+#else  /* __linux__ */
+
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+/* A pipe that holds a single page takes exactly one page per write when it
+ * is empty. That makes every writev() partial and puts its end where the
+ * test wants it. The sizes are in quarters of that page:
+ *
+ *   write 1: 0 and 1, ends on the boundary after 1
+ *   write 2: 2 and the first quarter of 3, ends inside 3
+ *   write 3: the rest of 3 and 4, ends on the boundary after 4
+ *   write 4: inside 5
+ *   write 5: inside 5
+ *   write 6: the rest of 5 and 6, ends on the boundary after 6
+ */
+#define NUM_REQS 7
+#define NUM_WRITES 6
+
+static const int req_quarters[NUM_REQS] = { 1, 3, 3, 3, 2, 10, 2 };
+
+/* Requests done and bytes still queued, in quarters, after each write. */
+static const int done_after[NUM_WRITES] = { 2, 3, 5, 5, 5, 7 };
+static const int queued_after[NUM_WRITES] = { 20, 16, 12, 8, 4, 0 };
+
+/* Bytes still queued, in quarters, when each request's callback runs. */
+static const int queued_at_cb[NUM_REQS] = { 20, 20, 16, 12, 12, 0, 0 };
+
+static uv_pipe_t writer;
+static uv_prepare_t prepare_handle;
+static uv_write_t write_reqs[NUM_REQS];
+static char* send_buffer;
+static size_t send_offset;
+static size_t page;
+static int read_fd;
+
+static int write_cb_called;
+static int writes_seen;
+static int close_cb_called;
+
+
+static void close_cb(uv_handle_t* handle) {
+  close_cb_called++;
+}
+
+
+static void write_cb(uv_write_t* req, int status) {
+  ASSERT(status == 0);
+
+  /* In order, one at a time. */
+  ASSERT(req == &write_reqs[write_cb_called]);
+  ASSERT(uv_stream_get_write_queue_size((uv_stream_t*) &writer) ==
+         queued_at_cb[write_cb_called] * (page / 4));
+  write_cb_called++;
+}
+
+
+/* Empties the pipe, which holds what the last writev() wrote. */
+static size_t drain(char* data) {
+  ssize_t n;
+
+  n = read(read_fd, data, page);
+  ASSERT(n > 0);
+  return n;
+}
+
+
+/* Runs before the loop polls. The writev() can happen in the poll phase or,
+ * when a finished request fed the watcher, in the pending phase. Either way
+ * the pipe is full afterwards and nothing writes to it until it's drained
+ * here, so there's exactly one writev() per full pipe.
+ */
+static void prepare_cb(uv_prepare_t* handle) {
+  char data[65536];
+  size_t n;
+  int avail;
+
+  ASSERT(0 == ioctl(read_fd, FIONREAD, &avail));
+  if (avail == 0)
+    return;  /* Nothing written yet. */
+
+  ASSERT(writes_seen < NUM_WRITES);
+  ASSERT(write_cb_called == done_after[writes_seen]);
+  ASSERT(uv_stream_get_write_queue_size((uv_stream_t*) &writer) ==
+         queued_after[writes_seen] * (page / 4));
+  writes_seen++;
+
+  /* The data comes out in the order it was queued. */
+  n = drain(data);
+  ASSERT(n == page);
+  ASSERT(0 == memcmp(data, send_buffer + send_offset, n));
+  send_offset += n;
+
+  if (writes_seen == NUM_WRITES) {
+    uv_close((uv_handle_t*) &writer, close_cb);
+    uv_close((uv_handle_t*) handle, close_cb);
+  }
+}
+
+
+TEST_IMPL(stream_write_gather) {
+  uv_buf_t bufs[NUM_REQS];
+  uv_loop_t* loop;
+  size_t offset;
+  char* fill;
+  int fds[2];
+  int i;
+
+  loop = uv_default_loop();
+
+  ASSERT(0 == pipe(fds));
+  ASSERT(fcntl(fds[1], F_SETPIPE_SZ, 1) > 0);
+  page = fcntl(fds[1], F_GETPIPE_SZ);
+  ASSERT(page >= 4096 && page <= 65536);
+  read_fd = fds[0];
+
+  ASSERT(0 == uv_pipe_init(loop, &writer, 0));
+  ASSERT(0 == uv_pipe_open(&writer, fds[1]));
+
+  /* Fill the pipe so that every request queues. */
+  fill = malloc(page);
+  ASSERT(fill != NULL);
+  memset(fill, '-', page);
+  ASSERT((ssize_t) page == write(fds[1], fill, page));
+
+  send_buffer = malloc(NUM_WRITES * page);
+  ASSERT(send_buffer != NULL);
+
+  offset = 0;
+  for (i = 0; i < NUM_REQS; i++) {
+    bufs[i] = uv_buf_init(send_buffer + offset, req_quarters[i] * (page / 4));
+    memset(bufs[i].base, 'a' + i, bufs[i].len);
+    offset += bufs[i].len;
+    ASSERT(0 == uv_write(&write_reqs[i],
+                         (uv_stream_t*) &writer,
+                         &bufs[i],
+                         1,
+                         write_cb));
+  }
+  ASSERT(offset == NUM_WRITES * page);
+
+  ASSERT(write_cb_called == 0);
+  ASSERT(uv_stream_get_write_queue_size((uv_stream_t*) &writer) ==
+         NUM_WRITES * page);
+
+  /* Make room for the first write. */
+  ASSERT(page == drain(fill));
+  ASSERT(0 == memcmp(fill, "----", 4));
+
+  ASSERT(0 == uv_prepare_init(loop, &prepare_handle));
+  ASSERT(0 == uv_prepare_start(&prepare_handle, prepare_cb));
+
+  ASSERT(0 == uv_run(loop, UV_RUN_DEFAULT));
+
+  ASSERT(writes_seen == NUM_WRITES);
+  ASSERT(write_cb_called == NUM_REQS);
+  ASSERT(send_offset == NUM_WRITES * page);
+  ASSERT(close_cb_called == 2);
+
+  close(read_fd);
+  free(send_buffer);
+  free(fill);
+
+  MAKE_VALGRIND_HAPPY();
+  return 0;
+}
+
+#endif  /* __linux__ */
@@ -0,0 +1,156 @@
+/* Copyright libuv project contributors. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include "uv.h"
+#include "uv.h"
+#include "task.h"
+
+#ifdef _WIN32
+
+TEST_IMPL(stream_write_queue_limits) {
+  RETURN_SKIP("Test not implemented on Windows.");
+}
+
+#else  /* !_WIN32 */
+
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+
+#define CHUNK_SIZE    (256 * 1024)
+#define NUM_CHUNKS    16
+#define HIGH_WATER    (512 * 1024)
+#define LOW_WATER     (64 * 1024)
+
+static uv_pipe_t writer;
+static uv_pipe_t reader;
+static uv_write_t write_reqs[NUM_CHUNKS];
+static char* send_buffer;
+static size_t bytes_received;
+static int in_write;
+
+static int write_cb_called;
+static int full_cb_called;
+static int drain_cb_called;
+static int close_cb_called;
+
+
+static void close_cb(uv_handle_t* handle) {
+  close_cb_called++;
+}
+
+
+static void alloc_cb(uv_handle_t* handle, size_t size, uv_buf_t* buf) {
+  buf->base = malloc(size);
+  buf->len = size;
+}
+
+
+static void read_cb(uv_stream_t* stream, ssize_t nread, const uv_buf_t* buf) {
+  ASSERT(nread >= 0);
+  bytes_received += nread;
+  free(buf->base);
+
+  if (bytes_received == (size_t) CHUNK_SIZE * NUM_CHUNKS) {
+    uv_close((uv_handle_t*) &writer, close_cb);
+    uv_close((uv_handle_t*) &reader, close_cb);
+  }
+}
+
+
+static void write_cb(uv_write_t* req, int status) {
+  ASSERT(status == 0);
+  write_cb_called++;
+}
+
+
+static void write_queue_cb(uv_stream_t* stream, int full) {
+  ASSERT(stream == (uv_stream_t*) &writer);
+  ASSERT(in_write == 0);
+
+  if (full) {
+    /* Nobody is reading yet, so the queue can only have grown. */
+    ASSERT(full_cb_called == 0);
+    ASSERT(drain_cb_called == 0);
+    ASSERT(stream->write_queue_size > HIGH_WATER);
+    full_cb_called++;
+    ASSERT(0 == uv_read_start((uv_stream_t*) &reader, alloc_cb, read_cb));
+  } else {
+    ASSERT(full_cb_called == 1);
+    ASSERT(drain_cb_called == 0);
+    ASSERT(stream->write_queue_size <= LOW_WATER);
+    drain_cb_called++;
+  }
+}
+
+
+TEST_IMPL(stream_write_queue_limits) {
+  uv_loop_t* loop;
+  uv_buf_t buf;
+  int fds[2];
+  int i;
+  int r;
+
+  loop = uv_default_loop();
+
+  send_buffer = malloc(CHUNK_SIZE);
+  ASSERT(send_buffer != NULL);
+  memset(send_buffer, 'x', CHUNK_SIZE);
+
+  ASSERT(0 == socketpair(AF_UNIX, SOCK_STREAM, 0, fds));
+  ASSERT(0 == uv_pipe_init(loop, &writer, 0));
+  ASSERT(0 == uv_pipe_init(loop, &reader, 0));
+  ASSERT(0 == uv_pipe_open(&writer, fds[0]));
+  ASSERT(0 == uv_pipe_open(&reader, fds[1]));
+
+  ASSERT(UV_EINVAL == uv_stream_set_write_queue_limits((uv_stream_t*) &writer,
+                                                       LOW_WATER,
+                                                       HIGH_WATER,
+                                                       write_queue_cb));
+  ASSERT(0 == uv_stream_set_write_queue_limits((uv_stream_t*) &writer,
+                                               HIGH_WATER,
+                                               LOW_WATER,
+                                               write_queue_cb));
+
+  buf = uv_buf_init(send_buffer, CHUNK_SIZE);
+  for (i = 0; i < NUM_CHUNKS; i++) {
+    in_write = 1;
+    r = uv_write(&write_reqs[i], (uv_stream_t*) &writer, &buf, 1, write_cb);
+    in_write = 0;
+    ASSERT(r == 0);
+  }
+
+  ASSERT(full_cb_called == 0);
+  ASSERT(0 == uv_run(loop, UV_RUN_DEFAULT));
+
+  ASSERT(full_cb_called == 1);
+  ASSERT(drain_cb_called == 1);
+  ASSERT(write_cb_called == NUM_CHUNKS);
+  ASSERT(close_cb_called == 2);
+  ASSERT(bytes_received == (size_t) CHUNK_SIZE * NUM_CHUNKS);
+
+  free(send_buffer);
+
+  MAKE_VALGRIND_HAPPY();
+  return 0;
+}
+
+#endif  /* !_WIN32 */
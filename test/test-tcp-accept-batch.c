@@ -0,0 +1,179 @@
+/* Copyright libuv project contributors. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include "uv.h"
+#include "task.h"
+
+#ifdef _WIN32
+
+TEST_IMPL(tcp_accept_batch) {
+  RETURN_SKIP("Test not implemented on Windows.");
+}
+
+TEST_IMPL(tcp_accept_budget) {
+  RETURN_SKIP("Test not implemented on Windows.");
+}
+
+#else  /* !_WIN32 */
+
+#define NUM_CLIENTS 16
+#define BUDGET      4
+
+static uv_tcp_t server;
+static uv_tcp_t clients[NUM_CLIENTS];
+static uv_tcp_t conns[NUM_CLIENTS];
+static uv_connect_t connect_reqs[NUM_CLIENTS];
+static uv_prepare_t prepare_handle;
+
+static unsigned int accepted;
+static unsigned int accepted_this_iteration;
+static unsigned int max_per_iteration;
+static int connect_cb_called;
+static int close_cb_called;
+
+
+static void close_cb(uv_handle_t* handle) {
+  close_cb_called++;
+}
+
+
+static void prepare_cb(uv_prepare_t* handle) {
+  accepted_this_iteration = 0;
+}
+
+
+static void count_accept(void) {
+  accepted++;
+  if (++accepted_this_iteration > max_per_iteration)
+    max_per_iteration = accepted_this_iteration;
+
+  if (accepted == NUM_CLIENTS) {
+    uv_close((uv_handle_t*) &server, close_cb);
+    uv_close((uv_handle_t*) &prepare_handle, close_cb);
+  }
+}
+
+
+static void batch_cb(uv_stream_t* stream,
+                     const uv_os_fd_t fds[],
+                     unsigned int nfds,
+                     int status) {
+  unsigned int i;
+  uv_tcp_t* conn;
+
+  ASSERT(stream == (uv_stream_t*) &server);
+  ASSERT(status == 0);
+  ASSERT(nfds > 0);
+  ASSERT(nfds <= BUDGET);
+
+  for (i = 0; i < nfds; i++) {
+    conn = &conns[accepted];
+    ASSERT(0 == uv_tcp_init(stream->loop, conn));
+    ASSERT(0 == uv_tcp_open(conn, fds[i]));
+    uv_close((uv_handle_t*) conn, close_cb);
+    count_accept();
+  }
+}
+
+
+static void connection_cb(uv_stream_t* stream, int status) {
+  uv_tcp_t* conn;
+
+  ASSERT(stream == (uv_stream_t*) &server);
+  ASSERT(status == 0);
+
+  conn = &conns[accepted];
+  ASSERT(0 == uv_tcp_init(stream->loop, conn));
+  ASSERT(0 == uv_accept(stream, (uv_stream_t*) conn));
+  uv_close((uv_handle_t*) conn, close_cb);
+  count_accept();
+}
+
+
+static void connect_cb(uv_connect_t* req, int status) {
+  ASSERT(status == 0);
+  connect_cb_called++;
+  uv_close((uv_handle_t*) req->handle, close_cb);
+}
+
+
+static void run_test(int batch) {
+  struct sockaddr_in addr;
+  uv_loop_t* loop;
+  int i;
+
+  loop = uv_default_loop();
+  ASSERT(0 == uv_ip4_addr("127.0.0.1", TEST_PORT, &addr));
+
+  ASSERT(0 == uv_tcp_init(loop, &server));
+  ASSERT(0 == uv_tcp_bind(&server, (const struct sockaddr*) &addr, 0));
+  ASSERT(0 == uv_stream_set_accept_budget((uv_stream_t*) &server, BUDGET));
+
+  if (batch) {
+    ASSERT(UV_EINVAL == uv_listen_batch((uv_stream_t*) &server,
+                                       NUM_CLIENTS,
+                                       NULL));
+    ASSERT(0 == uv_listen_batch((uv_stream_t*) &server,
+                                NUM_CLIENTS,
+                                batch_cb));
+  } else {
+    ASSERT(0 == uv_listen((uv_stream_t*) &server,
+                          NUM_CLIENTS,
+                          connection_cb));
+  }
+
+  ASSERT(0 == uv_prepare_init(loop, &prepare_handle));
+  ASSERT(0 == uv_prepare_start(&prepare_handle, prepare_cb));
+
+  for (i = 0; i < NUM_CLIENTS; i++) {
+    ASSERT(0 == uv_tcp_init(loop, &clients[i]));
+    ASSERT(0 == uv_tcp_connect(&connect_reqs[i],
+                               &clients[i],
+                               (const struct sockaddr*) &addr,
+                               connect_cb));
+  }
+
+  ASSERT(0 == uv_run(loop, UV_RUN_DEFAULT));
+
+  ASSERT(accepted == NUM_CLIENTS);
+  ASSERT(connect_cb_called == NUM_CLIENTS);
+  ASSERT(close_cb_called == 2 * NUM_CLIENTS + 2);
+
+  /* The budget spreads the connections over several loop iterations. */
+  ASSERT(max_per_iteration > 0);
+  ASSERT(max_per_iteration <= BUDGET);
+}
+
+
+TEST_IMPL(tcp_accept_batch) {
+  run_test(1);
+  MAKE_VALGRIND_HAPPY();
+  return 0;
+}
+
+
+TEST_IMPL(tcp_accept_budget) {
+  run_test(0);
+  MAKE_VALGRIND_HAPPY();
+  return 0;
+}
+
+#endif  /* !_WIN32 */
@@ -0,0 +1,191 @@
+/* Copyright libuv project contributors. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include "uv.h"
+#include "task.h"
+#include <stdlib.h>
+#include <string.h>
+
+
+#define WRITES      64
+#define WRITE_SIZE  16
+
+#define TOTAL_BYTES (WRITES * WRITE_SIZE)
+
+static char send_buffer[TOTAL_BYTES];
+static char recv_buffer[TOTAL_BYTES];
+
+static uv_tcp_t client;
+static uv_check_t check_handle;
+static uv_prepare_t prepare_handle;
+static uv_connect_t connect_req;
+static uv_shutdown_t shutdown_req;
+static uv_write_t write_reqs[WRITES];
+
+static int connect_cb_called = 0;
+static int write_cb_called = 0;
+static int shutdown_cb_called = 0;
+static int close_cb_called = 0;
+static int corked_in_check = -1;
+static int corked_in_prepare = -1;
+static size_t bytes_received = 0;
+
+
+static int is_corked(void) {
+#if defined(TCP_CORK)
+  uv_os_fd_t fd;
+  socklen_t len;
+  int on;
+
+  ASSERT(0 == uv_fileno((uv_handle_t*) &client, &fd));
+  len = sizeof(on);
+  ASSERT(0 == getsockopt(fd, IPPROTO_TCP, TCP_CORK, &on, &len));
+  return on != 0;
+#else
+  return 0;
+#endif
+}
+
+
+static void alloc_cb(uv_handle_t* handle, size_t size, uv_buf_t* buf) {
+  buf->base = malloc(size);
+  buf->len = size;
+}
+
+
+static void close_cb(uv_handle_t* handle) {
+  close_cb_called++;
+}
+
+
+static void check_cb(uv_check_t* handle) {
+  /* The writes made in connect_cb are still held back here... */
+  if (connect_cb_called == 1 && corked_in_check == -1)
+    corked_in_check = is_corked();
+}
+
+
+static void prepare_cb(uv_prepare_t* handle) {
+  /* ...but not anymore once the loop iteration is over. */
+  if (corked_in_check != -1 && corked_in_prepare == -1) {
+    corked_in_prepare = is_corked();
+    uv_close((uv_handle_t*) &check_handle, close_cb);
+    uv_close((uv_handle_t*) &prepare_handle, close_cb);
+  }
+}
+
+
+static void shutdown_cb(uv_shutdown_t* req, int status) {
+  ASSERT(req == &shutdown_req);
+  ASSERT(status == 0);
+  shutdown_cb_called++;
+}
+
+
+static void read_cb(uv_stream_t* tcp, ssize_t nread, const uv_buf_t* buf) {
+  if (nread >= 0) {
+    ASSERT(bytes_received + nread <= TOTAL_BYTES);
+    memcpy(recv_buffer + bytes_received, buf->base, nread);
+    bytes_received += nread;
+  } else {
+    ASSERT(nread == UV_EOF);
+    uv_close((uv_handle_t*) tcp, close_cb);
+  }
+
+  free(buf->base);
+}
+
+
+static void write_cb(uv_write_t* req, int status) {
+  ASSERT(status == 0);
+  write_cb_called++;
+}
+
+
+static void connect_cb(uv_connect_t* req, int status) {
+  uv_buf_t buf;
+  int i;
+
+  ASSERT(req == &connect_req);
+  ASSERT(status == 0);
+  connect_cb_called++;
+
+  for (i = 0; i < WRITES; i++) {
+    buf = uv_buf_init(send_buffer + i * WRITE_SIZE, WRITE_SIZE);
+    ASSERT(0 == uv_write(write_reqs + i,
+                         (uv_stream_t*) &client,
+                         &buf,
+                         1,
+                         write_cb));
+  }
+
+  ASSERT(0 == uv_shutdown(&shutdown_req,
+                          (uv_stream_t*) &client,
+                          shutdown_cb));
+  ASSERT(0 == uv_read_start((uv_stream_t*) &client, alloc_cb, read_cb));
+}
+
+
+TEST_IMPL(tcp_batch_writes) {
+  struct sockaddr_in addr;
+  uv_loop_t* loop;
+  int i;
+  int r;
+
+  loop = uv_default_loop();
+  ASSERT(0 == uv_ip4_addr("127.0.0.1", TEST_PORT, &addr));
+
+  for (i = 0; i < TOTAL_BYTES; i++)
+    send_buffer[i] = 'a' + i % 23;  /* No Q, see echo-server.c. */
+
+  ASSERT(0 == uv_tcp_init(loop, &client));
+  r = uv_tcp_batch_writes(&client, 1);
+  if (r == UV_ENOTSUP) {
+    uv_close((uv_handle_t*) &client, NULL);
+    uv_run(loop, UV_RUN_DEFAULT);
+    RETURN_SKIP("TCP_CORK not supported on this platform.");
+  }
+  ASSERT(r == 0);
+
+  ASSERT(0 == uv_check_init(loop, &check_handle));
+  ASSERT(0 == uv_check_start(&check_handle, check_cb));
+  ASSERT(0 == uv_prepare_init(loop, &prepare_handle));
+  ASSERT(0 == uv_prepare_start(&prepare_handle, prepare_cb));
+
+  ASSERT(0 == uv_tcp_connect(&connect_req,
+                             &client,
+                             (const struct sockaddr*) &addr,
+                             connect_cb));
+
+  ASSERT(0 == uv_run(loop, UV_RUN_DEFAULT));
+
+  ASSERT(connect_cb_called == 1);
+  ASSERT(write_cb_called == WRITES);
+  ASSERT(shutdown_cb_called == 1);
+  ASSERT(close_cb_called == 3);
+  ASSERT(corked_in_check == 1);
+  ASSERT(corked_in_prepare == 0);
+  ASSERT(bytes_received == TOTAL_BYTES);
+  ASSERT(0 == memcmp(send_buffer, recv_buffer, TOTAL_BYTES));
+
+  MAKE_VALGRIND_HAPPY();
+  return 0;
+}
@@ -256,3 +256,43 @@ TEST_IMPL(tcp_bind_writable_flags) {
   MAKE_VALGRIND_HAPPY();
   return 0;
 }
+
+
+TEST_IMPL(tcp_bind_reuseport) {
+  struct sockaddr_in addr;
+  uv_tcp_t server1, server2;
+  int r;
+
+  ASSERT(0 == uv_ip4_addr("127.0.0.1", TEST_PORT, &addr));
+  r = uv_tcp_init(uv_default_loop(), &server1);
+  ASSERT(r == 0);
+  r = uv_tcp_bind(&server1, (const struct sockaddr*) &addr, UV_TCP_REUSEPORT);
+  if (r == UV_ENOTSUP) {
+    uv_close((uv_handle_t*) &server1, NULL);
+    uv_run(uv_default_loop(), UV_RUN_DEFAULT);
+    MAKE_VALGRIND_HAPPY();
+    RETURN_SKIP("UV_TCP_REUSEPORT is not supported on this platform.");
+  }
+  ASSERT(r == 0);
+
+  r = uv_tcp_init(uv_default_loop(), &server2);
+  ASSERT(r == 0);
+  r = uv_tcp_bind(&server2, (const struct sockaddr*) &addr, UV_TCP_REUSEPORT);
+  ASSERT(r == 0);
+
+  /* Both handles listen on the same port, unlike the addrinuse case. */
+  r = uv_listen((uv_stream_t*)&server1, 128, NULL);
+  ASSERT(r == 0);
+  r = uv_listen((uv_stream_t*)&server2, 128, NULL);
+  ASSERT(r == 0);
+
+  uv_close((uv_handle_t*)&server1, close_cb);
+  uv_close((uv_handle_t*)&server2, close_cb);
+
+  uv_run(uv_default_loop(), UV_RUN_DEFAULT);
+
+  ASSERT(close_cb_called == 2);
+
+  MAKE_VALGRIND_HAPPY();
+  return 0;
+}
@@ -0,0 +1,221 @@
+/* Copyright libuv project contributors. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include "uv.h"
+#include "task.h"
+#include <stdlib.h>
+#include <string.h>
+
+
+#define CONNECTIONS 2
+#define DATA_SIZE   1000
+
+/* Connections are made one after the other, the second one can use the
+ * cookie that the server handed out to the first.
+ */
+static uv_tcp_t server;
+static uv_tcp_t server_conns[CONNECTIONS];
+static uv_tcp_t clients[CONNECTIONS];
+static uv_connect_t connect_reqs[CONNECTIONS];
+static uv_write_t write_reqs[CONNECTIONS];
+static uv_write_t echo_reqs[CONNECTIONS];
+static uv_shutdown_t shutdown_reqs[CONNECTIONS];
+
+static char send_buffer[DATA_SIZE];
+static char echo_buffers[CONNECTIONS][DATA_SIZE];
+static char recv_buffers[CONNECTIONS][DATA_SIZE];
+static size_t echo_bytes[CONNECTIONS];
+static size_t recv_bytes[CONNECTIONS];
+
+static int connection_cb_called;
+static int connect_cb_called;
+static int write_cb_called;
+static int echo_cb_called;
+static int close_cb_called;
+
+
+static void start_connect(int i);
+
+
+static void alloc_cb(uv_handle_t* handle, size_t size, uv_buf_t* buf) {
+  static char slab[65536];
+  buf->base = slab;
+  buf->len = sizeof(slab);
+}
+
+
+static void close_cb(uv_handle_t* handle) {
+  close_cb_called++;
+}
+
+
+static void echo_cb(uv_write_t* req, int status) {
+  ASSERT(status == 0);
+  echo_cb_called++;
+}
+
+
+static void server_read_cb(uv_stream_t* stream,
+                           ssize_t nread,
+                           const uv_buf_t* buf) {
+  uv_buf_t echo_buf;
+  int i;
+
+  i = (uv_tcp_t*) stream - server_conns;
+  ASSERT(i >= 0 && i < CONNECTIONS);
+
+  if (nread < 0) {
+    ASSERT(nread == UV_EOF);
+    ASSERT(echo_bytes[i] == DATA_SIZE);
+    echo_buf = uv_buf_init(echo_buffers[i], DATA_SIZE);
+    ASSERT(0 == uv_write(&echo_reqs[i], stream, &echo_buf, 1, echo_cb));
+    uv_close((uv_handle_t*) stream, close_cb);
+    return;
+  }
+
+  ASSERT(echo_bytes[i] + nread <= DATA_SIZE);
+  memcpy(echo_buffers[i] + echo_bytes[i], buf->base, nread);
+  echo_bytes[i] += nread;
+}
+
+
+static void connection_cb(uv_stream_t* stream, int status) {
+  uv_tcp_t* conn;
+
+  ASSERT(stream == (uv_stream_t*) &server);
+  ASSERT(status == 0);
+  ASSERT(connection_cb_called < CONNECTIONS);
+
+  conn = &server_conns[connection_cb_called++];
+  ASSERT(0 == uv_tcp_init(stream->loop, conn));
+  ASSERT(0 == uv_accept(stream, (uv_stream_t*) conn));
+  ASSERT(0 == uv_read_start((uv_stream_t*) conn, alloc_cb, server_read_cb));
+}
+
+
+static void client_read_cb(uv_stream_t* stream,
+                           ssize_t nread,
+                           const uv_buf_t* buf) {
+  int i;
+
+  i = (uv_tcp_t*) stream - clients;
+  ASSERT(i >= 0 && i < CONNECTIONS);
+
+  if (nread < 0) {
+    ASSERT(nread == UV_EOF);
+    ASSERT(recv_bytes[i] == DATA_SIZE);
+    ASSERT(0 == memcmp(recv_buffers[i], send_buffer, DATA_SIZE));
+    uv_close((uv_handle_t*) stream, close_cb);
+
+    if (i + 1 < CONNECTIONS)
+      start_connect(i + 1);
+    else
+      uv_close((uv_handle_t*) &server, close_cb);
+    return;
+  }
+
+  ASSERT(recv_bytes[i] + nread <= DATA_SIZE);
+  memcpy(recv_buffers[i] + recv_bytes[i], buf->base, nread);
+  recv_bytes[i] += nread;
+}
+
+
+static void shutdown_cb(uv_shutdown_t* req, int status) {
+  ASSERT(status == 0);
+}
+
+
+static void write_cb(uv_write_t* req, int status) {
+  ASSERT(status == 0);
+  write_cb_called++;
+}
+
+
+static void connect_cb(uv_connect_t* req, int status) {
+  ASSERT(status == 0);
+  connect_cb_called++;
+
+  ASSERT(0 == uv_read_start(req->handle, alloc_cb, client_read_cb));
+  ASSERT(0 == uv_shutdown(&shutdown_reqs[req - connect_reqs],
+                          req->handle,
+                          shutdown_cb));
+}
+
+
+static void start_connect(int i) {
+  struct sockaddr_in addr;
+  uv_buf_t buf;
+  int r;
+
+  ASSERT(0 == uv_ip4_addr("127.0.0.1", TEST_PORT, &addr));
+  ASSERT(0 == uv_tcp_init(server.loop, &clients[i]));
+
+  buf = uv_buf_init(send_buffer, DATA_SIZE);
+  r = uv_tcp_connect_fastopen(&connect_reqs[i],
+                              &clients[i],
+                              (const struct sockaddr*) &addr,
+                              &write_reqs[i],
+                              &buf,
+                              1,
+                              connect_cb,
+                              write_cb);
+  ASSERT(r == 0);
+}
+
+
+TEST_IMPL(tcp_fastopen) {
+  struct sockaddr_in addr;
+  uv_loop_t* loop;
+  int i;
+  int r;
+
+  loop = uv_default_loop();
+
+  for (i = 0; i < DATA_SIZE; i++)
+    send_buffer[i] = 'a' + i % 23;
+
+  ASSERT(0 == uv_ip4_addr("127.0.0.1", TEST_PORT, &addr));
+  ASSERT(0 == uv_tcp_init(loop, &server));
+  ASSERT(0 == uv_tcp_bind(&server, (const struct sockaddr*) &addr, 0));
+
+  r = uv_tcp_fastopen(&server, 16);
+  if (r == UV_ENOTSUP) {
+    uv_close((uv_handle_t*) &server, NULL);
+    uv_run(loop, UV_RUN_DEFAULT);
+    RETURN_SKIP("TCP Fast Open not supported on this platform.");
+  }
+  ASSERT(r == 0);
+  ASSERT(UV_EINVAL == uv_tcp_fastopen(&server, -1));
+
+  ASSERT(0 == uv_listen((uv_stream_t*) &server, 16, connection_cb));
+
+  start_connect(0);
+  ASSERT(0 == uv_run(loop, UV_RUN_DEFAULT));
+
+  ASSERT(connection_cb_called == CONNECTIONS);
+  ASSERT(connect_cb_called == CONNECTIONS);
+  ASSERT(write_cb_called == CONNECTIONS);
+  ASSERT(echo_cb_called == CONNECTIONS);
+  ASSERT(close_cb_called == 2 * CONNECTIONS + 1);
+
+  MAKE_VALGRIND_HAPPY();
+  return 0;
+}
@@ -0,0 +1,296 @@
+/* Copyright libuv project contributors. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include "uv.h"
+#include "task.h"
+#include <stdlib.h>
+#include <string.h>
+
+
+#define TOTAL_BYTES (64 * 1024)
+
+static char send_buffer[TOTAL_BYTES];
+static char recv_buffer[TOTAL_BYTES];
+
+static uv_tcp_t client;
+static uv_tcp_t idle;
+static uv_connect_t connect_req;
+static uv_write_t write_req;
+
+static int connect_cb_called = 0;
+static int write_cb_called = 0;
+static int close_cb_called = 0;
+static size_t bytes_received = 0;
+
+
+static void alloc_cb(uv_handle_t* handle, size_t size, uv_buf_t* buf) {
+  buf->base = malloc(size);
+  buf->len = size;
+}
+
+
+static void close_cb(uv_handle_t* handle) {
+  close_cb_called++;
+}
+
+
+static void check_info(void) {
+  uv_tcp_info_t info;
+
+  ASSERT(0 == uv_tcp_get_info(&client, &info));
+  ASSERT(info.mss > 0);
+  ASSERT(info.cwnd >= info.mss);
+  ASSERT(info.bytes_written == TOTAL_BYTES);
+  ASSERT(info.bytes_read == TOTAL_BYTES);
+  ASSERT(info.write_calls >= 1);
+  ASSERT(info.read_calls >= 1);
+
+  /* No socket, no statistics. */
+  ASSERT(UV_EBADF == uv_tcp_get_info(&idle, &info));
+}
+
+
+static void read_cb(uv_stream_t* tcp, ssize_t nread, const uv_buf_t* buf) {
+  ASSERT(nread >= 0);
+  ASSERT(bytes_received + nread <= TOTAL_BYTES);
+  memcpy(recv_buffer + bytes_received, buf->base, nread);
+  bytes_received += nread;
+  free(buf->base);
+
+  if (bytes_received < TOTAL_BYTES)
+    return;
+
+  check_info();
+  uv_close((uv_handle_t*) tcp, close_cb);
+  uv_close((uv_handle_t*) &idle, close_cb);
+}
+
+
+static void write_cb(uv_write_t* req, int status) {
+  ASSERT(req == &write_req);
+  ASSERT(status == 0);
+  write_cb_called++;
+}
+
+
+static void connect_cb(uv_connect_t* req, int status) {
+  uv_tcp_info_t info;
+  uv_buf_t buf;
+
+  ASSERT(req == &connect_req);
+  ASSERT(status == 0);
+  connect_cb_called++;
+
+  ASSERT(0 == uv_tcp_get_info(&client, &info));
+  ASSERT(info.bytes_read == 0);
+  ASSERT(info.bytes_written == 0);
+  ASSERT(info.read_calls == 0);
+  ASSERT(info.write_calls == 0);
+
+  buf = uv_buf_init(send_buffer, TOTAL_BYTES);
+  ASSERT(0 == uv_write(&write_req, (uv_stream_t*) &client, &buf, 1, write_cb));
+  ASSERT(0 == uv_read_start((uv_stream_t*) &client, alloc_cb, read_cb));
+}
+
+
+TEST_IMPL(tcp_get_info) {
+  struct sockaddr_in addr;
+  uv_tcp_info_t info;
+  uv_loop_t* loop;
+  int r;
+  int i;
+
+  loop = uv_default_loop();
+  ASSERT(0 == uv_ip4_addr("127.0.0.1", TEST_PORT, &addr));
+
+  for (i = 0; i < TOTAL_BYTES; i++)
+    send_buffer[i] = 'a' + i % 23;  /* No Q, see echo-server.c. */
+
+  ASSERT(0 == uv_tcp_init(loop, &client));
+  ASSERT(0 == uv_tcp_init(loop, &idle));
+
+  r = uv_tcp_enable_stats(&client);
+  if (r == UV_ENOTSUP) {
+    uv_close((uv_handle_t*) &client, NULL);
+    uv_close((uv_handle_t*) &idle, NULL);
+    uv_run(loop, UV_RUN_DEFAULT);
+    RETURN_SKIP("TCP_INFO not supported on this platform.");
+  }
+  ASSERT(r == 0);
+  ASSERT(UV_EBADF == uv_tcp_get_info(&client, &info));
+
+  ASSERT(0 == uv_tcp_connect(&connect_req,
+                             &client,
+                             (const struct sockaddr*) &addr,
+                             connect_cb));
+
+  ASSERT(0 == uv_run(loop, UV_RUN_DEFAULT));
+
+  ASSERT(connect_cb_called == 1);
+  ASSERT(write_cb_called == 1);
+  ASSERT(close_cb_called == 2);
+  ASSERT(bytes_received == TOTAL_BYTES);
+  ASSERT(0 == memcmp(send_buffer, recv_buffer, TOTAL_BYTES));
+
+  MAKE_VALGRIND_HAPPY();
+  return 0;
+}
+
+
+#ifdef _WIN32
+
+TEST_IMPL(tcp_get_info_pipe_to) {
+  RETURN_SKIP("Test not implemented on Windows.");
+}
+
+#else  /* !_WIN32 */
+
+#include <sys/socket.h>
+
+/* Data goes in at `in`, is spliced from `out` to the client and comes back
+ * from the echo server.
+ */
+static uv_pipe_t in;
+static uv_pipe_t out;
+static uv_stream_pipe_t pipe_req;
+static uv_shutdown_t shutdown_req;
+
+static int pipe_cb_called = 0;
+static int eof_cb_called = 0;
+
+
+static void pipe_to_read_cb(uv_stream_t* tcp,
+                            ssize_t nread,
+                            const uv_buf_t* buf) {
+  uv_tcp_info_t info;
+
+  if (nread > 0) {
+    ASSERT(bytes_received + nread <= TOTAL_BYTES);
+    memcpy(recv_buffer + bytes_received, buf->base, nread);
+    bytes_received += nread;
+  }
+  free(buf->base);
+
+  if (nread >= 0)
+    return;
+
+  ASSERT(nread == UV_EOF);
+  eof_cb_called++;
+
+  /* The spliced data counts as written, the echo as read. */
+  ASSERT(0 == uv_tcp_get_info(&client, &info));
+  ASSERT(info.bytes_written == TOTAL_BYTES);
+  ASSERT(info.bytes_read == TOTAL_BYTES);
+  ASSERT(info.write_calls >= 1);
+  ASSERT(info.read_calls >= 2);  /* Data and EOF. */
+
+  uv_close((uv_handle_t*) tcp, close_cb);
+}
+
+
+static void pipe_to_shutdown_cb(uv_shutdown_t* req, int status) {
+  ASSERT(req == &shutdown_req);
+  ASSERT(status == 0);
+  uv_close((uv_handle_t*) &in, close_cb);
+}
+
+
+static void pipe_to_pipe_cb(uv_stream_pipe_t* req, int status) {
+  ASSERT(req == &pipe_req);
+  ASSERT(status == 0);
+  ASSERT(req->nbytes == TOTAL_BYTES);
+  pipe_cb_called++;
+  uv_close((uv_handle_t*) &out, close_cb);
+}
+
+
+static void pipe_to_connect_cb(uv_connect_t* req, int status) {
+  uv_buf_t buf;
+  int fds[2];
+
+  ASSERT(req == &connect_req);
+  ASSERT(status == 0);
+  connect_cb_called++;
+
+  ASSERT(0 == socketpair(AF_UNIX, SOCK_STREAM, 0, fds));
+  ASSERT(0 == uv_pipe_init(req->handle->loop, &in, 0));
+  ASSERT(0 == uv_pipe_init(req->handle->loop, &out, 0));
+  ASSERT(0 == uv_pipe_open(&in, fds[0]));
+  ASSERT(0 == uv_pipe_open(&out, fds[1]));
+
+  ASSERT(0 == uv_stream_pipe_to(&pipe_req,
+                                (uv_stream_t*) &out,
+                                (uv_stream_t*) &client,
+                                pipe_to_pipe_cb));
+
+  buf = uv_buf_init(send_buffer, TOTAL_BYTES);
+  ASSERT(0 == uv_write(&write_req, (uv_stream_t*) &in, &buf, 1, write_cb));
+  ASSERT(0 == uv_shutdown(&shutdown_req,
+                          (uv_stream_t*) &in,
+                          pipe_to_shutdown_cb));
+  ASSERT(0 == uv_read_start((uv_stream_t*) &client,
+                            alloc_cb,
+                            pipe_to_read_cb));
+}
+
+
+TEST_IMPL(tcp_get_info_pipe_to) {
+  struct sockaddr_in addr;
+  uv_loop_t* loop;
+  int r;
+  int i;
+
+  loop = uv_default_loop();
+  ASSERT(0 == uv_ip4_addr("127.0.0.1", TEST_PORT, &addr));
+
+  for (i = 0; i < TOTAL_BYTES; i++)
+    send_buffer[i] = 'a' + i % 23;  /* No Q, see echo-server.c. */
+
+  ASSERT(0 == uv_tcp_init(loop, &client));
+
+  r = uv_tcp_enable_stats(&client);
+  if (r == UV_ENOTSUP) {
+    uv_close((uv_handle_t*) &client, NULL);
+    uv_run(loop, UV_RUN_DEFAULT);
+    RETURN_SKIP("TCP_INFO not supported on this platform.");
+  }
+  ASSERT(r == 0);
+
+  ASSERT(0 == uv_tcp_connect(&connect_req,
+                             &client,
+                             (const struct sockaddr*) &addr,
+                             pipe_to_connect_cb));
+
+  ASSERT(0 == uv_run(loop, UV_RUN_DEFAULT));
+
+  ASSERT(connect_cb_called == 1);
+  ASSERT(write_cb_called == 1);
+  ASSERT(pipe_cb_called == 1);
+  ASSERT(eof_cb_called == 1);
+  ASSERT(close_cb_called == 3);
+  ASSERT(bytes_received == TOTAL_BYTES);
+  ASSERT(0 == memcmp(send_buffer, recv_buffer, TOTAL_BYTES));
+
+  MAKE_VALGRIND_HAPPY();
+  return 0;
+}
+
+#endif  /* !_WIN32 */
@@ -0,0 +1,131 @@
+/* Copyright libuv project contributors. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#ifndef _WIN32
+
+#include "uv.h"
+#include "task.h"
+#include <stdlib.h>
+#include <string.h>
+
+
+#define TOTAL_BYTES (256 * 1024)
+
+static char* send_buffer;
+static char* recv_buffer;
+static char* pool_base;
+
+static int read_cb_called = 0;
+static int write_cb_called = 0;
+static int close_cb_called = 0;
+static size_t bytes_received = 0;
+
+static uv_tcp_t client;
+static uv_connect_t connect_req;
+static uv_shutdown_t shutdown_req;
+static uv_write_t write_req;
+
+
+static void close_cb(uv_handle_t* handle) {
+  close_cb_called++;
+}
+
+
+static void read_cb(uv_stream_t* tcp, ssize_t nread, const uv_buf_t* buf) {
+  ASSERT(tcp == (uv_stream_t*) &client);
+  read_cb_called++;
+
+  if (nread >= 0) {
+    /* Every read lands in the same loop-owned buffer. */
+    ASSERT(buf->base != NULL);
+    if (pool_base == NULL)
+      pool_base = buf->base;
+    ASSERT(buf->base == pool_base);
+
+    ASSERT(bytes_received + nread <= TOTAL_BYTES);
+    memcpy(recv_buffer + bytes_received, buf->base, nread);
+    bytes_received += nread;
+  } else {
+    ASSERT(nread == UV_EOF);
+    uv_close((uv_handle_t*) tcp, close_cb);
+  }
+}
+
+
+static void write_cb(uv_write_t* req, int status) {
+  ASSERT(status == 0);
+  write_cb_called++;
+}
+
+
+static void connect_cb(uv_connect_t* req, int status) {
+  uv_buf_t buf;
+
+  ASSERT(req == &connect_req);
+  ASSERT(status == 0);
+
+  buf = uv_buf_init(send_buffer, TOTAL_BYTES);
+  ASSERT(0 == uv_write(&write_req, req->handle, &buf, 1, write_cb));
+  ASSERT(0 == uv_shutdown(&shutdown_req, req->handle, NULL));
+  ASSERT(0 == uv_read_start_pooled(req->handle, read_cb));
+}
+
+
+TEST_IMPL(tcp_read_pooled) {
+  struct sockaddr_in addr;
+  int i;
+
+  ASSERT(0 == uv_ip4_addr("127.0.0.1", TEST_PORT, &addr));
+
+  send_buffer = malloc(TOTAL_BYTES);
+  recv_buffer = malloc(TOTAL_BYTES);
+  ASSERT(send_buffer != NULL);
+  ASSERT(recv_buffer != NULL);
+
+  for (i = 0; i < TOTAL_BYTES; i++)
+    send_buffer[i] = 'a' + i % 23;  /* No Q, see echo-server.c. */
+
+  ASSERT(0 == uv_tcp_init(uv_default_loop(), &client));
+  ASSERT(0 == uv_tcp_connect(&connect_req,
+                             &client,
+                             (const struct sockaddr*) &addr,
+                             connect_cb));
+
+  ASSERT(0 == uv_run(uv_default_loop(), UV_RUN_DEFAULT));
+
+  ASSERT(write_cb_called == 1);
+  ASSERT(close_cb_called == 1);
+  ASSERT(read_cb_called > 1);
+  ASSERT(bytes_received == TOTAL_BYTES);
+  ASSERT(0 == memcmp(send_buffer, recv_buffer, TOTAL_BYTES));
+
+  free(send_buffer);
+  free(recv_buffer);
+
+  MAKE_VALGRIND_HAPPY();
+  return 0;
+}
+
+#else
+
+typedef int file_has_no_tests; /* ISO C forbids an empty translation unit. */
+
+#endif /* !_WIN32 */
@@ -0,0 +1,206 @@
+/* Copyright libuv project contributors. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include "uv.h"
+#include "task.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+#define WRITES      4
+#define WRITE_SIZE  (1024 * 1024)
+#define SMALL_SIZE  100  /* Below the zero-copy threshold. */
+
+#define TOTAL_BYTES (WRITES * WRITE_SIZE + SMALL_SIZE)
+
+static char* send_buffer;
+static char* recv_buffer;
+
+static int shutdown_cb_called = 0;
+static int connect_cb_called = 0;
+static int write_cb_called = 0;
+static int close_cb_called = 0;
+static size_t bytes_received = 0;
+
+static uv_connect_t connect_req;
+static uv_shutdown_t shutdown_req;
+static uv_write_t write_reqs[WRITES + 1];
+
+
+static void alloc_cb(uv_handle_t* handle, size_t size, uv_buf_t* buf) {
+  buf->base = malloc(size);
+  buf->len = size;
+}
+
+
+static void close_cb(uv_handle_t* handle) {
+  close_cb_called++;
+}
+
+
+static void shutdown_cb(uv_shutdown_t* req, int status) {
+  ASSERT(req == &shutdown_req);
+  ASSERT(status == 0);
+  shutdown_cb_called++;
+}
+
+
+static void read_cb(uv_stream_t* tcp, ssize_t nread, const uv_buf_t* buf) {
+  if (nread >= 0) {
+    ASSERT(bytes_received + nread <= TOTAL_BYTES);
+    memcpy(recv_buffer + bytes_received, buf->base, nread);
+    bytes_received += nread;
+  } else {
+    ASSERT(nread == UV_EOF);
+    uv_close((uv_handle_t*) tcp, close_cb);
+  }
+
+  free(buf->base);
+}
+
+
+static void write_cb(uv_write_t* req, int status) {
+  ASSERT(status == 0);
+  write_cb_called++;
+}
+
+
+static void connect_cb(uv_connect_t* req, int status) {
+  uv_stream_t* stream;
+  uv_buf_t buf;
+  int i;
+
+  ASSERT(req == &connect_req);
+  ASSERT(status == 0);
+
+  stream = req->handle;
+  connect_cb_called++;
+
+  for (i = 0; i < WRITES; i++) {
+    buf = uv_buf_init(send_buffer + i * WRITE_SIZE, WRITE_SIZE);
+    ASSERT(0 == uv_write_zerocopy(write_reqs + i, stream, &buf, 1, write_cb));
+  }
+
+  buf = uv_buf_init(send_buffer + WRITES * WRITE_SIZE, SMALL_SIZE);
+  ASSERT(0 == uv_write_zerocopy(write_reqs + WRITES, stream, &buf, 1, write_cb));
+
+  ASSERT(0 == uv_shutdown(&shutdown_req, stream, shutdown_cb));
+  ASSERT(0 == uv_read_start(stream, alloc_cb, read_cb));
+}
+
+
+TEST_IMPL(tcp_write_zerocopy) {
+  struct sockaddr_in addr;
+  uv_tcp_t client;
+  int i;
+
+  ASSERT(0 == uv_ip4_addr("127.0.0.1", TEST_PORT, &addr));
+
+  send_buffer = malloc(TOTAL_BYTES);
+  recv_buffer = malloc(TOTAL_BYTES);
+  ASSERT(send_buffer != NULL);
+  ASSERT(recv_buffer != NULL);
+
+  for (i = 0; i < TOTAL_BYTES; i++)
+    send_buffer[i] = 'a' + i % 23;  /* No Q, see echo-server.c. */
+
+  ASSERT(0 == uv_tcp_init(uv_default_loop(), &client));
+  ASSERT(0 == uv_tcp_connect(&connect_req,
+                             &client,
+                             (const struct sockaddr*) &addr,
+                             connect_cb));
+
+  ASSERT(0 == uv_run(uv_default_loop(), UV_RUN_DEFAULT));
+
+  ASSERT(connect_cb_called == 1);
+  ASSERT(write_cb_called == WRITES + 1);
+  ASSERT(shutdown_cb_called == 1);
+  ASSERT(close_cb_called == 1);
+  ASSERT(bytes_received == TOTAL_BYTES);
+  ASSERT(0 == memcmp(send_buffer, recv_buffer, TOTAL_BYTES));
+
+  free(send_buffer);
+  free(recv_buffer);
+
+  MAKE_VALGRIND_HAPPY();
+  return 0;
+}
+
+
+static void write_cancel_cb(uv_write_t* req, int status) {
+  /* The kernel can still be sending from the buffer, don't report it as
+   * done.
+   */
+#if defined(__linux__)
+  ASSERT(status == UV_ECANCELED);
+#else
+  ASSERT(status == 0);
+#endif
+  write_cb_called++;
+}
+
+
+static void connect_close_cb(uv_connect_t* req, int status) {
+  uv_stream_t* stream;
+  uv_buf_t buf;
+
+  ASSERT(req == &connect_req);
+  ASSERT(status == 0);
+
+  stream = req->handle;
+  connect_cb_called++;
+
+  /* Fits in the socket buffer, it's written right away. */
+  buf = uv_buf_init(send_buffer, 64 * 1024);
+  ASSERT(0 == uv_write_zerocopy(write_reqs, stream, &buf, 1, write_cancel_cb));
+  ASSERT(0 == uv_stream_get_write_queue_size(stream));
+  uv_close((uv_handle_t*) stream, close_cb);
+}
+
+
+TEST_IMPL(tcp_write_zerocopy_close) {
+  struct sockaddr_in addr;
+  uv_tcp_t client;
+
+  ASSERT(0 == uv_ip4_addr("127.0.0.1", TEST_PORT, &addr));
+
+  send_buffer = malloc(64 * 1024);
+  ASSERT(send_buffer != NULL);
+  memset(send_buffer, 'a', 64 * 1024);
+
+  ASSERT(0 == uv_tcp_init(uv_default_loop(), &client));
+  ASSERT(0 == uv_tcp_connect(&connect_req,
+                             &client,
+                             (const struct sockaddr*) &addr,
+                             connect_close_cb));
+
+  ASSERT(0 == uv_run(uv_default_loop(), UV_RUN_DEFAULT));
+
+  ASSERT(connect_cb_called == 1);
+  ASSERT(write_cb_called == 1);
+  ASSERT(close_cb_called == 1);
+
+  free(send_buffer);
+
+  MAKE_VALGRIND_HAPPY();
+  return 0;
+}
@@ -0,0 +1,195 @@
+/* Copyright libuv project contributors. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include "uv.h"
+#include "task.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define CHECK_HANDLE(handle) \
+  ASSERT((uv_udp_t*)(handle) == &recver || (uv_udp_t*)(handle) == &sender)
+
+#define SEGMENT_SIZE 1000
+#define NUM_SEGMENTS 4
+#define TOTAL_SIZE (SEGMENT_SIZE * NUM_SEGMENTS - 100)
+
+static uv_udp_t recver;
+static uv_udp_t sender;
+static uv_udp_send_t send_req;
+static char payload[TOTAL_SIZE];
+static size_t bytes_received;
+static int datagrams_received;
+static int gro_received;
+static int send_cb_called;
+static int close_cb_called;
+
+
+static void alloc_cb(uv_handle_t* handle,
+                     size_t suggested_size,
+                     uv_buf_t* buf) {
+  static char slab[65536];
+  CHECK_HANDLE(handle);
+  buf->base = slab;
+  buf->len = sizeof(slab);
+}
+
+
+static void close_cb(uv_handle_t* handle) {
+  CHECK_HANDLE(handle);
+  close_cb_called++;
+}
+
+
+static void send_cb(uv_udp_send_t* req, int status) {
+  ASSERT(req == &send_req);
+  ASSERT(status == 0);
+  send_cb_called++;
+}
+
+
+static void recv_cb(uv_udp_t* handle,
+                    ssize_t nread,
+                    const uv_buf_t* rcvbuf,
+                    const struct sockaddr* addr,
+                    unsigned flags) {
+  ASSERT(nread >= 0);
+
+  if (nread == 0)
+    return;
+
+  ASSERT(addr != NULL);
+  ASSERT(memcmp(rcvbuf->base, payload + bytes_received, nread) == 0);
+
+  if (flags & UV_UDP_GRO) {
+    ASSERT((flags >> 16) == SEGMENT_SIZE);
+    gro_received++;
+  } else {
+    /* Every segment is a datagram of its own. */
+    ASSERT(nread == SEGMENT_SIZE ||
+           nread == TOTAL_SIZE - (NUM_SEGMENTS - 1) * SEGMENT_SIZE);
+  }
+
+  bytes_received += nread;
+  datagrams_received++;
+
+  if (bytes_received == TOTAL_SIZE) {
+    uv_close((uv_handle_t*) handle, close_cb);
+    uv_close((uv_handle_t*) &sender, close_cb);
+  }
+}
+
+
+static void send_segments(void) {
+  struct sockaddr_in addr;
+  uv_buf_t bufs[3];
+  size_t i;
+
+  for (i = 0; i < sizeof(payload); i++)
+    payload[i] = (char) (i * 7);
+
+  /* Segments don't line up with the buffers. */
+  bufs[0] = uv_buf_init(payload, 1500);
+  bufs[1] = uv_buf_init(payload + 1500, 100);
+  bufs[2] = uv_buf_init(payload + 1600, TOTAL_SIZE - 1600);
+
+  ASSERT(0 == uv_ip4_addr("127.0.0.1", TEST_PORT, &addr));
+  ASSERT(0 == uv_udp_init(uv_default_loop(), &sender));
+  ASSERT(UV_EINVAL == uv_udp_send_gso(&send_req,
+                                      &sender,
+                                      bufs,
+                                      ARRAY_SIZE(bufs),
+                                      (const struct sockaddr*) &addr,
+                                      0,
+                                      send_cb));
+  ASSERT(0 == uv_udp_send_gso(&send_req,
+                              &sender,
+                              bufs,
+                              ARRAY_SIZE(bufs),
+                              (const struct sockaddr*) &addr,
+                              SEGMENT_SIZE,
+                              send_cb));
+}
+
+
+TEST_IMPL(udp_send_gso) {
+  struct sockaddr_in addr;
+
+#ifdef _WIN32
+  RETURN_SKIP("UDP segmentation offload is not supported on Windows.");
+#endif
+
+  ASSERT(0 == uv_ip4_addr("0.0.0.0", TEST_PORT, &addr));
+  ASSERT(0 == uv_udp_init(uv_default_loop(), &recver));
+  ASSERT(0 == uv_udp_bind(&recver, (const struct sockaddr*) &addr, 0));
+  ASSERT(0 == uv_udp_recv_start(&recver, alloc_cb, recv_cb));
+
+  send_segments();
+
+  ASSERT(0 == uv_run(uv_default_loop(), UV_RUN_DEFAULT));
+
+  ASSERT(send_cb_called == 1);
+  ASSERT(close_cb_called == 2);
+  ASSERT(bytes_received == TOTAL_SIZE);
+  ASSERT(datagrams_received == NUM_SEGMENTS);
+  ASSERT(gro_received == 0);
+
+  MAKE_VALGRIND_HAPPY();
+  return 0;
+}
+
+
+TEST_IMPL(udp_recv_gro) {
+  struct sockaddr_in addr;
+  int r;
+
+#ifdef _WIN32
+  RETURN_SKIP("UDP receive offload is not supported on Windows.");
+#endif
+
+  ASSERT(0 == uv_ip4_addr("0.0.0.0", TEST_PORT, &addr));
+  ASSERT(0 == uv_udp_init(uv_default_loop(), &recver));
+  ASSERT(0 == uv_udp_bind(&recver, (const struct sockaddr*) &addr, 0));
+
+  r = uv_udp_set_gro(&recver, 1);
+  if (r == UV_ENOTSUP || r == UV_ENOPROTOOPT) {
+    uv_close((uv_handle_t*) &recver, NULL);
+    uv_run(uv_default_loop(), UV_RUN_DEFAULT);
+    RETURN_SKIP("UDP_GRO is not supported.");
+  }
+  ASSERT(r == 0);
+
+  ASSERT(0 == uv_udp_recv_start(&recver, alloc_cb, recv_cb));
+
+  send_segments();
+
+  ASSERT(0 == uv_run(uv_default_loop(), UV_RUN_DEFAULT));
+
+  /* Whether the segments arrive coalesced depends on the kernel. */
+  ASSERT(send_cb_called == 1);
+  ASSERT(close_cb_called == 2);
+  ASSERT(bytes_received == TOTAL_SIZE);
+  ASSERT(datagrams_received == NUM_SEGMENTS || gro_received > 0);
+
+  MAKE_VALGRIND_HAPPY();
+  return 0;
+}
@@ -0,0 +1,241 @@
+/* Copyright libuv project contributors. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include "uv.h"
+#include "task.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define CHECK_HANDLE(handle) \
+  ASSERT((uv_udp_t*)(handle) == &server || (uv_udp_t*)(handle) == &client)
+
+static uv_udp_t server;
+static uv_udp_t client;
+static uv_udp_send_t send_req;
+static uv_udp_send_t reply_req;
+static struct sockaddr_storage server_addr;
+static int sv_recv_cb_called;
+static int cl_recv_cb_called;
+static int send_cb_called;
+static int close_cb_called;
+
+
+static void alloc_cb(uv_handle_t* handle,
+                     size_t suggested_size,
+                     uv_buf_t* buf) {
+  static char slab[65536];
+  CHECK_HANDLE(handle);
+  buf->base = slab;
+  buf->len = sizeof(slab);
+}
+
+
+static void close_cb(uv_handle_t* handle) {
+  CHECK_HANDLE(handle);
+  close_cb_called++;
+}
+
+
+static void send_cb(uv_udp_send_t* req, int status) {
+  ASSERT(req == &send_req || req == &reply_req);
+  ASSERT(status == 0);
+  send_cb_called++;
+}
+
+
+static void cl_recv_cb(uv_udp_t* handle,
+                       ssize_t nread,
+                       const uv_buf_t* buf,
+                       const struct sockaddr* addr,
+                       unsigned flags) {
+  if (nread == 0)
+    return;
+
+  ASSERT(nread == 4);
+  ASSERT(memcmp(buf->base, "PONG", 4) == 0);
+
+  /* The reply came from the address the request was sent to. */
+  ASSERT(addr != NULL);
+  ASSERT(addr->sa_family == server_addr.ss_family);
+  if (addr->sa_family == AF_INET)
+    ASSERT(0 == memcmp(&((const struct sockaddr_in*) addr)->sin_addr,
+                       &((struct sockaddr_in*) &server_addr)->sin_addr,
+                       sizeof(struct in_addr)));
+  else
+    ASSERT(0 == memcmp(&((const struct sockaddr_in6*) addr)->sin6_addr,
+                       &((struct sockaddr_in6*) &server_addr)->sin6_addr,
+                       sizeof(struct in6_addr)));
+
+  cl_recv_cb_called++;
+  uv_close((uv_handle_t*) &server, close_cb);
+  uv_close((uv_handle_t*) &client, close_cb);
+}
+
+
+static void sv_recv_cb(uv_udp_t* handle,
+                       ssize_t nread,
+                       const uv_buf_t* buf,
+                       const uv_udp_recv_info_t* info,
+                       unsigned flags) {
+  const struct sockaddr* local;
+  uv_buf_t reply;
+  double now;
+  double when;
+  int r;
+
+  ASSERT(info != NULL);
+
+  if (nread == 0) {
+    ASSERT(info->addr == NULL);
+    return;
+  }
+
+  ASSERT(nread == 4);
+  ASSERT(memcmp(buf->base, "PING", 4) == 0);
+  ASSERT(info->addr != NULL);
+
+  /* Kernel timestamps use the wall clock. */
+  ASSERT(info->timestamp != 0);
+  now = (double) time(NULL);
+  when = info->timestamp / 1e9;
+  ASSERT(when > now - 10 && when < now + 10);
+
+  local = info->local_addr;
+  ASSERT(local != NULL);
+  ASSERT(info->ifindex != 0);
+  ASSERT(local->sa_family == server_addr.ss_family);
+  if (local->sa_family == AF_INET)
+    ASSERT(0 == memcmp(&((const struct sockaddr_in*) local)->sin_addr,
+                       &((struct sockaddr_in*) &server_addr)->sin_addr,
+                       sizeof(struct in_addr)));
+  else
+    ASSERT(0 == memcmp(&((const struct sockaddr_in6*) local)->sin6_addr,
+                       &((struct sockaddr_in6*) &server_addr)->sin6_addr,
+                       sizeof(struct in6_addr)));
+
+  /* Answer from the address the datagram was sent to. */
+  reply = uv_buf_init("PONG", 4);
+  r = uv_udp_send_from(&reply_req,
+                       handle,
+                       &reply,
+                       1,
+                       info->addr,
+                       local,
+                       info->ifindex,
+                       send_cb);
+  ASSERT(r == 0);
+
+  sv_recv_cb_called++;
+}
+
+
+static int run_test(const char* any, const char* loopback, int family) {
+  struct sockaddr_storage bind_addr;
+  struct sockaddr_in mismatch;
+  uv_buf_t buf;
+  int r;
+
+  if (family == AF_INET) {
+    ASSERT(0 == uv_ip4_addr(any, TEST_PORT, (struct sockaddr_in*) &bind_addr));
+    ASSERT(0 == uv_ip4_addr(loopback,
+                            TEST_PORT,
+                            (struct sockaddr_in*) &server_addr));
+  } else {
+    ASSERT(0 == uv_ip6_addr(any,
+                            TEST_PORT,
+                            (struct sockaddr_in6*) &bind_addr));
+    ASSERT(0 == uv_ip6_addr(loopback,
+                            TEST_PORT,
+                            (struct sockaddr_in6*) &server_addr));
+  }
+
+  ASSERT(0 == uv_udp_init(uv_default_loop(), &server));
+  ASSERT(0 == uv_udp_bind(&server, (const struct sockaddr*) &bind_addr, 0));
+
+  r = uv_udp_recv_start_ex(&server, alloc_cb, sv_recv_cb, ~0u);
+  ASSERT(r == UV_EINVAL);
+
+  r = uv_udp_recv_start_ex(&server,
+                           alloc_cb,
+                           sv_recv_cb,
+                           UV_UDP_RECV_TIMESTAMP | UV_UDP_RECV_PKTINFO);
+  if (r == UV_ENOTSUP) {
+    uv_close((uv_handle_t*) &server, NULL);
+    uv_run(uv_default_loop(), UV_RUN_DEFAULT);
+    MAKE_VALGRIND_HAPPY();
+    RETURN_SKIP("Receive metadata is not supported on this platform.");
+  }
+  ASSERT(r == 0);
+
+  ASSERT(0 == uv_udp_init(uv_default_loop(), &client));
+
+  /* The source address has to match the family of the destination. */
+  buf = uv_buf_init("PING", 4);
+  ASSERT(0 == uv_ip4_addr("127.0.0.1", TEST_PORT, &mismatch));
+  if (family == AF_INET6) {
+    r = uv_udp_send_from(&send_req,
+                         &client,
+                         &buf,
+                         1,
+                         (const struct sockaddr*) &server_addr,
+                         (const struct sockaddr*) &mismatch,
+                         0,
+                         send_cb);
+    ASSERT(r == UV_EINVAL);
+  }
+
+  r = uv_udp_send(&send_req,
+                  &client,
+                  &buf,
+                  1,
+                  (const struct sockaddr*) &server_addr,
+                  send_cb);
+  ASSERT(r == 0);
+
+  /* Sending bound the client to the right family. */
+  ASSERT(0 == uv_udp_recv_start(&client, alloc_cb, cl_recv_cb));
+
+  ASSERT(0 == uv_run(uv_default_loop(), UV_RUN_DEFAULT));
+
+  ASSERT(sv_recv_cb_called == 1);
+  ASSERT(cl_recv_cb_called == 1);
+  ASSERT(send_cb_called == 2);
+  ASSERT(close_cb_called == 2);
+
+  MAKE_VALGRIND_HAPPY();
+  return 0;
+}
+
+
+TEST_IMPL(udp_recv_info) {
+  return run_test("0.0.0.0", "127.0.0.1", AF_INET);
+}
+
+
+TEST_IMPL(udp_recv_info6) {
+  if (!can_ipv6())
+    RETURN_SKIP("IPv6 not supported");
+
+  return run_test("::", "::1", AF_INET6);
+}
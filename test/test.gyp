@@ -97,9 +97,15 @@
         'test-signal-multiple-loops.c',
         'test-socket-buffer-size.c',
         'test-spawn.c',
+        'test-stream-pipe-to.c',
+        'test-stream-sendfile.c',
+        'test-stream-write-gather.c',
+        'test-stream-write-queue-limits.c',
         'test-strscpy.c',
         'test-stdio-over-pipes.c',
+        'test-tcp-accept-batch.c',
         'test-tcp-alloc-cb-fail.c',
+        'test-tcp-batch-writes.c',
         'test-tcp-bind-error.c',
         'test-tcp-bind6-error.c',
         'test-tcp-close.c',
@@ -108,7 +114,9 @@
         'test-tcp-create-socket-early.c',
         'test-tcp-connect-error-after-write.c',
         'test-tcp-shutdown-after-write.c',
+        'test-tcp-fastopen.c',
         'test-tcp-flags.c',
+        'test-tcp-get-info.c',
         'test-tcp-connect-error.c',
         'test-tcp-connect-timeout.c',
         'test-tcp-connect6-error.c',
@@ -120,8 +128,10 @@
         'test-tcp-try-write.c',
         'test-tcp-unexpected-read.c',
         'test-tcp-oob.c',
+        'test-tcp-read-pooled.c',
         'test-tcp-read-stop.c',
         'test-tcp-write-queue-order.c',
+        'test-tcp-write-zerocopy.c',
         'test-threadpool.c',
         'test-threadpool-cancel.c',
         'test-thread-equal.c',
@@ -137,11 +147,15 @@
         'test-tty.c',
         'test-udp-alloc-cb-fail.c',
         'test-udp-bind.c',
+        'test-udp-connect.c',
         'test-udp-create-socket-early.c',
         'test-udp-dgram-too-big.c',
         'test-udp-ipv6.c',
         'test-udp-open.c',
+        'test-udp-mmsg.c',
+        'test-udp-gso.c',
         'test-udp-options.c',
+        'test-udp-recv-info.c',
         'test-udp-send-and-recv.c',
         'test-udp-send-hang-loop.c',
         'test-udp-send-immediate.c',
@@ -224,6 +238,7 @@
       'sources': [
         'benchmark-async.c',
         'benchmark-async-pummel.c',
+        'benchmark-fs-read.c',
         'benchmark-fs-stat.c',
         'benchmark-getaddrinfo.c',
         'benchmark-list.h',
@@ -237,6 +252,8 @@
         'benchmark-sizes.c',
         'benchmark-spawn.c',
         'benchmark-thread.c',
+        'benchmark-tcp-accept.c',
+        'benchmark-tcp-proxy.c',
         'benchmark-tcp-write-batch.c',
         'benchmark-udp-pummel.c',
         'dns-server.c',